@@ -8,26 +8,11 @@
 #include <span>       // For std::span
 
 #include "symusic/score.h" // For symusic::Score
-#include "symusic/io/midi.h" // For symusic::io::parse_midi
+#include "symusic/io/corpus.h" // For symusic::CorpusReader
 // #include "CLI/CLI.hpp"   // For command line argument parsing // REMOVED
 
 namespace fs = std::filesystem;
 
-// Function to read entire file into a vector of char (or uint8_t)
-std::vector<uint8_t> read_file_to_bytes(const fs::path& path) {
-    std::ifstream file(path, std::ios::binary | std::ios::ate);
-    if (!file.is_open()) {
-        throw std::runtime_error("Failed to open file: " + path.string());
-    }
-    std::streamsize size = file.tellg();
-    file.seekg(0, std::ios::beg);
-    std::vector<uint8_t> buffer(static_cast<size_t>(size));
-    if (!file.read(reinterpret_cast<char*>(buffer.data()), size)) {
-        throw std::runtime_error("Failed to read file: " + path.string());
-    }
-    return buffer;
-}
-
 // Function to count notes in a score
 size_t count_notes(const symusic::Score<symusic::Tick>& score) {
     size_t note_count = 0;
@@ -159,9 +144,17 @@ int main(int argc, char** argv) {
 
     csv_file << "AbsolutePath,RelativePath,FileName,NoteCount\n";
 
+    // Files are read ahead on an I/O thread and parsed on every hardware thread, while this loop
+    // receives the scores in scan order.
+    symusic::CorpusOptions corpus_options;
+    corpus_options.parse.sanitize_data = true;
+    corpus_options.parse.num_threads   = 0;
+    symusic::CorpusReader<symusic::Tick> reader(midi_files, corpus_options);
+
     size_t processed_count = 0;
-    for (const auto& midi_path : midi_files) {
+    while (auto item = reader.next()) {
         processed_count++;
+        const fs::path& midi_path = item->path;
         std::string absolute_path_str = fs::absolute(midi_path).string();
         std::string relative_path_str;
         std::string filename_str = midi_path.filename().string();
@@ -185,29 +178,16 @@ int main(int argc, char** argv) {
 
         print_progress(processed_count, midi_files.size(), filename_str);
 
-        try {
-            // Read file into a byte vector
-            std::vector<uint8_t> file_bytes = read_file_to_bytes(midi_path);
-            std::span<const uint8_t> data_span(file_bytes.data(), file_bytes.size());
-
-            // Use the generic parse function
-            // Assuming DataFormat is symusic::DataFormat or symusic::io::DataFormat
-            // Assuming parse is symusic::parse or symusic::io::parse
-            const symusic::Score<symusic::Tick> score =
-                symusic::parse<symusic::DataFormat::MIDI, symusic::Score<symusic::Tick>>(
-                    data_span,
-                    true // sanitize_data
-                );
-
-            size_t notes = count_notes(score);
+        if (item->result.ok()) {
+            size_t notes = count_notes(*item->result.value);
             csv_file << "\"" << absolute_path_str << "\",\""
                      << relative_path_str << "\",\""
                      << filename_str << "\","
                      << notes << "\n";
-        } catch (const std::exception& e) {
+        } else {
             // Ensure progress bar is not overwritten by error message
             std::cout << std::endl; // Move to next line before printing error
-            std::cerr << "Error processing file " << absolute_path_str << ": " << e.what() << std::endl;
+            std::cerr << "Error processing file " << absolute_path_str << ": " << item->result.error << std::endl;
             csv_file << "\"" << absolute_path_str << "\",\""
                      << relative_path_str << "\",\""
                      << filename_str << "\","
@@ -14,9 +14,21 @@
 #include "symusic/conversion.h"
 #include "symusic/pianoroll.h"
 #include "symusic/soa.h"
+#include "symusic/fingerprint.h"
 
 #include "symusic/io/common.h"
 #include "symusic/io/midi.h"
+#include "symusic/io/batch.h"
+#include "symusic/io/midi_info.h"
+#include "symusic/io/lazy.h"
+#include "symusic/io/midi_parser.h"
+#include "symusic/io/midi_stream.h"
+#include "symusic/io/try_parse.h"
+#include "symusic/io/corpus.h"
+#include "symusic/io/archive.h"
+#include "symusic/io/score_map.h"
+#include "symusic/io/shard.h"
+#include "symusic/io/midi_writer.h"
 #include "symusic/synth.h"
 
 #endif //LIBSYMUSIC_SYMUSIC_H
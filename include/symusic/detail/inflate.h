@@ -0,0 +1,42 @@
+#pragma once
+
+#ifndef LIBSYMUSIC_DETAIL_INFLATE_H
+#define LIBSYMUSIC_DETAIL_INFLATE_H
+
+#include <functional>
+#include <span>
+
+#include "symusic/mtype.h"
+
+namespace symusic::details {
+
+/// Receives decoded bytes in order; a span is only valid during the call.
+using ByteSink = std::function<void(std::span<const u8>)>;
+
+/// CRC-32 as used by gzip and zip, continuing from the CRC ``crc`` of the preceding bytes.
+[[nodiscard]] u32 crc32(std::span<const u8> bytes, u32 crc = 0);
+
+/**
+ * Decode the raw DEFLATE stream (RFC 1951) at the front of ``input``, handing the output to
+ * ``sink`` in pieces as it is produced, so arbitrarily large streams decode with bounded memory.
+ * Returns the number of input bytes the stream occupied. Throws ``std::runtime_error`` if the
+ * stream is malformed or truncated.
+ */
+size_t inflate(std::span<const u8> input, const ByteSink& sink);
+
+/**
+ * Decode a whole raw DEFLATE stream into memory. Throws ``std::runtime_error`` as soon as the
+ * output grows past ``max_size`` bytes, so a crafted stream cannot exhaust memory.
+ */
+[[nodiscard]] vec<u8> inflate(std::span<const u8> input, size_t max_size);
+
+/**
+ * Decode a gzip file (RFC 1952) into ``sink``, including files made of several concatenated gzip
+ * members. The CRC and length of every member are checked. Throws ``std::runtime_error`` on a
+ * malformed, truncated or corrupted file.
+ */
+void gunzip(std::span<const u8> input, const ByteSink& sink);
+
+}   // namespace symusic::details
+
+#endif   // LIBSYMUSIC_DETAIL_INFLATE_H
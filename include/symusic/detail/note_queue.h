@@ -0,0 +1,107 @@
+#pragma once
+
+#ifndef LIBSYMUSIC_DETAIL_NOTE_QUEUE_H
+#define LIBSYMUSIC_DETAIL_NOTE_QUEUE_H
+
+#include <array>
+#include <cstdint>
+#include <limits>
+
+#include "symusic/mtype.h"
+
+namespace symusic::details {
+
+/**
+ * First-in first-out queues of open notes, one per (channel, pitch) key.
+ *
+ * The front of every queue lives in a flat table, so the common case of a single open note per
+ * key never allocates. Further notes go to an overflow list in a pool whose nodes are recycled,
+ * and ``reset`` only clears the keys used since the previous reset, so one instance can be reused
+ * for every chunk of every file.
+ */
+template<typename Payload>
+class NoteQueue {
+public:
+    static constexpr size_t num_keys = 16 * 128;
+
+    [[nodiscard]] static constexpr uint16_t key_of(const uint8_t channel, const uint8_t pitch) {
+        return static_cast<uint16_t>(channel * 128 + pitch);
+    }
+
+    /// Number of open notes of ``key``.
+    [[nodiscard]] uint32_t count(const uint16_t key) const { return slots[key].count; }
+
+    /// The oldest open note of ``key``; requires ``count(key) > 0``.
+    [[nodiscard]] const Payload& front(const uint16_t key) const { return slots[key].front; }
+
+    void push(const uint16_t key, const Payload& payload) {
+        Slot& slot = slots[key];
+        if (slot.count++ == 0) {
+            slot.front = payload;
+            used.push_back(key);
+            return;
+        }
+        // Put the extra note at the end of the overflow list
+        uint32_t node = free_head;
+        if (node != npos) {
+            free_head  = pool[node].next;
+            pool[node] = Node{payload};
+        } else {
+            node = static_cast<uint32_t>(pool.size());
+            pool.push_back(Node{payload});
+        }
+        if (slot.tail == npos) {
+            slot.head = node;
+        } else {
+            pool[slot.tail].next = node;
+        }
+        slot.tail = node;
+    }
+
+    /// Drop the oldest open note of ``key``; requires ``count(key) > 0``.
+    void pop(const uint16_t key) {
+        Slot& slot = slots[key];
+        if (--slot.count == 0) return;
+        // Pop the overflow list into the front slot
+        const uint32_t node = slot.head;
+        slot.front          = pool[node].payload;
+        slot.head           = pool[node].next;
+        if (slot.head == npos) slot.tail = npos;
+        pool[node].next = free_head;
+        free_head       = node;
+    }
+
+    /// Keys that received a note since the last reset, possibly repeated.
+    [[nodiscard]] const vec<uint16_t>& touched() const { return used; }
+
+    void reset() {
+        for (const uint16_t key : used) slots[key] = Slot{};
+        used.clear();
+        pool.clear();
+        free_head = npos;
+    }
+
+private:
+    static constexpr uint32_t npos = std::numeric_limits<uint32_t>::max();
+
+    struct Node {
+        Payload  payload;
+        uint32_t next = npos;
+    };
+
+    struct Slot {
+        uint32_t count = 0;
+        Payload  front{};
+        uint32_t head = npos;
+        uint32_t tail = npos;
+    };
+
+    std::array<Slot, num_keys> slots{};
+    vec<Node>                  pool;
+    uint32_t                   free_head = npos;
+    vec<uint16_t>              used;
+};
+
+}   // namespace symusic::details
+
+#endif   // LIBSYMUSIC_DETAIL_NOTE_QUEUE_H
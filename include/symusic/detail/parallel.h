@@ -0,0 +1,90 @@
+#pragma once
+
+#ifndef LIBSYMUSIC_DETAIL_PARALLEL_H
+#define LIBSYMUSIC_DETAIL_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <thread>
+
+#include "symusic/mtype.h"
+
+namespace symusic::details {
+
+/**
+ * Resolve a user supplied worker count. ``0`` means "use all hardware threads", and the result
+ * never exceeds the number of work items so that no idle thread is spawned.
+ */
+[[nodiscard]] inline size_t resolve_num_threads(const size_t num_threads, const size_t num_items) {
+    size_t n = num_threads;
+    if (n == 0) { n = std::max<size_t>(std::thread::hardware_concurrency(), 1); }
+    return std::max<size_t>(std::min(n, num_items), 1);
+}
+
+/**
+ * Run ``func(worker, index)`` for every index in [0, num_items) on up to ``num_threads`` threads.
+ *
+ * ``worker`` lies in [0, resolve_num_threads(num_threads, num_items)) and is stable for the thread
+ * that runs the call, so callers can keep per-worker scratch state without locking. Items are
+ * handed out through a shared atomic counter, so uneven item costs (e.g. MIDI tracks of very
+ * different lengths) balance themselves. The calling thread takes part in the work as worker 0.
+ * If any call throws, the remaining items are skipped and the exception of the smallest failing
+ * index is rethrown once all workers have joined, which matches what a sequential loop would
+ * have reported.
+ */
+template<typename Func>
+void parallel_for_workers(const size_t num_items, const size_t num_threads, Func&& func) {
+    const size_t workers = resolve_num_threads(num_threads, num_items);
+    if (workers <= 1) {
+        for (size_t i = 0; i < num_items; ++i) { func(size_t{0}, i); }
+        return;
+    }
+
+    std::atomic<size_t> next{0};
+    std::atomic<bool>   failed{false};
+    std::mutex          error_mutex;
+    std::exception_ptr  error;
+    size_t              error_index = std::numeric_limits<size_t>::max();
+
+    auto worker = [&](const size_t worker_id) {
+        while (!failed.load(std::memory_order_relaxed)) {
+            const size_t i = next.fetch_add(1, std::memory_order_relaxed);
+            if (i >= num_items) break;
+            try {
+                func(worker_id, i);
+            } catch (...) {
+                std::lock_guard lock(error_mutex);
+                if (i < error_index) {
+                    error_index = i;
+                    error       = std::current_exception();
+                }
+                failed.store(true, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    vec<std::thread> threads;
+    threads.reserve(workers - 1);
+    for (size_t t = 1; t < workers; ++t) { threads.emplace_back(worker, t); }
+    worker(0);
+    for (auto& thread : threads) { thread.join(); }
+
+    if (error) { std::rethrow_exception(error); }
+}
+
+/**
+ * Run ``func(index)`` for every index in [0, num_items) on up to ``num_threads`` threads, see
+ * ``parallel_for_workers`` for the scheduling and error semantics.
+ */
+template<typename Func>
+void parallel_for(const size_t num_items, const size_t num_threads, Func&& func) {
+    parallel_for_workers(num_items, num_threads, [&](size_t, const size_t i) { func(i); });
+}
+
+}   // namespace symusic::details
+
+#endif   // LIBSYMUSIC_DETAIL_PARALLEL_H
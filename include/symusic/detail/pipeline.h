@@ -0,0 +1,164 @@
+#pragma once
+
+#ifndef LIBSYMUSIC_DETAIL_PIPELINE_H
+#define LIBSYMUSIC_DETAIL_PIPELINE_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+
+#include "symusic/mtype.h"
+
+namespace symusic::details {
+
+/**
+ * Bounded hand-off from producer threads (which read raw items) through worker threads (which turn
+ * them into results) to a single consumer that receives the results in production order.
+ *
+ * A producer ``claim()``s the next index before submitting it, and only gets one while fewer than
+ * ``window`` items are claimed but not yet taken. This is the backpressure: a slow consumer stalls
+ * the producers instead of making the pipeline buffer everything. Every in-flight item owns the
+ * result slot ``index % window`` until ``take()`` hands it out.
+ *
+ * ``total`` is the number of items if it is known up front; otherwise the last producer to finish
+ * reports it through ``producer_done``, optionally with the error that ended production. That
+ * error is rethrown by ``take()`` after every item produced before it.
+ *
+ * Threads are started with ``spawn`` and joined by ``stop()`` or the destructor, which also wake
+ * every blocked producer and worker so the pipeline can be abandoned at any point.
+ */
+template<typename Raw, typename Result>
+class OrderedPipeline {
+public:
+    static constexpr size_t unknown = std::numeric_limits<size_t>::max();
+
+    OrderedPipeline(
+        const size_t window, const size_t num_producers, const size_t num_items = unknown
+    ) :
+        total(num_items), producers(num_producers), slots(std::max<size_t>(window, 1)) {}
+
+    OrderedPipeline(const OrderedPipeline&)            = delete;
+    OrderedPipeline& operator=(const OrderedPipeline&) = delete;
+
+    ~OrderedPipeline() { stop(); }
+
+    template<typename Func>
+    void spawn(Func&& func) {
+        threads.emplace_back(std::forward<Func>(func));
+    }
+
+    /// Producer: wait for room in the window; ``std::nullopt`` once stopped or all items claimed.
+    std::optional<size_t> claim() {
+        std::unique_lock lock(mutex);
+        can_claim.wait(lock, [&] {
+            return stopping || next_claim >= total || next_claim < next_take + slots.size();
+        });
+        if (stopping || next_claim >= total) return std::nullopt;
+        return next_claim++;
+    }
+
+    /// Producer: queue the raw item for a worker.
+    void submit(const size_t index, Raw raw) {
+        {
+            std::lock_guard lock(mutex);
+            queue.emplace_back(index, std::move(raw));
+        }
+        can_pop.notify_one();
+    }
+
+    /// Producer or worker: store the result of a claimed item.
+    void fill(const size_t index, Result result) {
+        {
+            std::lock_guard lock(mutex);
+            slots[index % slots.size()].emplace(std::move(result));
+        }
+        can_take.notify_all();
+    }
+
+    /// Producer: this producer is finished. ``num_items`` and ``failure`` (if set) end the stream.
+    void producer_done(const size_t num_items = unknown, std::exception_ptr failure = nullptr) {
+        {
+            std::lock_guard lock(mutex);
+            if (num_items != unknown) total = num_items;
+            if (failure) error = std::move(failure);
+            --producers;
+        }
+        can_claim.notify_all();
+        can_pop.notify_all();
+        can_take.notify_all();
+    }
+
+    /// Worker: the next raw item; ``std::nullopt`` once stopped or every producer is done.
+    std::optional<std::pair<size_t, Raw>> pop() {
+        std::unique_lock lock(mutex);
+        can_pop.wait(lock, [&] { return stopping || !queue.empty() || producers == 0; });
+        if (stopping || queue.empty()) return std::nullopt;
+        auto item = std::move(queue.front());
+        queue.pop_front();
+        return item;
+    }
+
+    /// Consumer: block until the next result in order is ready; ``std::nullopt`` after the last.
+    std::optional<std::pair<size_t, Result>> take() {
+        std::unique_lock lock(mutex);
+        auto& slot = slots[next_take % slots.size()];
+        can_take.wait(lock, [&] { return slot.has_value() || next_take >= total; });
+        if (!slot.has_value()) {
+            if (error) { std::rethrow_exception(std::exchange(error, nullptr)); }
+            return std::nullopt;
+        }
+        std::pair<size_t, Result> item{next_take, std::move(*slot)};
+        slot.reset();
+        ++next_take;
+        lock.unlock();
+        can_claim.notify_all();
+        return item;
+    }
+
+    /// Number of results handed out by ``take()``.
+    [[nodiscard]] size_t num_taken() const {
+        std::lock_guard lock(mutex);
+        return next_take;
+    }
+
+    /// Wake and join every thread. Pending items are dropped.
+    void stop() noexcept {
+        {
+            std::lock_guard lock(mutex);
+            stopping = true;
+        }
+        can_claim.notify_all();
+        can_pop.notify_all();
+        for (auto& thread : threads) {
+            if (thread.joinable()) thread.join();
+        }
+    }
+
+private:
+    mutable std::mutex      mutex;
+    std::condition_variable can_claim;   // the window moved, production ended or stopping
+    std::condition_variable can_pop;     // raw items queued, producers done or stopping
+    std::condition_variable can_take;    // a slot was filled or production ended
+
+    size_t             total;
+    size_t             producers;
+    size_t             next_claim = 0;
+    size_t             next_take  = 0;
+    bool               stopping   = false;
+    std::exception_ptr error;
+
+    std::deque<std::pair<size_t, Raw>> queue;
+    vec<std::optional<Result>>         slots;
+    vec<std::thread>                   threads;
+};
+
+}   // namespace symusic::details
+
+#endif   // LIBSYMUSIC_DETAIL_PIPELINE_H
@@ -190,6 +190,34 @@ struct SecondTimeConverter {
         return pyvec<Event<To>>(std::move(converted));
     }
 
+    /**
+     * Stateful converter for a non-decreasing stream of times, such as the messages of a single
+     * MIDI track. It walks forward through the tempo segments instead of binary-searching them
+     * for every event, and produces exactly the same values as ``time_value``. A time that moves
+     * backwards falls back to a binary search.
+     */
+    class Cursor {
+        const SecondTimeConverter* converter;
+        size_t                     index = 0;
+
+    public:
+        explicit Cursor(const SecondTimeConverter& converter) : converter(&converter) {}
+
+        [[nodiscard]] to_unit operator()(const from_unit time) {
+            const auto& from_times = converter->from_times;
+            if (time < from_times[index]) {
+                index = converter->range_index(time);
+            } else {
+                while (index + 1 < from_times.size() && time >= from_times[index + 1]) { ++index; }
+            }
+            return Converter::get_time(
+                time, converter->to_times[index], from_times[index], converter->factors[index]
+            );
+        }
+    };
+
+    [[nodiscard]] Cursor cursor() const { return Cursor(*this); }
+
 private:
     [[nodiscard]] size_t range_index(const from_unit time) const {
         return static_cast<size_t>(
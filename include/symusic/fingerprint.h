@@ -0,0 +1,51 @@
+//
+// Musical content fingerprint of a score, for corpus deduplication.
+//
+#pragma once
+
+#ifndef LIBSYMUSIC_FINGERPRINT_H
+#define LIBSYMUSIC_FINGERPRINT_H
+
+#include <string>
+
+#include "symusic/score.h"
+
+namespace symusic {
+
+/**
+ * 128-bit hash of the notes of a score.
+ *
+ * Only notes count: their onset and duration in quarters (rounded to ``1 / RESOLUTION`` of a
+ * quarter, which makes the hash independent of the ticks per quarter), pitch, velocity, program
+ * and drum flag. Track names, track order, meta events and every other event are ignored. The
+ * per-note hashes are summed, so the result does not depend on note order or on how notes are
+ * split into tracks, and it can be accumulated while decoding.
+ */
+struct Fingerprint {
+    static constexpr i64 RESOLUTION = 960;
+
+    u64 hi = 0;
+    u64 lo = 0;
+
+    /// Add one note; ``onset`` and ``duration`` are already scaled to ``RESOLUTION``.
+    void add_note(i64 onset, i64 duration, u8 pitch, u8 velocity, u8 program, bool is_drum);
+
+    /// Scale a tick time to ``RESOLUTION`` per quarter, rounding half up.
+    [[nodiscard]] static i64 normalize(i64 tick, i32 ticks_per_quarter);
+
+    /// The 32 hex digits of ``hi`` followed by ``lo``.
+    [[nodiscard]] std::string hex() const;
+
+    bool operator==(const Fingerprint& other) const = default;
+};
+
+/**
+ * Fingerprint the notes of ``score``. Quarter times are mapped back to ticks first and scores in
+ * seconds are converted to ticks, so the same file yields the same fingerprint in every unit.
+ */
+template<TType T>
+[[nodiscard]] Fingerprint fingerprint(const Score<T>& score);
+
+}   // namespace symusic
+
+#endif   // LIBSYMUSIC_FINGERPRINT_H
@@ -0,0 +1,78 @@
+//
+// Parse MIDI files straight out of tar, tar.gz and zip archives without extracting them.
+//
+#pragma once
+
+#ifndef LIBSYMUSIC_IO_ARCHIVE_H
+#define LIBSYMUSIC_IO_ARCHIVE_H
+
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "symusic/io/batch.h"
+#include "symusic/score.h"
+
+namespace symusic {
+
+/**
+ * Options of an ``ArchiveReader``.
+ *
+ * ``parse.num_threads`` sets the number of workers that decompress and parse members (``0`` uses
+ * every hardware thread). ``prefetch`` bounds the number of members read ahead of the consumer,
+ * ``0`` picks four per worker. Only regular members whose name ends with one of ``suffixes``
+ * (compared case-insensitively) are parsed; an empty list selects every regular member.
+ */
+struct ArchiveOptions {
+    ParseOptions     parse;
+    size_t           prefetch = 0;
+    vec<std::string> suffixes = {".mid", ".midi"};
+};
+
+/// One archive member, as returned by ``ArchiveReader::next``.
+template<TType T>
+struct ArchiveItem {
+    size_t               index;
+    std::string          name;
+    LoadResult<Score<T>> result;
+};
+
+/**
+ * Streams the parsed MIDI members of an archive in archive order.
+ *
+ * Supported are uncompressed tar, gzip-compressed tar and zip archives with stored or deflate
+ * members (including zip64), detected from the leading bytes of the file. The archive is memory
+ * mapped and read front to back by one reader thread; nothing is extracted to disk. A tar.gz is
+ * decompressed on that thread while the members found so far are parsed on the workers. Zip
+ * members are compressed independently, so they are inflated on the workers as well.
+ *
+ * A member that cannot be decompressed or parsed yields an item with an error. Damage to the
+ * archive structure itself (a bad tar header, a corrupted gzip stream or zip directory) ends the
+ * stream: ``next()`` throws ``std::runtime_error`` after returning every member before it.
+ *
+ * Like ``CorpusReader``, at most ``prefetch`` members are in flight, the threads are joined by the
+ * destructor and ``next()`` must not be called concurrently.
+ */
+template<TType T>
+class ArchiveReader {
+public:
+    explicit ArchiveReader(const std::filesystem::path& path, const ArchiveOptions& options = {});
+    ArchiveReader(ArchiveReader&&) noexcept;
+    ArchiveReader& operator=(ArchiveReader&&) noexcept;
+    ~ArchiveReader();
+
+    /// Block until the next selected member is parsed; ``std::nullopt`` after the last one.
+    [[nodiscard]] std::optional<ArchiveItem<T>> next();
+
+    /// Number of items returned by ``next()`` so far.
+    [[nodiscard]] size_t num_consumed() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl;
+};
+
+}   // namespace symusic
+
+#endif   // LIBSYMUSIC_IO_ARCHIVE_H
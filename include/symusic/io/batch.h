@@ -0,0 +1,70 @@
+//
+// Batch helpers that parse or write many files on a native thread pool.
+//
+#pragma once
+
+#ifndef LIBSYMUSIC_IO_BATCH_H
+#define LIBSYMUSIC_IO_BATCH_H
+
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+
+#include "symusic/io/iodef.h"
+
+namespace symusic {
+
+/**
+ * Outcome of loading one item of a batch. Exactly one of ``value`` and ``error`` is set, so a
+ * single corrupted file never aborts the rest of the batch.
+ */
+template<typename T>
+struct LoadResult {
+    std::optional<T> value;
+    std::string      error;
+
+    [[nodiscard]] bool ok() const { return value.has_value(); }
+};
+
+/**
+ * Read and parse every file in ``paths``, returning the results in input order.
+ *
+ * ``options.num_threads`` sets the size of the file-level worker pool (``0`` uses every hardware
+ * thread); each individual file is then decoded sequentially, as nesting track-level parallelism
+ * inside a saturated pool only adds contention. The remaining options apply to every file.
+ */
+template<DataFormat F, typename T>
+[[nodiscard]] vec<LoadResult<T>> parse_many(
+    std::span<const std::filesystem::path> paths, const ParseOptions& options
+);
+
+/**
+ * Encode every score in ``scores``, returning the results in input order.
+ *
+ * ``options.num_threads`` sets the size of the score-level worker pool, like in ``parse_many``;
+ * each score is then encoded sequentially. A score that fails to encode yields its error instead
+ * of discarding the bytes of the rest of the batch.
+ */
+template<DataFormat F, typename T>
+[[nodiscard]] vec<LoadResult<vec<u8>>> dumps_many(
+    std::span<const T* const> scores, const DumpOptions& options
+);
+
+/**
+ * Encode every score in ``scores`` and write it to the file at the same position in ``paths``.
+ *
+ * Returns one message per item in input order, empty if the item was written, so a single
+ * unwritable path never aborts the rest of the batch. ``options`` behaves like in ``dumps_many``.
+ * Throws ``std::invalid_argument`` if ``scores`` and ``paths`` differ in length.
+ */
+template<DataFormat F, typename T>
+[[nodiscard]] vec<std::string> dump_many(
+    std::span<const T* const>              scores,
+    std::span<const std::filesystem::path> paths,
+    const DumpOptions&                     options
+);
+
+}   // namespace symusic
+
+#endif   // LIBSYMUSIC_IO_BATCH_H
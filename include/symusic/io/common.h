@@ -22,6 +22,39 @@ void write_file(const std::filesystem::path & path, std::span<const u8> buffer);
 
 void write_file(const std::string & path, std::span<const u8> buffer);
 
+/**
+ * Read-only view of a whole file that is memory-mapped instead of copied, so parsing runs over the
+ * page cache without allocating a buffer for the file.
+ *
+ * Files that cannot be mapped (pipes, special files) are read into an owned buffer instead, so
+ * ``bytes()`` always covers the whole file. The view stays valid until the ``MappedFile`` is
+ * destroyed or moved from. Truncating the file while it is mapped is undefined behaviour, as with
+ * any memory map. Opening a missing file throws ``std::runtime_error`` like ``read_file``.
+ */
+class MappedFile {
+public:
+    explicit MappedFile(const std::filesystem::path & path);
+    ~MappedFile();
+
+    MappedFile(MappedFile && other) noexcept;
+    MappedFile & operator=(MappedFile && other) noexcept;
+    MappedFile(const MappedFile &) = delete;
+    MappedFile & operator=(const MappedFile &) = delete;
+
+    [[nodiscard]] std::span<const u8> bytes() const { return {view, length}; }
+    [[nodiscard]] size_t size() const { return length; }
+    /// Whether ``bytes()`` points into a memory map rather than a buffer read from the file.
+    [[nodiscard]] bool mapped() const { return mapping != nullptr; }
+
+private:
+    const u8* view    = nullptr;
+    size_t    length  = 0;
+    void*     mapping = nullptr;   // start of the map, or nullptr when reading into ``fallback``
+    vec<u8>   fallback;
+
+    void release() noexcept;
+};
+
 }
 
 #endif //LIBSYMUSIC_IO_COMMON_H
@@ -0,0 +1,77 @@
+//
+// Read-ahead pipeline that overlaps file reads with parsing for directory-scale processing.
+//
+#pragma once
+
+#ifndef LIBSYMUSIC_IO_CORPUS_H
+#define LIBSYMUSIC_IO_CORPUS_H
+
+#include <filesystem>
+#include <memory>
+#include <optional>
+
+#include "symusic/io/batch.h"
+#include "symusic/score.h"
+
+namespace symusic {
+
+/**
+ * Options of a ``CorpusReader``.
+ *
+ * ``parse.num_threads`` sets the number of parsing workers (``0`` uses every hardware thread);
+ * each file is then decoded sequentially, like in ``parse_many``. ``io_threads`` files are read
+ * concurrently, which hides per-request latency on network filesystems. ``prefetch`` bounds the
+ * number of files that have been claimed for reading but not yet returned by ``next()``, and with
+ * it the memory held by the pipeline; ``0`` picks four files per parsing worker.
+ */
+struct CorpusOptions {
+    ParseOptions parse;
+    size_t       io_threads = 1;
+    size_t       prefetch   = 0;
+};
+
+/// One file of a corpus, as returned by ``CorpusReader::next``.
+template<TType T>
+struct CorpusItem {
+    size_t                index;
+    std::filesystem::path path;
+    LoadResult<Score<T>>  result;
+};
+
+/**
+ * Streams the parsed scores of a list of MIDI files while later files are still being read.
+ *
+ * Dedicated I/O threads read whole files into memory, ahead of the consumer, and hand them to
+ * parsing workers through a bounded queue. Once ``prefetch`` files are in flight the I/O threads
+ * wait for the consumer, so a slow consumer never makes the pipeline buffer the whole corpus.
+ * ``next()`` returns the files in input order; a file that cannot be read or parsed yields an
+ * item with an error instead of aborting the corpus.
+ *
+ * The threads start in the constructor and are stopped and joined by the destructor, also when the
+ * corpus has not been consumed completely. ``next()`` must not be called concurrently.
+ */
+template<TType T>
+class CorpusReader {
+public:
+    explicit CorpusReader(vec<std::filesystem::path> paths, const CorpusOptions& options = {});
+    CorpusReader(CorpusReader&&) noexcept;
+    CorpusReader& operator=(CorpusReader&&) noexcept;
+    ~CorpusReader();
+
+    /// Block until the next file in input order is parsed; ``std::nullopt`` after the last one.
+    [[nodiscard]] std::optional<CorpusItem<T>> next();
+
+    /// Number of files in the corpus.
+    [[nodiscard]] size_t size() const;
+
+    /// Number of items returned by ``next()`` so far.
+    [[nodiscard]] size_t num_consumed() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl;
+};
+
+}   // namespace symusic
+
+#endif   // LIBSYMUSIC_IO_CORPUS_H
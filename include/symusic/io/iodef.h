@@ -6,6 +6,10 @@
 #ifndef LIBSYMUSIC_IO_IODEF_H
 #define LIBSYMUSIC_IO_IODEF_H
 
+#include <limits>
+#include <optional>
+#include <string>
+
 #include "symusic/mtype.h"
 namespace symusic {
 
@@ -17,6 +21,82 @@ enum class DataFormat {
     ZPP,        // zpp_bits, c++20, customised binary format, https://github.com/eyalz800/zpp_bits
     ALPACA,     // alpaca,   c++17, customised binary format, https://github.com/p-ranav/alpaca
     CEREAL,     // cereal,   c++11, customised binary format, https://github.com/USCiLab/cereal
+    COLUMNAR,   // symusic columnar cache, delta coded and bit-packed, see src/io/columnar.cpp
+};
+
+/**
+ * A time range to decode, in the time unit of the parsed score.
+ *
+ * The result equals ``Score::trim(start, end, min_overlap, start_mode, end_mode)`` of the full
+ * parse, with the same ``"remove"`` / ``"truncate"`` modes, except for what lies past ``end``:
+ * tracks are still created by their first note or lyric, so a track that starts after ``end`` is
+ * missing even if it has controls inside the window, and tracks left without any event are
+ * omitted. With ``end_mode == "truncate"``, notes still sounding when a chunk passes ``end`` are
+ * closed there even if the file never ends them. Pedals still held at ``end`` are dropped, and
+ * track names that only appear after ``end`` are not seen.
+ */
+struct ParseWindow {
+    f64         start       = 0;
+    f64         end         = std::numeric_limits<f64>::infinity();
+    f64         min_overlap = 0;
+    std::string start_mode  = "remove";
+    std::string end_mode    = "remove";
+};
+
+/**
+ * Options controlling how raw bytes are decoded into a score.
+ *
+ * ``sanitize_data`` clamps channel message data bytes to the 7-bit MIDI range instead of throwing.
+ * Clamping happens while decoding, so valid files cost the same in both modes.
+ * ``num_threads`` decodes independent MIDI track chunks concurrently; ``1`` keeps the sequential
+ * path and ``0`` uses every hardware thread. The result is identical for any thread count.
+ * The ``keep_*`` flags project the decode onto the event classes a caller needs: events of a
+ * dropped class are skipped without validation or allocation, and tracks left without any kept
+ * event are omitted, just like empty tracks are today.
+ * ``window`` stops decoding each MIDI track chunk once its running time passes ``window->end``
+ * and drops channel events before ``window->start``, see ``ParseWindow``. It is honoured by
+ * ``parse`` and everything built on it, but not by ``LazyScore`` and ``MidiStreamParser``.
+ */
+struct ParseOptions {
+    bool   sanitize_data = false;
+    size_t num_threads   = 1;
+
+    bool keep_notes           = true;
+    bool keep_controls        = true;
+    bool keep_pitch_bends     = true;
+    bool keep_pedals          = true;
+    bool keep_lyrics          = true;
+    bool keep_tempos          = true;
+    bool keep_time_signatures = true;
+    bool keep_key_signatures  = true;
+    bool keep_markers         = true;
+
+    std::optional<ParseWindow> window;
+};
+
+/**
+ * Options controlling how a score is encoded into raw bytes.
+ *
+ * ``running_status`` omits the status byte of a channel message that repeats the status of the
+ * previous one in the same track, as the MIDI standard allows. Every MIDI reader supports it, but
+ * it is off by default so existing callers keep getting the same bytes.
+ * ``num_threads`` encodes MIDI track chunks concurrently and joins them in track order; ``1`` keeps
+ * the sequential path and ``0`` uses every hardware thread. The bytes are identical for any thread
+ * count.
+ * ``compact`` implies running status and leaves out events that do not change the playback: every
+ * tempo that repeats the last one and, on channels used by a single track, a program change to
+ * program 0 and every control change or pitch bend that repeats the last value sent. Data entry,
+ * data increment/decrement, RPN/NRPN selects and channel mode messages are always kept, and Reset
+ * All Controllers forgets the last values. Parsing the result therefore yields fewer events.
+ * ``format`` selects a multi-track (``1``) or single-track (``0``) file. Format 0 interleaves every
+ * track into one chunk on the same channels as format 1, keeps only the first track name and is
+ * always encoded sequentially; parsing it splits the tracks by channel and program again.
+ */
+struct DumpOptions {
+    bool   running_status = false;
+    size_t num_threads    = 1;
+    bool   compact        = false;
+    u8     format         = 1;
 };
 
 template<DataFormat F, typename T>
@@ -32,9 +112,15 @@ template<DataFormat F, typename T>
 template<DataFormat F, typename T>
 [[nodiscard]] T parse(std::span<const u8> bytes, bool sanitize_data);
 
+template<DataFormat F, typename T>
+[[nodiscard]] T parse(std::span<const u8> bytes, const ParseOptions& options);
+
 template<DataFormat F, typename T>
 [[nodiscard]] vec<u8> dumps(const T& data);
 
+template<DataFormat F, typename T>
+[[nodiscard]] vec<u8> dumps(const T& data, const DumpOptions& options);
+
 }   // namespace symusic
 
 #endif   // LIBSYMUSIC_IO_IODEF_H
@@ -0,0 +1,74 @@
+//
+// Lazily decoded MIDI score: MTrk chunks are only parsed when they are first accessed.
+//
+#pragma once
+
+#ifndef LIBSYMUSIC_IO_LAZY_H
+#define LIBSYMUSIC_IO_LAZY_H
+
+#include <filesystem>
+#include <memory>
+
+#include "symusic/io/iodef.h"
+#include "symusic/score.h"
+
+namespace symusic {
+
+/**
+ * A MIDI file whose tracks are decoded on demand.
+ *
+ * Opening a file only reads the header and decodes the conductor (first) MTrk chunk, which
+ * holds the score-level meta events of almost every multi-track file. Any other chunk is decoded
+ * the first time ``midi_track(i)`` is called and then cached. One MTrk chunk may expand into
+ * several tracks (one per channel and program), so tracks are addressed by chunk index.
+ *
+ * ``to_score()`` decodes the remaining chunks and returns a score identical to a full parse with
+ * the same options; it shares the cached tracks. Scores in seconds pre-scan every chunk for
+ * tempo events at open time, since the tempo map is needed before any chunk can be decoded.
+ *
+ * A ``LazyScore`` is not thread-safe: concurrent first accesses must be synchronised by the
+ * caller.
+ */
+template<TType T>
+class LazyScore {
+public:
+    typedef T                ttype;
+    typedef typename T::unit unit;
+
+    explicit LazyScore(vec<u8> bytes, const ParseOptions& options = {});
+
+    [[nodiscard]] static LazyScore from_file(
+        const std::filesystem::path& path, const ParseOptions& options = {}
+    );
+
+    LazyScore(LazyScore&&) noexcept;
+    LazyScore& operator=(LazyScore&&) noexcept;
+    ~LazyScore();
+
+    [[nodiscard]] i32 ticks_per_quarter() const;
+
+    [[nodiscard]] size_t num_midi_tracks() const;
+
+    /// Whether the chunk at ``index`` has already been decoded.
+    [[nodiscard]] bool is_decoded(size_t index) const;
+
+    /// Tracks decoded from the MTrk chunk at ``index``, decoding it on first access.
+    [[nodiscard]] const vec<shared<Track<T>>>& midi_track(size_t index);
+
+    /**
+     * Score-level meta events (time signatures, key signatures, tempos and markers) of the
+     * conductor chunk, sorted by time. The tracks of the returned score are empty.
+     */
+    [[nodiscard]] const Score<T>& conductor() const;
+
+    /// Decode every remaining chunk (on ``options.num_threads`` workers) and assemble the score.
+    [[nodiscard]] Score<T> to_score();
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl;
+};
+
+}   // namespace symusic
+
+#endif   // LIBSYMUSIC_IO_LAZY_H
@@ -0,0 +1,67 @@
+//
+// Metadata-only MIDI scan: summary statistics without building any score objects.
+//
+#pragma once
+
+#ifndef LIBSYMUSIC_IO_MIDI_INFO_H
+#define LIBSYMUSIC_IO_MIDI_INFO_H
+
+#include <array>
+#include <filesystem>
+#include <span>
+
+#include "symusic/fingerprint.h"
+#include "symusic/mtype.h"
+
+namespace symusic {
+
+/**
+ * Summary of a MIDI file gathered by walking its message stream once.
+ *
+ * The counts follow the rules of a full ``Score<Tick>`` parse: a note only counts once it is
+ * closed by a matching NoteOff, ``num_tracks`` is the number of tracks the parse would produce,
+ * and ``end_tick`` equals ``Score<Tick>::end()``. ``end_second`` maps ``end_tick`` through the
+ * tempo map in the same way as the tick to second conversion.
+ */
+struct MidiInfo {
+    u16 ticks_per_quarter = 0;
+    u32 num_midi_tracks   = 0;   // number of MTrk chunks
+    u32 num_tracks        = 0;   // number of tracks in the parsed score
+
+    u64                  note_num      = 0;
+    u64                  drum_note_num = 0;     // notes on channel 10, included in note_num
+    std::array<u64, 128> notes_per_program{};   // non-drum notes keyed by GM program
+
+    i32 end_tick   = 0;
+    f32 end_second = 0;
+
+    u32 tempo_num = 0;
+    f64 min_qpm   = 0;   // 0 when the file has no tempo event
+    f64 max_qpm   = 0;
+
+    u32 time_signature_num = 0;
+    u8  numerator          = 4;   // earliest time signature, 4/4 if there is none
+    u8  denominator        = 4;
+    u32 key_signature_num  = 0;
+
+    Fingerprint fingerprint;   // equals ``fingerprint()`` of the parsed score
+
+    [[nodiscard]] bool has_drums() const { return drum_note_num > 0; }
+
+    bool operator==(const MidiInfo& other) const = default;
+};
+
+/**
+ * Scan raw MIDI bytes without creating notes, tracks or any other event container.
+ *
+ * Invalid payload bytes raise ``std::runtime_error`` exactly like a full parse unless
+ * ``sanitize_data`` is set, so a file that scans cleanly also parses cleanly.
+ */
+[[nodiscard]] MidiInfo scan_midi(std::span<const u8> bytes, bool sanitize_data = false);
+
+/// Read ``path`` and scan it, see ``scan_midi(std::span<const u8>, bool)``.
+[[nodiscard]] MidiInfo scan_midi(const std::filesystem::path& path, bool sanitize_data = false);
+
+}   // namespace symusic
+
+#endif   // LIBSYMUSIC_IO_MIDI_INFO_H
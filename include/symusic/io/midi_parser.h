@@ -0,0 +1,44 @@
+//
+// Reusable MIDI parser that keeps its scratch state between files.
+//
+#pragma once
+
+#ifndef LIBSYMUSIC_IO_MIDI_PARSER_H
+#define LIBSYMUSIC_IO_MIDI_PARSER_H
+
+#include <memory>
+#include <span>
+
+#include "symusic/io/iodef.h"
+#include "symusic/score.h"
+
+namespace symusic {
+
+/**
+ * A MIDI parser context meant to be reused for many files.
+ *
+ * ``parse<MIDI, Score<T>>`` builds its bookkeeping (per-channel track tables, pending-note slots
+ * and their overflow, per-chunk fragments) from scratch on every call. A ``MidiParser`` keeps all
+ * of it between calls and only clears it, so once it has warmed up, parsing another file
+ * allocates nothing beyond the returned score. The results are identical to ``parse``.
+ *
+ * A parser is not thread-safe; use one per worker thread.
+ */
+class MidiParser {
+public:
+    MidiParser();
+    MidiParser(MidiParser&&) noexcept;
+    MidiParser& operator=(MidiParser&&) noexcept;
+    ~MidiParser();
+
+    template<TType T>
+    [[nodiscard]] Score<T> parse(std::span<const u8> bytes, const ParseOptions& options = {});
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl;
+};
+
+}   // namespace symusic
+
+#endif   // LIBSYMUSIC_IO_MIDI_PARSER_H
@@ -0,0 +1,69 @@
+//
+// Push-based MIDI parser for input that arrives in pieces (pipes, HTTP bodies, decompressors).
+//
+#pragma once
+
+#ifndef LIBSYMUSIC_IO_MIDI_STREAM_H
+#define LIBSYMUSIC_IO_MIDI_STREAM_H
+
+#include <functional>
+#include <memory>
+#include <span>
+
+#include "symusic/io/iodef.h"
+#include "symusic/score.h"
+
+namespace symusic {
+
+/**
+ * A MIDI parser fed with byte chunks of arbitrary size.
+ *
+ * Every MTrk chunk is decoded as soon as its last byte has been fed, so parsing overlaps with
+ * whatever produces the bytes, and only the chunk that is still incomplete is buffered. The tracks
+ * of a decoded chunk are handed to ``on_tracks`` (if set) and queued for ``take_ready()``.
+ * ``finish()`` returns a score identical to ``parse`` on the concatenated bytes.
+ *
+ * Scores in seconds convert every chunk with the tempo map of the conductor (first) chunk. If a
+ * later chunk carries tempo events, ``finish()`` falls back to a full re-parse just like ``parse``
+ * does, so the tracks it returns may then differ from the ones emitted earlier. To make that
+ * fallback possible, ``MidiStreamParser<Second>`` keeps a copy of every chunk it has decoded, so
+ * it holds about as much memory as the whole input until the last declared chunk arrives. The
+ * copy is released then, unless the fallback is needed, in which case it is kept until
+ * ``finish()``.
+ *
+ * A parser is single-use and not thread-safe.
+ */
+template<TType T>
+class MidiStreamParser {
+public:
+    /// Called with the MTrk chunk index and the tracks decoded from it, in chunk order.
+    using TrackCallback = std::function<void(size_t, const vec<shared<Track<T>>>&)>;
+
+    explicit MidiStreamParser(const ParseOptions& options = {}, TrackCallback on_tracks = {});
+    MidiStreamParser(MidiStreamParser&&) noexcept;
+    MidiStreamParser& operator=(MidiStreamParser&&) noexcept;
+    ~MidiStreamParser();
+
+    /// Append ``bytes`` and decode every MTrk chunk they complete.
+    void feed(std::span<const u8> bytes);
+
+    /// Tracks decoded since the previous call, in chunk order.
+    [[nodiscard]] vec<shared<Track<T>>> take_ready();
+
+    /// Number of MTrk chunks decoded so far.
+    [[nodiscard]] size_t num_decoded() const;
+
+    /**
+     * Assemble the score. Throws ``std::runtime_error`` if fewer chunks were fed than the header
+     * declares. The parser is spent afterwards.
+     */
+    [[nodiscard]] Score<T> finish();
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl;
+};
+
+}   // namespace symusic
+
+#endif   // LIBSYMUSIC_IO_MIDI_STREAM_H
@@ -0,0 +1,29 @@
+//
+// Direct MIDI encoder that writes a score without building an intermediate minimidi::MidiFile.
+//
+#pragma once
+
+#ifndef LIBSYMUSIC_IO_MIDI_WRITER_H
+#define LIBSYMUSIC_IO_MIDI_WRITER_H
+
+#include <cstdio>
+
+#include "symusic/io/iodef.h"
+#include "symusic/score.h"
+
+namespace symusic {
+
+/**
+ * Encode ``score`` as a Standard MIDI File and write it to ``file``.
+ *
+ * The bytes equal ``dumps<DataFormat::MIDI>(score, options)``. With ``options.num_threads == 1``
+ * only one track chunk is held in memory at a time, otherwise the whole file is encoded first.
+ * ``file`` must be open for binary writing and stays open; a failed write raises
+ * ``std::runtime_error``.
+ */
+template<TType T>
+void dump_midi(const Score<T>& score, std::FILE* file, const DumpOptions& options = {});
+
+}   // namespace symusic
+
+#endif   // LIBSYMUSIC_IO_MIDI_WRITER_H
@@ -0,0 +1,96 @@
+//
+// Read-only score files that are memory mapped and used in place.
+//
+#pragma once
+
+#ifndef LIBSYMUSIC_IO_SCORE_MAP_H
+#define LIBSYMUSIC_IO_SCORE_MAP_H
+
+#include <filesystem>
+#include <span>
+#include <string_view>
+
+#include "symusic/io/common.h"
+#include "symusic/score.h"
+
+namespace symusic {
+
+/// A text event of a ``ScoreMap``; ``text`` points into the mapping.
+template<TType T>
+struct TextView {
+    typename T::unit time;
+    std::string_view text;
+};
+
+/// One track of a ``ScoreMap``. The spans point into the mapping and share its lifetime.
+template<TType T>
+struct TrackMap {
+    std::string_view                  name;
+    u8                                program = 0;
+    bool                              is_drum = false;
+    std::span<const Note<T>>          notes;
+    std::span<const ControlChange<T>> controls;
+    std::span<const PitchBend<T>>     pitch_bends;
+    std::span<const Pedal<T>>         pedals;
+    vec<TextView<T>>                  lyrics;
+
+    /// Copy the events into a regular, mutable track.
+    [[nodiscard]] Track<T> to_track() const;
+};
+
+/**
+ * A score file written by ``dump_score_map`` and opened through a memory map.
+ *
+ * The file stores every event array as the in-memory ``Note<T>``, ``ControlChange<T>``, ...
+ * structs, aligned so they can be used straight from the mapping: opening a file only validates
+ * the header and the section table and builds the views of the (few) text events, no matter how
+ * many notes it holds. Processes mapping the same file share one copy in the page cache.
+ *
+ * The layout follows the host's struct layout and byte order, so a file is meant to be read on
+ * the platform that wrote it; a mismatch, a different time unit or a damaged section table
+ * throws ``std::runtime_error``. Event values are not validated. ``to_score()`` copies the events
+ * into a regular ``Score`` when it has to be modified.
+ */
+template<TType T>
+class ScoreMap {
+public:
+    explicit ScoreMap(const std::filesystem::path& path);
+
+    [[nodiscard]] i32    ticks_per_quarter() const { return tpq; }
+    [[nodiscard]] size_t num_tracks() const { return track_maps.size(); }
+    /// Whether the events live in a memory map rather than a buffer read from the file.
+    [[nodiscard]] bool mapped() const { return file.mapped(); }
+
+    [[nodiscard]] const vec<TrackMap<T>>& tracks() const { return track_maps; }
+    /// The track at ``index``; throws ``std::out_of_range`` past the last track.
+    [[nodiscard]] const TrackMap<T>& track(size_t index) const;
+
+    [[nodiscard]] std::span<const TimeSignature<T>> time_signatures() const { return time_sigs; }
+    [[nodiscard]] std::span<const KeySignature<T>>  key_signatures() const { return key_sigs; }
+    [[nodiscard]] std::span<const Tempo<T>>         tempos() const { return tempo_events; }
+    [[nodiscard]] const vec<TextView<T>>&           markers() const { return marker_views; }
+
+    /// Copy every event into a regular, mutable score.
+    [[nodiscard]] Score<T> to_score() const;
+
+private:
+    MappedFile                        file;
+    i32                               tpq = 0;
+    vec<TrackMap<T>>                  track_maps;
+    std::span<const TimeSignature<T>> time_sigs;
+    std::span<const KeySignature<T>>  key_sigs;
+    std::span<const Tempo<T>>         tempo_events;
+    vec<TextView<T>>                  marker_views;
+};
+
+/// Serialize ``score`` in the layout read by ``ScoreMap``.
+template<TType T>
+[[nodiscard]] vec<u8> dumps_score_map(const Score<T>& score);
+
+/// Write ``score`` to ``path`` in the layout read by ``ScoreMap``.
+template<TType T>
+void dump_score_map(const Score<T>& score, const std::filesystem::path& path);
+
+}   // namespace symusic
+
+#endif   // LIBSYMUSIC_IO_SCORE_MAP_H
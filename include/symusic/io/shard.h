@@ -0,0 +1,113 @@
+//
+// Shard files that pack many serialized scores behind an index, for random-access datasets.
+//
+#pragma once
+
+#ifndef LIBSYMUSIC_IO_SHARD_H
+#define LIBSYMUSIC_IO_SHARD_H
+
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "symusic/io/batch.h"
+#include "symusic/score.h"
+
+namespace symusic {
+
+/// Index entry of one score in a shard. ``duration`` is ``Score::end()`` in the stored time unit.
+struct ShardEntry {
+    std::string key;
+    u64         offset     = 0;
+    u64         length     = 0;
+    u64         note_count = 0;
+    f64         duration   = 0;
+};
+
+/**
+ * Writes scores of one time unit into a shard file.
+ *
+ * Every ``add`` appends the ZPP encoding of the score to the file; ``close`` then appends the
+ * index of (key, offset, length, note count, duration) entries as a footer. Keys must be unique
+ * within a shard. The destructor closes a shard that was not closed explicitly, but swallows any
+ * error, so call ``close`` to find out whether the index was written.
+ */
+template<TType T>
+class ShardWriter {
+public:
+    explicit ShardWriter(const std::filesystem::path& path);
+    ShardWriter(ShardWriter&&) noexcept;
+    ShardWriter& operator=(ShardWriter&&) noexcept;
+    ~ShardWriter();
+
+    /// Append ``score`` under ``key`` and return its index; throws on a duplicate key.
+    size_t add(std::string key, const Score<T>& score);
+
+    /// Write the index and close the file. Further calls to ``add`` throw.
+    void close();
+
+    /// Number of scores added so far.
+    [[nodiscard]] size_t size() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl;
+};
+
+/**
+ * Random access to the scores of a shard file written by ``ShardWriter``.
+ *
+ * Opening reads only the footer index. Every score is then loaded with a single positioned read
+ * of its bytes, without reopening or seeking the file, so the reader can be shared by threads
+ * and is cheap to use from a ``Dataset.__getitem__``. A shard written in another time unit is
+ * converted on load. A damaged index throws ``std::runtime_error`` when opening, a damaged score
+ * when it is loaded.
+ */
+template<TType T>
+class ShardReader {
+public:
+    explicit ShardReader(const std::filesystem::path& path);
+    ShardReader(ShardReader&&) noexcept;
+    ShardReader& operator=(ShardReader&&) noexcept;
+    ~ShardReader();
+
+    /// Number of scores in the shard.
+    [[nodiscard]] size_t size() const;
+
+    [[nodiscard]] const vec<ShardEntry>& entries() const;
+
+    /// The entry at ``index``; throws ``std::out_of_range`` past the last score.
+    [[nodiscard]] const ShardEntry& entry(size_t index) const;
+
+    /// Index of the score stored under ``key``, if any.
+    [[nodiscard]] std::optional<size_t> find(std::string_view key) const;
+
+    /// The serialized bytes of the score at ``index``.
+    [[nodiscard]] vec<u8> read_bytes(size_t index) const;
+
+    /// Load the score at ``index``; throws ``std::out_of_range`` past the last score.
+    [[nodiscard]] Score<T> get(size_t index) const;
+
+    /// Load the score stored under ``key``; throws ``std::out_of_range`` for an unknown key.
+    [[nodiscard]] Score<T> get(std::string_view key) const;
+
+    /**
+     * Load the scores at ``indices`` on ``num_threads`` workers (``0`` uses every hardware
+     * thread), returning the results in input order. A score that fails to load yields its error
+     * instead of aborting the batch; an index past the last score is an error of that item.
+     */
+    [[nodiscard]] vec<LoadResult<Score<T>>> get_many(
+        std::span<const size_t> indices, size_t num_threads = 0
+    ) const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl;
+};
+
+}   // namespace symusic
+
+#endif   // LIBSYMUSIC_IO_SHARD_H
@@ -0,0 +1,79 @@
+//
+// Non-throwing MIDI parsing with structured diagnostics for corrupted files.
+//
+#pragma once
+
+#ifndef LIBSYMUSIC_IO_TRY_PARSE_H
+#define LIBSYMUSIC_IO_TRY_PARSE_H
+
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+
+#include "symusic/io/iodef.h"
+#include "symusic/score.h"
+
+namespace symusic {
+
+enum class ParseErrorCode : u8 {
+    None = 0,
+    IoError,           // the file could not be read
+    InvalidHeader,     // missing or malformed MThd chunk
+    TruncatedChunk,    // an MTrk chunk extends past the end of the data
+    InvalidMessage,    // bad status byte, missing running status or a message cut off by its chunk
+    InvalidDataByte,   // a data byte above 0x7F while ``sanitize_data`` is off
+    Other,             // rejected by the decoder for a reason the diagnostics pass did not find
+};
+
+/// Name of ``code`` in snake case, e.g. ``"invalid_data_byte"``.
+[[nodiscard]] const char* to_string(ParseErrorCode code);
+
+/**
+ * Where and why a MIDI file was rejected. ``offset`` is the absolute position of the offending
+ * byte (or of the chunk header for truncated chunks), ``track`` the index of the MTrk chunk that
+ * holds it, or ``-1`` when the error is outside any chunk.
+ */
+struct ParseError {
+    ParseErrorCode code   = ParseErrorCode::None;
+    size_t         offset = 0;
+    i32            track  = -1;
+    std::string    message;
+};
+
+/**
+ * Outcome of ``try_parse_midi``. ``value`` is set on success; otherwise ``error`` describes the
+ * failure and ``partial`` optionally holds every event decoded before the offending message.
+ */
+template<typename T>
+struct ParseResult {
+    std::optional<T> value;
+    ParseError       error;
+    std::optional<T> partial;
+
+    [[nodiscard]] bool ok() const { return value.has_value(); }
+};
+
+/**
+ * Parse MIDI bytes without letting any exception escape.
+ *
+ * Valid files go through the regular decoder and cost nothing extra. When decoding fails, a
+ * diagnostics pass walks the raw bytes to locate the first offending byte under the same rules
+ * (``sanitize_data`` and the projection flags of ``options``). With ``want_partial``, the chunks
+ * before the failing one and the valid prefix of the failing chunk are decoded into
+ * ``ParseResult::partial``.
+ */
+template<TType T>
+[[nodiscard]] ParseResult<Score<T>> try_parse_midi(
+    std::span<const u8> bytes, const ParseOptions& options = {}, bool want_partial = false
+);
+
+/// Read ``path`` and parse it, see ``try_parse_midi(std::span<const u8>, ...)``.
+template<TType T>
+[[nodiscard]] ParseResult<Score<T>> try_parse_midi(
+    const std::filesystem::path& path, const ParseOptions& options = {}, bool want_partial = false
+);
+
+}   // namespace symusic
+
+#endif   // LIBSYMUSIC_IO_TRY_PARSE_H
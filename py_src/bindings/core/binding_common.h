@@ -4,6 +4,9 @@
 
 #pragma once
 
+#include <optional>
+#include <stdexcept>
+#include <string>
 #include <utility>
 
 #include "symusic.h"
@@ -22,4 +25,46 @@ inline std::pair<u8, u8> validate_pitch_range(const std::pair<i64, i64>& range)
     return {static_cast<u8>(range.first), static_cast<u8>(range.second)};
 }
 
+/**
+ * Build parse options from the Python keyword arguments. ``keep`` names the event classes to
+ * decode (``None`` keeps everything); unknown names raise ``ValueError``.
+ */
+inline ParseOptions make_parse_options(
+    const bool sanitize_data, const size_t num_threads, const std::optional<vec<std::string>>& keep
+) {
+    ParseOptions options{.sanitize_data = sanitize_data, .num_threads = num_threads};
+    if (!keep.has_value()) return options;
+
+    options.keep_notes = options.keep_controls = options.keep_pitch_bends = options.keep_pedals
+        = options.keep_lyrics = options.keep_tempos = options.keep_time_signatures
+        = options.keep_key_signatures = options.keep_markers = false;
+    for (const auto& name : *keep) {
+        if (name == "notes") options.keep_notes = true;
+        else if (name == "controls") options.keep_controls = true;
+        else if (name == "pitch_bends") options.keep_pitch_bends = true;
+        else if (name == "pedals") options.keep_pedals = true;
+        else if (name == "lyrics") options.keep_lyrics = true;
+        else if (name == "tempos") options.keep_tempos = true;
+        else if (name == "time_signatures") options.keep_time_signatures = true;
+        else if (name == "key_signatures") options.keep_key_signatures = true;
+        else if (name == "markers") options.keep_markers = true;
+        else throw std::invalid_argument("Unknown event class in keep: " + name);
+    }
+    return options;
+}
+
+/**
+ * Build the parse window from the Python keyword arguments; ``window`` is ``(start, end)`` in the
+ * time unit of the score, ``None`` decodes the whole file.
+ */
+inline std::optional<ParseWindow> make_parse_window(
+    const std::optional<std::pair<f64, f64>>& window,
+    const f64                                 min_overlap,
+    const std::string&                        start_mode,
+    const std::string&                        end_mode
+) {
+    if (!window.has_value()) return std::nullopt;
+    return ParseWindow{window->first, window->second, min_overlap, start_mode, end_mode};
+}
+
 }   // namespace symusic
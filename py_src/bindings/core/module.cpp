@@ -13,6 +13,7 @@
 #include "../../utils/python_helpers.h"
 #include "binding_registration.h"
 #include "../synth/synthesizer_bindings.h"
+#include "../io/io_bindings.h"
 
 #pragma warning(disable : 4996)
 
@@ -143,6 +144,7 @@ NB_MODULE(core, m) {
     bind_track_types(m);
     bind_score_types(m);
     bind_synthesizer(m);
+    bind_io(m);
 }
 
 }   // namespace symusic
@@ -246,6 +246,10 @@ constexpr const char* kNeDoc
 constexpr const char* kGetStateDoc
     = R"pbdoc(Serialize the event into ZPP bytes for pickling.)pbdoc";
 constexpr const char* kSetStateDoc = R"pbdoc(Rehydrate the event from pickled ZPP bytes.)pbdoc";
+constexpr const char* kVecReduceExDoc = R"pbdoc(
+Reduce the list for pickling; with protocol 5 or later its ZPP state is a ``PickleBuffer`` that
+pickle can hand to a ``buffer_callback`` instead of copying it.
+)pbdoc";
 constexpr const char* kUseCountDoc
     = R"pbdoc(Return the reference count of the underlying shared pointer. Helpful for debugging aliasing.)pbdoc";
 
@@ -406,9 +410,21 @@ auto bind_time_stamp(
         )
         .def(
             "__setstate__",
-            [](vec_t& self, const nb::bytes& bytes) { vec_from_bytes<T>(self, bytes); },
+            [](vec_t& self, const nb::handle state) { vec_from_bytes<T>(self, state); },
             event_docstrings::kSetStateDoc,
-            nb::sig(fmt::format("def __setstate__(self, state: bytes, /) -> {}", list_name).c_str())
+            nb::sig(fmt::format(
+                "def __setstate__(self, state: bytes | memoryview, /) -> {}", list_name
+            ).c_str())
+        )
+        .def(
+            "__reduce_ex__",
+            [](const nb::handle self, const int protocol) {
+                const auto& events = *nb::cast<const vec_t&>(self);
+                return reduce_ex(self, dumps<DataFormat::ZPP>(events.collect()), protocol);
+            },
+            nb::arg("protocol"),
+            event_docstrings::kVecReduceExDoc,
+            nb::sig("def __reduce_ex__(self, protocol: int, /) -> tuple[object, ...]")
         )
         .def("__repr__", [](const vec_t& self) { return fmt::format("{::s}", *self); })
         .def(
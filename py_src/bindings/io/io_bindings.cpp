@@ -0,0 +1,834 @@
+//
+// Implementation of the corpus-scale I/O bindings.
+//
+
+#include "../core/binding_prelude.h"
+#include "io_bindings.h"
+
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+
+#include <fmt/format.h>
+#include <nanobind/ndarray.h>
+#include <nanobind/stl/filesystem.h>
+
+#include "symusic.h"
+#include "../core/binding_common.h"
+
+namespace nb = nanobind;
+
+namespace symusic {
+
+namespace io_docstrings {
+constexpr const char* kLoadManyDoc = R"pbdoc(
+Read and parse many MIDI files on a native thread pool with the GIL released. Returns a pair
+``(scores, errors)`` of lists aligned with ``paths``: a failed file yields ``None`` in ``scores``
+and its error message in ``errors``, so one corrupted file never aborts the batch.
+``num_threads=0`` uses every hardware thread. ``keep`` restricts decoding to the listed event
+classes, as in ``Score.from_file``.
+)pbdoc";
+constexpr const char* kDumpManyDoc = R"pbdoc(
+Encode many scores of one time unit as MIDI and write each to the path at the same position, on a
+native thread pool with the GIL released. Returns a list aligned with ``paths`` holding ``None``
+for every written file and the error message for every failed one. ``num_threads=0`` uses every
+hardware thread. ``running_status``, ``compact`` and ``format`` behave like in
+``Score.dump_midi``.
+)pbdoc";
+constexpr const char* kMidiInfoDoc = R"pbdoc(
+Summary statistics of a MIDI file gathered in one pass over its messages without building a score.
+Counts follow a full tick parse: ``note_num`` and ``end_tick`` match ``Score.note_num()`` and
+``Score.end()``, ``num_tracks`` matches ``len(Score.tracks)`` and ``fingerprint`` matches
+``Score.fingerprint()``.
+)pbdoc";
+constexpr const char* kMidiInfoFromFileDoc = R"pbdoc(
+Read and scan a MIDI file with the GIL released. Invalid payload bytes raise the same errors as
+``Score.from_file`` unless ``sanitize_data`` is ``True``.
+)pbdoc";
+constexpr const char* kMidiInfoFromMidiDoc = R"pbdoc(
+Scan raw MIDI bytes, see ``MidiInfo.from_file``.
+)pbdoc";
+constexpr const char* kParseErrorDoc = R"pbdoc(
+Why a MIDI file was rejected, as returned by ``Score.try_from_file``. ``code`` is one of
+``"io_error"``, ``"invalid_header"``, ``"truncated_chunk"``, ``"invalid_message"``,
+``"invalid_data_byte"`` or ``"other"``; ``offset`` is the byte position of the problem and
+``track`` the index of the MTrk chunk holding it (``-1`` outside any chunk).
+)pbdoc";
+constexpr const char* kLazyScoreDoc = R"pbdoc(
+A MIDI file whose MTrk chunks are decoded on first access. Opening it only decodes the header and
+the conductor (first) chunk. ``lazy[i]`` returns the tracks of chunk ``i`` (one chunk may hold
+several channels/programs) and caches them; ``to_score()`` decodes the rest and returns the same
+score as ``Score.from_file`` with the same options. Meta event properties only cover the conductor.
+)pbdoc";
+constexpr const char* kMidiStreamParserDoc = R"pbdoc(
+Incremental MIDI parser for bytes that arrive in pieces. ``feed`` decodes every MTrk chunk
+completed by the new bytes (with the GIL released) and returns the tracks decoded from them;
+``finish`` returns the same score as ``Score.from_midi`` on the concatenated input.
+)pbdoc";
+constexpr const char* kCorpusReaderDoc = R"pbdoc(
+Iterator over the MIDI files of a corpus that reads files ahead on dedicated I/O threads and parses
+them on a native worker pool. Each step waits (with the GIL released) for the next file in input
+order and yields ``(path, score, error)``: ``score`` is ``None`` and ``error`` holds the message
+for a file that could not be read or parsed.
+)pbdoc";
+constexpr const char* kCorpusReaderFactoryDoc = R"pbdoc(
+Create a ``CorpusReader`` over ``paths``. ``num_threads`` parsing workers (``0`` uses every
+hardware thread) and ``io_threads`` readers run until ``prefetch`` files are in flight (``0``
+picks four per worker). ``keep`` restricts decoding to the listed event classes, as in
+``Score.from_file``.
+)pbdoc";
+constexpr const char* kArchiveReaderDoc = R"pbdoc(
+Iterator over the MIDI members of a tar, tar.gz or zip archive, parsed without extracting it. The
+archive is read front to back on a native thread while members are decompressed and parsed on a
+worker pool. Each step waits (with the GIL released) for the next member in archive order and
+yields ``(name, score, error)``; ``score`` is ``None`` and ``error`` holds the message for a member
+that could not be decompressed or parsed. Damage to the archive itself raises ``RuntimeError``.
+)pbdoc";
+constexpr const char* kArchiveReaderFactoryDoc = R"pbdoc(
+Create an ``ArchiveReader`` over the archive at ``path``. Only members whose name ends with one of
+``suffixes`` (case-insensitive; empty selects every member) are parsed. ``num_threads`` workers
+(``0`` uses every hardware thread) run until ``prefetch`` members are in flight (``0`` picks four
+per worker). ``keep`` restricts decoding to the listed event classes, as in ``Score.from_file``.
+)pbdoc";
+constexpr const char* kScoreMapDoc = R"pbdoc(
+A read-only score file written by ``Score.dump_score_map`` and opened through a memory map. Opening
+only validates the section table, so it takes the same time for any number of notes, and worker
+processes mapping the same file share one copy in the page cache. Event arrays are returned as
+read-only NumPy views into the mapping; ``to_score`` copies everything into a mutable ``Score``.
+)pbdoc";
+constexpr const char* kTrackMapDoc = R"pbdoc(
+One track of a ``ScoreMap``. The event arrays are read-only NumPy views into the mapping, which
+stays open as long as any of them is alive; ``to_track`` copies the track into a mutable ``Track``.
+)pbdoc";
+constexpr const char* kOpenScoreMapDoc = R"pbdoc(
+Memory map the score file at ``path``. ``ttype`` must match the time unit the file was written in.
+)pbdoc";
+constexpr const char* kShardEntryDoc = R"pbdoc(
+Index entry of one score in a shard: its key, byte range, note count and ``Score.end()`` in the
+time unit the shard was written in.
+)pbdoc";
+constexpr const char* kShardWriterDoc = R"pbdoc(
+Writes scores of one time unit into a shard file: each ``add`` appends the ZPP encoding of a
+score, and ``close`` (or leaving a ``with`` block) appends the index. Keys must be unique.
+)pbdoc";
+constexpr const char* kShardReaderDoc = R"pbdoc(
+Random access to the scores of a shard file. Opening reads only the index; indexing by position or
+key then loads one score with a single positioned read, with the GIL released. ``load_many`` loads
+many scores on a native thread pool. A shard written in another time unit is converted on load.
+)pbdoc";
+constexpr const char* kShardWriterFactoryDoc = R"pbdoc(
+Create a ``ShardWriter`` for scores of the given time unit, truncating the file at ``path``.
+)pbdoc";
+constexpr const char* kShardReaderFactoryDoc = R"pbdoc(
+Open the shard file at ``path`` and return a ``ShardReader`` loading scores in the given time unit.
+)pbdoc";
+constexpr const char* kShardLoadManyDoc = R"pbdoc(
+Load the scores at ``indices`` (every score when ``None``) on ``num_threads`` workers (``0`` uses
+every hardware thread). Returns aligned ``(scores, errors)`` lists like ``symusic.load_many``.
+)pbdoc";
+constexpr const char* kStreamParserDoc = R"pbdoc(
+Create a ``MidiStreamParser`` for the given time unit. ``keep`` restricts decoding to the listed
+event classes, as in ``Score.from_file``.
+)pbdoc";
+}   // namespace io_docstrings
+
+namespace {
+
+/// Call ``func`` with a default-constructed time unit selected by a Python ttype object/string.
+template<typename Func>
+auto visit_ttype(const nb::object& ttype, Func&& func) {
+    if (nb::isinstance<Tick>(ttype)) return func(Tick{});
+    if (nb::isinstance<Quarter>(ttype)) return func(Quarter{});
+    if (nb::isinstance<Second>(ttype)) return func(Second{});
+    if (nb::isinstance<nb::str>(ttype)) {
+        const auto ttype_str = nb::cast<std::string>(ttype.attr("lower")());
+        if (ttype_str == "tick") return func(Tick{});
+        if (ttype_str == "quarter") return func(Quarter{});
+        if (ttype_str == "second") return func(Second{});
+    }
+    throw std::invalid_argument("ttype must be Tick, Quarter, Second or string");
+}
+
+/// Split batch results into aligned ``(scores, errors)`` lists.
+template<TType T>
+nb::tuple to_result_lists(vec<LoadResult<Score<T>>>& results) {
+    nb::list scores, errors;
+    for (auto& result : results) {
+        if (result.ok()) {
+            scores.append(nb::cast(
+                std::make_shared<Score<T>>(std::move(*result.value)), nb::rv_policy::copy
+            ));
+            errors.append(nb::none());
+        } else {
+            scores.append(nb::none());
+            errors.append(nb::str(result.error.c_str(), result.error.size()));
+        }
+    }
+    return nb::make_tuple(scores, errors);
+}
+
+template<TType T>
+nb::tuple load_many(const vec<std::filesystem::path>& paths, const ParseOptions& options) {
+    vec<LoadResult<Score<T>>> results;
+    {
+        nb::gil_scoped_release release;
+        results = parse_many<DataFormat::MIDI, Score<T>>(paths, options);
+    }
+    return to_result_lists(results);
+}
+
+template<TType T>
+nb::list dump_many(
+    const vec<shared<Score<T>>>&      scores,
+    const vec<std::filesystem::path>& paths,
+    const size_t                      num_threads,
+    const bool                        running_status,
+    const bool                        compact,
+    const u8                          format
+) {
+    vec<const Score<T>*> items;
+    items.reserve(scores.size());
+    for (const auto& score : scores) { items.push_back(score.get()); }
+    const DumpOptions options{
+        .running_status = running_status,
+        .num_threads    = num_threads,
+        .compact        = compact,
+        .format         = format,
+    };
+
+    vec<std::string> results;
+    {
+        nb::gil_scoped_release release;
+        results = symusic::dump_many<DataFormat::MIDI, Score<T>>(items, paths, options);
+    }
+    nb::list errors;
+    for (const auto& error : results) {
+        if (error.empty()) {
+            errors.append(nb::none());
+        } else {
+            errors.append(nb::str(error.c_str(), error.size()));
+        }
+    }
+    return errors;
+}
+
+void bind_midi_info(nb::module_& m) {
+    nb::class_<MidiInfo>(m, "MidiInfo", io_docstrings::kMidiInfoDoc)
+        .def_static(
+            "from_file",
+            [](const std::filesystem::path& path, const bool sanitize_data) {
+                nb::gil_scoped_release release;
+                return scan_midi(path, sanitize_data);
+            },
+            nb::arg("path"),
+            nb::arg("sanitize_data") = false,
+            io_docstrings::kMidiInfoFromFileDoc
+        )
+        .def_static(
+            "from_midi",
+            [](const nb::bytes& data, const bool sanitize_data) {
+                const auto span = std::span(reinterpret_cast<const u8*>(data.c_str()), data.size());
+                nb::gil_scoped_release release;
+                return scan_midi(span, sanitize_data);
+            },
+            nb::arg("data"),
+            nb::arg("sanitize_data") = false,
+            io_docstrings::kMidiInfoFromMidiDoc
+        )
+        .def_ro("ticks_per_quarter", &MidiInfo::ticks_per_quarter)
+        .def_ro("num_midi_tracks", &MidiInfo::num_midi_tracks)
+        .def_ro("num_tracks", &MidiInfo::num_tracks)
+        .def_ro("note_num", &MidiInfo::note_num)
+        .def_ro("drum_note_num", &MidiInfo::drum_note_num)
+        .def_prop_ro(
+            "notes_per_program",
+            [](const MidiInfo& self) {
+                return vec<u64>(self.notes_per_program.begin(), self.notes_per_program.end());
+            }
+        )
+        .def_prop_ro("has_drums", &MidiInfo::has_drums)
+        .def_ro("end_tick", &MidiInfo::end_tick)
+        .def_ro("end_second", &MidiInfo::end_second)
+        .def_ro("tempo_num", &MidiInfo::tempo_num)
+        .def_ro("min_qpm", &MidiInfo::min_qpm)
+        .def_ro("max_qpm", &MidiInfo::max_qpm)
+        .def_ro("time_signature_num", &MidiInfo::time_signature_num)
+        .def_ro("numerator", &MidiInfo::numerator)
+        .def_ro("denominator", &MidiInfo::denominator)
+        .def_ro("key_signature_num", &MidiInfo::key_signature_num)
+        .def_prop_ro(
+            "fingerprint", [](const MidiInfo& self) { return self.fingerprint.hex(); }
+        )
+        .def("__eq__", [](const MidiInfo& self, const MidiInfo& other) { return self == other; })
+        .def("__eq__", [](const MidiInfo&, const nb::object&) { return false; })
+        .def("__repr__", [](const MidiInfo& self) {
+            return fmt::format(
+                "MidiInfo(tracks={}, notes={}, end_tick={}, end_second={}, drums={})",
+                self.num_tracks,
+                self.note_num,
+                self.end_tick,
+                self.end_second,
+                self.has_drums()
+            );
+        });
+}
+
+void bind_parse_error(nb::module_& m) {
+    nb::class_<ParseError>(m, "ParseError", io_docstrings::kParseErrorDoc)
+        .def_prop_ro("code", [](const ParseError& self) { return to_string(self.code); })
+        .def_ro("offset", &ParseError::offset)
+        .def_ro("track", &ParseError::track)
+        .def_ro("message", &ParseError::message)
+        .def("__repr__", [](const ParseError& self) {
+            return fmt::format(
+                "ParseError(code={}, offset={}, track={}, message='{}')",
+                to_string(self.code),
+                self.offset,
+                self.track,
+                self.message
+            );
+        });
+}
+
+template<TType T>
+void bind_lazy_score(nb::module_& m, const std::string& name_) {
+    using self_t       = LazyScore<T>;
+    using track_list_t = vec<shared<Track<T>>>;
+    const auto name    = "LazyScore" + name_;
+
+    nb::class_<self_t>(m, name.c_str(), io_docstrings::kLazyScoreDoc)
+        .def(
+            "__init__",
+            [](self_t*                                 self,
+               const std::filesystem::path&            path,
+               const bool                              sanitize_data,
+               const size_t                            num_threads,
+               const std::optional<vec<std::string>>& keep) {
+                new (self) self_t(
+                    self_t::from_file(path, make_parse_options(sanitize_data, num_threads, keep))
+                );
+            },
+            nb::arg("path"),
+            nb::arg("sanitize_data") = false,
+            nb::arg("num_threads")   = 1,
+            nb::arg("keep")          = nb::none()
+        )
+        .def_prop_ro("ticks_per_quarter", &self_t::ticks_per_quarter)
+        .def("__len__", &self_t::num_midi_tracks)
+        .def(
+            "__getitem__",
+            [](self_t& self, i64 index) {
+                const auto size = static_cast<i64>(self.num_midi_tracks());
+                if (index < 0) index += size;
+                if (index < 0 || index >= size) {
+                    throw nb::index_error("MIDI track index out of range");
+                }
+                return std::make_shared<track_list_t>(self.midi_track(static_cast<size_t>(index)));
+            },
+            nb::arg("index"),
+            "Tracks decoded from the MTrk chunk at ``index``"
+        )
+        .def("is_decoded", &self_t::is_decoded, nb::arg("index"))
+        .def_prop_ro("time_signatures", [](const self_t& self) { return self.conductor().time_signatures; })
+        .def_prop_ro("key_signatures", [](const self_t& self) { return self.conductor().key_signatures; })
+        .def_prop_ro("tempos", [](const self_t& self) { return self.conductor().tempos; })
+        .def_prop_ro("markers", [](const self_t& self) { return self.conductor().markers; })
+        .def(
+            "to_score",
+            [](self_t& self) { return std::make_shared<Score<T>>(self.to_score()); },
+            "Decode the remaining chunks and return the full score"
+        );
+}
+
+template<TType T>
+void bind_midi_stream_parser(nb::module_& m, const std::string& name_) {
+    using self_t       = MidiStreamParser<T>;
+    using track_list_t = vec<shared<Track<T>>>;
+    const auto name    = "MidiStreamParser" + name_;
+
+    nb::class_<self_t>(m, name.c_str(), io_docstrings::kMidiStreamParserDoc)
+        .def(
+            "feed",
+            [](self_t& self, const nb::bytes& data) {
+                const auto span = std::span(reinterpret_cast<const u8*>(data.c_str()), data.size());
+                nb::gil_scoped_release release;
+                self.feed(span);
+                return std::make_shared<track_list_t>(self.take_ready());
+            },
+            nb::arg("data"),
+            "Feed the next bytes and return the tracks of the MTrk chunks they complete"
+        )
+        .def_prop_ro("num_decoded", &self_t::num_decoded)
+        .def(
+            "finish",
+            [](self_t& self) { return std::make_shared<Score<T>>(self.finish()); },
+            "Check that the input is complete and return the parsed score"
+        );
+}
+
+template<TType T>
+void bind_corpus_reader(nb::module_& m, const std::string& name_) {
+    using self_t    = CorpusReader<T>;
+    const auto name = "CorpusReader" + name_;
+
+    nb::class_<self_t>(m, name.c_str(), io_docstrings::kCorpusReaderDoc)
+        .def("__len__", &self_t::size)
+        .def_prop_ro("num_consumed", &self_t::num_consumed)
+        .def("__iter__", [](nb::handle self) { return self; })
+        .def("__next__", [](self_t& self) {
+            std::optional<CorpusItem<T>> item;
+            {
+                nb::gil_scoped_release release;
+                item = self.next();
+            }
+            if (!item) { throw nb::stop_iteration(); }
+            auto& result = item->result;
+            if (!result.ok()) {
+                return nb::make_tuple(
+                    item->path, nb::none(), nb::str(result.error.c_str(), result.error.size())
+                );
+            }
+            auto score = std::make_shared<Score<T>>(std::move(*result.value));
+            return nb::make_tuple(item->path, nb::cast(score, nb::rv_policy::copy), nb::none());
+        });
+}
+
+template<TType T>
+void bind_archive_reader(nb::module_& m, const std::string& name_) {
+    using self_t    = ArchiveReader<T>;
+    const auto name = "ArchiveReader" + name_;
+
+    nb::class_<self_t>(m, name.c_str(), io_docstrings::kArchiveReaderDoc)
+        .def_prop_ro("num_consumed", &self_t::num_consumed)
+        .def("__iter__", [](nb::handle self) { return self; })
+        .def("__next__", [](self_t& self) {
+            std::optional<ArchiveItem<T>> item;
+            {
+                nb::gil_scoped_release release;
+                item = self.next();
+            }
+            if (!item) { throw nb::stop_iteration(); }
+            const nb::str name(item->name.c_str(), item->name.size());
+            auto&         result = item->result;
+            if (!result.ok()) {
+                return nb::make_tuple(
+                    name, nb::none(), nb::str(result.error.c_str(), result.error.size())
+                );
+            }
+            auto score = std::make_shared<Score<T>>(std::move(*result.value));
+            return nb::make_tuple(name, nb::cast(score, nb::rv_policy::copy), nb::none());
+        });
+}
+
+/// Add one read-only column of ``events`` to ``columns``, viewing the field in place.
+template<typename Event, typename Field, typename Base>
+void add_column(
+    nb::dict&                    columns,
+    const char*                  name,
+    const std::span<const Event> events,
+    const Field Base::*          field,
+    const nb::handle             owner
+) {
+    static_assert(sizeof(Event) % sizeof(Field) == 0);
+    const Field* data = events.empty() ? nullptr : &(events.front().*field);
+    const auto   step = static_cast<int64_t>(sizeof(Event) / sizeof(Field));
+    columns[name]     = nb::ndarray<nb::numpy, const Field>(data, {events.size()}, owner, {step});
+}
+
+template<TType T>
+nb::list text_views(const vec<TextView<T>>& views) {
+    nb::list ans;
+    for (const auto& [time, text] : views) {
+        ans.append(nb::make_tuple(time, nb::str(text.data(), text.size())));
+    }
+    return ans;
+}
+
+template<TType T>
+void bind_score_map(nb::module_& m, const std::string& name_) {
+    using self_t          = ScoreMap<T>;
+    using track_t         = TrackMap<T>;
+    const auto name       = "ScoreMap" + name_;
+    const auto track_name = "TrackMap" + name_;
+
+    nb::class_<track_t>(m, track_name.c_str(), io_docstrings::kTrackMapDoc)
+        .def_prop_ro("name", [](const track_t& self) {
+            return nb::str(self.name.data(), self.name.size());
+        })
+        .def_ro("program", &track_t::program)
+        .def_ro("is_drum", &track_t::is_drum)
+        .def("notes", [](nb::handle self) {
+            const auto& events = nb::cast<const track_t&>(self).notes;
+            nb::dict    ans;
+            add_column(ans, "time", events, &Note<T>::time, self);
+            add_column(ans, "duration", events, &Note<T>::duration, self);
+            add_column(ans, "pitch", events, &Note<T>::pitch, self);
+            add_column(ans, "velocity", events, &Note<T>::velocity, self);
+            return ans;
+        })
+        .def("controls", [](nb::handle self) {
+            const auto& events = nb::cast<const track_t&>(self).controls;
+            nb::dict    ans;
+            add_column(ans, "time", events, &ControlChange<T>::time, self);
+            add_column(ans, "number", events, &ControlChange<T>::number, self);
+            add_column(ans, "value", events, &ControlChange<T>::value, self);
+            return ans;
+        })
+        .def("pitch_bends", [](nb::handle self) {
+            const auto& events = nb::cast<const track_t&>(self).pitch_bends;
+            nb::dict    ans;
+            add_column(ans, "time", events, &PitchBend<T>::time, self);
+            add_column(ans, "value", events, &PitchBend<T>::value, self);
+            return ans;
+        })
+        .def("pedals", [](nb::handle self) {
+            const auto& events = nb::cast<const track_t&>(self).pedals;
+            nb::dict    ans;
+            add_column(ans, "time", events, &Pedal<T>::time, self);
+            add_column(ans, "duration", events, &Pedal<T>::duration, self);
+            return ans;
+        })
+        .def("lyrics", [](const track_t& self) { return text_views(self.lyrics); })
+        .def(
+            "to_track",
+            [](const track_t& self) { return std::make_shared<Track<T>>(self.to_track()); },
+            "Copy the track into a mutable Track"
+        );
+
+    nb::class_<self_t>(m, name.c_str(), io_docstrings::kScoreMapDoc)
+        .def_prop_ro("ticks_per_quarter", &self_t::ticks_per_quarter)
+        .def_prop_ro("tpq", &self_t::ticks_per_quarter)
+        .def_prop_ro("mapped", &self_t::mapped)
+        .def("__len__", &self_t::num_tracks)
+        .def(
+            "__getitem__",
+            [](const self_t& self, i64 index) -> const track_t& {
+                const auto size = static_cast<i64>(self.num_tracks());
+                if (index < 0) index += size;
+                if (index < 0 || index >= size) {
+                    throw nb::index_error("Track index out of range");
+                }
+                return self.track(static_cast<size_t>(index));
+            },
+            nb::arg("index"),
+            nb::rv_policy::reference_internal
+        )
+        .def("time_signatures", [](nb::handle self) {
+            const auto events = nb::cast<const self_t&>(self).time_signatures();
+            nb::dict   ans;
+            add_column(ans, "time", events, &TimeSignature<T>::time, self);
+            add_column(ans, "numerator", events, &TimeSignature<T>::numerator, self);
+            add_column(ans, "denominator", events, &TimeSignature<T>::denominator, self);
+            return ans;
+        })
+        .def("key_signatures", [](nb::handle self) {
+            const auto events = nb::cast<const self_t&>(self).key_signatures();
+            nb::dict   ans;
+            add_column(ans, "time", events, &KeySignature<T>::time, self);
+            add_column(ans, "key", events, &KeySignature<T>::key, self);
+            add_column(ans, "tonality", events, &KeySignature<T>::tonality, self);
+            return ans;
+        })
+        .def("tempos", [](nb::handle self) {
+            const auto events = nb::cast<const self_t&>(self).tempos();
+            nb::dict   ans;
+            add_column(ans, "time", events, &Tempo<T>::time, self);
+            add_column(ans, "mspq", events, &Tempo<T>::mspq, self);
+            return ans;
+        })
+        .def("markers", [](const self_t& self) { return text_views(self.markers()); })
+        .def(
+            "to_score",
+            [](const self_t& self) { return std::make_shared<Score<T>>(self.to_score()); },
+            "Copy every event into a mutable Score"
+        );
+}
+
+void bind_shard_entry(nb::module_& m) {
+    nb::class_<ShardEntry>(m, "ShardEntry", io_docstrings::kShardEntryDoc)
+        .def_ro("key", &ShardEntry::key)
+        .def_ro("offset", &ShardEntry::offset)
+        .def_ro("length", &ShardEntry::length)
+        .def_ro("note_count", &ShardEntry::note_count)
+        .def_ro("duration", &ShardEntry::duration)
+        .def("__repr__", [](const ShardEntry& self) {
+            return fmt::format(
+                "ShardEntry(key='{}', offset={}, length={}, note_count={}, duration={})",
+                self.key,
+                self.offset,
+                self.length,
+                self.note_count,
+                self.duration
+            );
+        });
+}
+
+template<TType T>
+void bind_shard_writer(nb::module_& m, const std::string& name_) {
+    using self_t    = ShardWriter<T>;
+    const auto name = "ShardWriter" + name_;
+
+    nb::class_<self_t>(m, name.c_str(), io_docstrings::kShardWriterDoc)
+        .def(
+            "add",
+            [](self_t& self, std::string key, const shared<Score<T>>& score) {
+                nb::gil_scoped_release release;
+                return self.add(std::move(key), *score);
+            },
+            nb::arg("key"),
+            nb::arg("score"),
+            "Append ``score`` under ``key`` and return its index"
+        )
+        .def("close", &self_t::close, "Write the index and close the file")
+        .def("__len__", &self_t::size)
+        .def("__enter__", [](nb::handle self) { return self; })
+        .def(
+            "__exit__",
+            [](self_t& self, const nb::handle&, const nb::handle&, const nb::handle&) {
+                self.close();
+            },
+            nb::arg("exc_type").none(),
+            nb::arg("exc_value").none(),
+            nb::arg("traceback").none()
+        );
+}
+
+template<TType T>
+void bind_shard_reader(nb::module_& m, const std::string& name_) {
+    using self_t    = ShardReader<T>;
+    const auto name = "ShardReader" + name_;
+
+    nb::class_<self_t>(m, name.c_str(), io_docstrings::kShardReaderDoc)
+        .def("__len__", &self_t::size)
+        .def(
+            "__getitem__",
+            [](const self_t& self, i64 index) {
+                const auto size = static_cast<i64>(self.size());
+                if (index < 0) index += size;
+                if (index < 0 || index >= size) throw nb::index_error("Shard index out of range");
+                nb::gil_scoped_release release;
+                return std::make_shared<Score<T>>(self.get(static_cast<size_t>(index)));
+            },
+            nb::arg("index")
+        )
+        .def(
+            "__getitem__",
+            [](const self_t& self, const std::string& key) {
+                const auto index = self.find(key);
+                if (!index) throw nb::key_error(key.c_str());
+                nb::gil_scoped_release release;
+                return std::make_shared<Score<T>>(self.get(*index));
+            },
+            nb::arg("key")
+        )
+        .def(
+            "__contains__",
+            [](const self_t& self, const std::string& key) { return self.find(key).has_value(); },
+            nb::arg("key")
+        )
+        .def(
+            "index",
+            [](const self_t& self, const std::string& key) {
+                const auto index = self.find(key);
+                if (!index) throw nb::key_error(key.c_str());
+                return *index;
+            },
+            nb::arg("key"),
+            "Position of the score stored under ``key``"
+        )
+        .def("entry", &self_t::entry, nb::arg("index"), nb::rv_policy::copy)
+        .def_prop_ro("entries", &self_t::entries, nb::rv_policy::copy)
+        .def(
+            "load_many",
+            [](const self_t&                    self,
+               const std::optional<vec<size_t>>& indices,
+               const size_t                      num_threads) {
+                vec<size_t> selected;
+                if (indices) {
+                    selected = *indices;
+                } else {
+                    selected.resize(self.size());
+                    for (size_t i = 0; i < selected.size(); ++i) selected[i] = i;
+                }
+                vec<LoadResult<Score<T>>> results;
+                {
+                    nb::gil_scoped_release release;
+                    results = self.get_many(selected, num_threads);
+                }
+                return to_result_lists(results);
+            },
+            nb::arg("indices")     = nb::none(),
+            nb::arg("num_threads") = 0,
+            io_docstrings::kShardLoadManyDoc
+        );
+}
+
+}   // namespace
+
+nb::module_& bind_io(nb::module_& m) {
+    bind_midi_info(m);
+    bind_parse_error(m);
+    bind_lazy_score<Tick>(m, "Tick");
+    bind_lazy_score<Quarter>(m, "Quarter");
+    bind_lazy_score<Second>(m, "Second");
+    bind_midi_stream_parser<Tick>(m, "Tick");
+    bind_midi_stream_parser<Quarter>(m, "Quarter");
+    bind_midi_stream_parser<Second>(m, "Second");
+    bind_corpus_reader<Tick>(m, "Tick");
+    bind_corpus_reader<Quarter>(m, "Quarter");
+    bind_corpus_reader<Second>(m, "Second");
+    bind_archive_reader<Tick>(m, "Tick");
+    bind_archive_reader<Quarter>(m, "Quarter");
+    bind_archive_reader<Second>(m, "Second");
+    bind_score_map<Tick>(m, "Tick");
+    bind_score_map<Quarter>(m, "Quarter");
+    bind_score_map<Second>(m, "Second");
+    bind_shard_entry(m);
+    bind_shard_writer<Tick>(m, "Tick");
+    bind_shard_writer<Quarter>(m, "Quarter");
+    bind_shard_writer<Second>(m, "Second");
+    bind_shard_reader<Tick>(m, "Tick");
+    bind_shard_reader<Quarter>(m, "Quarter");
+    bind_shard_reader<Second>(m, "Second");
+    m.def(
+        "stream_parser",
+        [](const nb::object&                       ttype,
+           const bool                              sanitize_data,
+           const std::optional<vec<std::string>>& keep) {
+            const ParseOptions options = make_parse_options(sanitize_data, 1, keep);
+            return visit_ttype(ttype, [&]<TType T>(T) {
+                return nb::cast(MidiStreamParser<T>(options), nb::rv_policy::move);
+            });
+        },
+        nb::arg("ttype")         = "tick",
+        nb::arg("sanitize_data") = false,
+        nb::arg("keep")          = nb::none(),
+        io_docstrings::kStreamParserDoc
+    );
+    m.def(
+        "corpus_reader",
+        [](const vec<std::filesystem::path>&     paths,
+           const nb::object&                       ttype,
+           const size_t                            num_threads,
+           const size_t                            io_threads,
+           const size_t                            prefetch,
+           const bool                              sanitize_data,
+           const std::optional<vec<std::string>>& keep) {
+            const CorpusOptions options{
+                .parse      = make_parse_options(sanitize_data, num_threads, keep),
+                .io_threads = io_threads,
+                .prefetch   = prefetch,
+            };
+            return visit_ttype(ttype, [&]<TType T>(T) {
+                return nb::cast(CorpusReader<T>(paths, options), nb::rv_policy::move);
+            });
+        },
+        nb::arg("paths"),
+        nb::arg("ttype")         = "tick",
+        nb::arg("num_threads")   = 0,
+        nb::arg("io_threads")    = 1,
+        nb::arg("prefetch")      = 0,
+        nb::arg("sanitize_data") = false,
+        nb::arg("keep")          = nb::none(),
+        io_docstrings::kCorpusReaderFactoryDoc
+    );
+    m.def(
+        "archive_reader",
+        [](const std::filesystem::path&         path,
+           const nb::object&                       ttype,
+           const size_t                            num_threads,
+           const size_t                            prefetch,
+           const vec<std::string>&                 suffixes,
+           const bool                              sanitize_data,
+           const std::optional<vec<std::string>>& keep) {
+            const ArchiveOptions options{
+                .parse    = make_parse_options(sanitize_data, num_threads, keep),
+                .prefetch = prefetch,
+                .suffixes = suffixes,
+            };
+            return visit_ttype(ttype, [&]<TType T>(T) {
+                return nb::cast(ArchiveReader<T>(path, options), nb::rv_policy::move);
+            });
+        },
+        nb::arg("path"),
+        nb::arg("ttype")         = "tick",
+        nb::arg("num_threads")   = 0,
+        nb::arg("prefetch")      = 0,
+        nb::arg("suffixes")      = vec<std::string>{".mid", ".midi"},
+        nb::arg("sanitize_data") = false,
+        nb::arg("keep")          = nb::none(),
+        io_docstrings::kArchiveReaderFactoryDoc
+    );
+    m.def(
+        "open_score_map",
+        [](const std::filesystem::path& path, const nb::object& ttype) {
+            return visit_ttype(ttype, [&]<TType T>(T) {
+                return nb::cast(std::make_shared<ScoreMap<T>>(path));
+            });
+        },
+        nb::arg("path"),
+        nb::arg("ttype") = "tick",
+        io_docstrings::kOpenScoreMapDoc
+    );
+    m.def(
+        "shard_writer",
+        [](const std::filesystem::path& path, const nb::object& ttype) {
+            return visit_ttype(ttype, [&]<TType T>(T) {
+                return nb::cast(ShardWriter<T>(path), nb::rv_policy::move);
+            });
+        },
+        nb::arg("path"),
+        nb::arg("ttype") = "tick",
+        io_docstrings::kShardWriterFactoryDoc
+    );
+    m.def(
+        "shard_reader",
+        [](const std::filesystem::path& path, const nb::object& ttype) {
+            return visit_ttype(ttype, [&]<TType T>(T) {
+                return nb::cast(ShardReader<T>(path), nb::rv_policy::move);
+            });
+        },
+        nb::arg("path"),
+        nb::arg("ttype") = "tick",
+        io_docstrings::kShardReaderFactoryDoc
+    );
+    m.def(
+        "load_many",
+        [](const vec<std::filesystem::path>&     paths,
+           const nb::object&                       ttype,
+           const size_t                            num_threads,
+           const bool                              sanitize_data,
+           const std::optional<vec<std::string>>& keep) {
+            const ParseOptions options = make_parse_options(sanitize_data, num_threads, keep);
+            return visit_ttype(ttype, [&]<TType T>(T) { return load_many<T>(paths, options); });
+        },
+        nb::arg("paths"),
+        nb::arg("ttype")         = "tick",
+        nb::arg("num_threads")   = 0,
+        nb::arg("sanitize_data") = false,
+        nb::arg("keep")          = nb::none(),
+        io_docstrings::kLoadManyDoc
+    );
+    // one overload per time unit, a list mixing units matches none of them
+    const auto bind_dump_many = [&]<TType T>(T) {
+        m.def(
+            "dump_many",
+            &dump_many<T>,
+            nb::arg("scores"),
+            nb::arg("paths"),
+            nb::arg("num_threads")    = 0,
+            nb::arg("running_status") = false,
+            nb::arg("compact")        = false,
+            nb::arg("format")         = 1,
+            io_docstrings::kDumpManyDoc
+        );
+    };
+    bind_dump_many(Tick{});
+    bind_dump_many(Quarter{});
+    bind_dump_many(Second{});
+    return m;
+}
+
+}   // namespace symusic
@@ -0,0 +1,13 @@
+//
+// Bindings for corpus-scale I/O helpers (batch loading and friends).
+//
+
+#pragma once
+
+#include <nanobind/nanobind.h>
+
+namespace symusic {
+
+nanobind::module_& bind_io(nanobind::module_& m);
+
+}   // namespace symusic
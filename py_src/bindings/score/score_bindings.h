@@ -83,21 +83,64 @@ Load a MIDI file from disk into a score. Accepts strings or ``pathlib.Path`` obj
 ``.mid``/``.midi`` file.
 )pbdoc";
 constexpr const char* kScoreFromFileDoc = R"pbdoc(
-Read a score from disk by auto-detecting a MIDI or ABC file. Use ``format`` (``"midi"`` or
-``"abc"``) when the extension is ambiguous.
+Read a score from disk by auto-detecting a MIDI, ABC or columnar (``.symc``) file. Use ``format``
+(``"midi"``, ``"abc"`` or ``"columnar"``) when the extension is ambiguous. ``num_threads`` decodes
+MIDI track chunks in parallel (``0`` uses every hardware thread). ``keep`` lists the MIDI event
+classes to decode (``"notes"``, ``"controls"``, ``"pitch_bends"``, ``"pedals"``, ``"lyrics"``,
+``"tempos"``, ``"time_signatures"``, ``"key_signatures"``, ``"markers"``); other classes are
+skipped and tracks left empty are dropped.
+``window=(start, end)`` decodes only that time range, in the unit of the score; events are kept
+like ``trim(start, end, min_overlap, start_mode, end_mode)`` would keep them, but each track chunk
+stops decoding once it passes ``end``.
 )pbdoc";
 constexpr const char* kScoreFromMidiDoc = R"pbdoc(
 Parse raw MIDI bytes into a score. When ``sanitize_data`` is ``True``, controller/pitch values are
-clamped into the MIDI-safe range.
+clamped into the MIDI-safe range. ``num_threads`` decodes track chunks in parallel; the result is
+identical to the sequential parse. ``keep`` restricts decoding to the listed event classes and
+``window`` to a time range, as in ``from_file``.
+)pbdoc";
+constexpr const char* kScoreTryFromFileDoc = R"pbdoc(
+Read and parse a MIDI file without raising on corrupted data. Returns ``(score, error)``: on success
+``error`` is ``None``; otherwise ``error`` is a ``ParseError`` with the error code, byte offset and
+MTrk chunk index, and ``score`` is ``None`` or, with ``partial=True``, the events decoded before
+the offending message.
+)pbdoc";
+constexpr const char* kScoreTryFromMidiDoc = R"pbdoc(
+Parse raw MIDI bytes without raising on corrupted data, see ``try_from_file``.
 )pbdoc";
 constexpr const char* kScoreFromAbcDoc = R"pbdoc(
 Parse an ABC notation string into a score. Requires the ``SYMUSIC_ABC2MIDI`` environment variable
 to point to the abc2midi executable.
 )pbdoc";
-constexpr const char* kScoreDumpMidiDoc
-    = R"pbdoc(Write the score to a MIDI file using the current ticks-per-quarter resolution.)pbdoc";
-constexpr const char* kScoreDumpsMidiDoc
-    = R"pbdoc(Serialize the score into MIDI bytes for in-memory workflows.)pbdoc";
+constexpr const char* kScoreDumpMidiDoc = R"pbdoc(
+Write the score to a MIDI file using the current ticks-per-quarter resolution. Set *running_status*
+to ``True`` to omit status bytes that repeat the previous one in the track. ``num_threads``
+encodes track chunks in parallel (``0`` uses every core); the bytes are the same for any thread
+count. ``compact=True`` also drops tempos that repeat the last one and, on channels used by a
+single track, program changes to program 0 and control changes and pitch bends that repeat the last
+value sent. ``format=0`` writes a single-track file; tracks sharing a
+MIDI channel (several drum tracks, or more than 15 others) are merged when it is read back.
+)pbdoc";
+constexpr const char* kScoreDumpsMidiDoc = R"pbdoc(
+Serialize the score into MIDI bytes for in-memory workflows. The arguments behave like in
+:meth:`dump_midi`.
+)pbdoc";
+constexpr const char* kScoreFromColumnarDoc = R"pbdoc(
+Decode bytes written by :meth:`dumps_columnar`. A score stored in another time unit is converted.
+)pbdoc";
+constexpr const char* kScoreDumpColumnarDoc = R"pbdoc(
+Write the score in the columnar cache format (conventionally ``.symc``): a versioned binary file
+with one delta-coded, bit-packed column per event field. It is lossless for every time unit and
+much smaller and faster to load than MIDI, which makes it suited to caching preprocessed datasets.
+)pbdoc";
+constexpr const char* kScoreDumpsColumnarDoc = R"pbdoc(
+Serialize the score into columnar bytes, see :meth:`dump_columnar`.
+)pbdoc";
+constexpr const char* kScoreDumpScoreMapDoc = R"pbdoc(
+Write the score as a score map file, opened without deserializing by ``symusic.open_score_map``.
+Events are stored as the in-memory structs, so the file is larger than ZPP or columnar output and
+is meant to be read on the platform that wrote it.
+)pbdoc";
 constexpr const char* kScoreDumpAbcDoc = R"pbdoc(
 Dump the score to an ABC file via midi2abc. Temporary MIDI files are cleaned up automatically.
 )pbdoc";
@@ -135,6 +178,10 @@ constexpr const char* kEqDoc
     = R"pbdoc(Scores compare equal when their handles or contents match.)pbdoc";
 constexpr const char* kGetStateDoc
     = R"pbdoc(Serialize the score into ZPP bytes for pickling.)pbdoc";
+constexpr const char* kReduceExDoc = R"pbdoc(
+Reduce the score for pickling. From protocol 5 on, the ZPP state is a ``PickleBuffer`` that can
+travel out of band (e.g. through shared memory) instead of being copied into the pickle stream.
+)pbdoc";
 constexpr const char* kSetStateDoc = R"pbdoc(Rehydrate the score from serialized ZPP bytes.)pbdoc";
 constexpr const char* kSortDoc
     = R"pbdoc(Sort tracks chronologically. When *inplace* is False the operation occurs on a copy.)pbdoc";
@@ -152,6 +199,8 @@ constexpr const char* kEndDoc
 constexpr const char* kNoteNumDoc
     = R"pbdoc(Return the total number of notes across all tracks.)pbdoc";
 constexpr const char* kEmptyDoc = R"pbdoc(Return True when the score contains no notes.)pbdoc";
+constexpr const char* kFingerprintDoc
+    = R"pbdoc(Return a 128-bit hash of the notes as 32 hex digits. Onsets and durations are normalized to quarters, so it does not depend on the time unit, the ticks per quarter, note order, track names or non-note events. Equals ``MidiInfo.fingerprint`` of the source file.)pbdoc";
 constexpr const char* kAdjustTimeDoc
     = R"pbdoc(Remap timestamps across all tracks using aligned original/new time arrays. Operates in place unless specified.)pbdoc";
 constexpr const char* kUseCountDoc
@@ -199,15 +248,40 @@ nb::object convert_score(
 }
 
 template<TType T>
-shared<Score<T>> midi2score(const std::filesystem::path& path, const bool sanitize_data = false) {
-    auto     data = read_file(path);
-    Score<T> s    = parse<DataFormat::MIDI, Score<T>>(data, sanitize_data);
+shared<Score<T>> midi2score(const std::filesystem::path& path, const ParseOptions& options = {}) {
+    const MappedFile file(path);
+    Score<T>         s = parse<DataFormat::MIDI, Score<T>>(file.bytes(), options);
     return std::make_shared<Score<T>>(std::move(s));
 }
 
 template<TType T>
-void dump_midi(const shared<Score<T>>& self, const std::filesystem::path& path) {
-    const auto data = self->template dumps<DataFormat::MIDI>();
+nb::tuple to_try_result(ParseResult<Score<T>>&& result) {
+    if (result.ok()) {
+        return nb::make_tuple(std::make_shared<Score<T>>(std::move(*result.value)), nb::none());
+    }
+    nb::object score = nb::none();
+    if (result.partial) score = nb::cast(std::make_shared<Score<T>>(std::move(*result.partial)));
+    return nb::make_tuple(score, std::move(result.error));
+}
+
+template<TType T>
+void dump_midi_path(
+    const shared<Score<T>>&      self,
+    const std::filesystem::path& path,
+    const bool                   running_status = false,
+    const size_t                 num_threads    = 1,
+    const bool                   compact        = false,
+    const u8                     format         = 1
+) {
+    const auto data = dumps<DataFormat::MIDI>(
+        *self,
+        DumpOptions{
+            .running_status = running_status,
+            .num_threads    = num_threads,
+            .compact        = compact,
+            .format         = format,
+        }
+    );
     write_file(path, data);
 }
 
@@ -229,7 +303,7 @@ void dump_abc_fs(const shared<Score<T>>& self, const std::filesystem::path& path
     const auto& converter_output_path = path;
 #endif
 
-    dump_midi(self, temp_midi_path);
+    dump_midi_path(self, temp_midi_path);
     process_runner::run_process_checked(
         midi2abc,
         {temp_midi_path, std::filesystem::path("-o"), converter_output_path},
@@ -282,6 +356,7 @@ inline std::string get_format(const std::filesystem::path& path) {
     const auto ext = path.extension().string();
     if (ext == ".mid" || ext == ".midi" || ext == ".MID" || ext == ".MIDI") { return "midi"; }
     if (ext == ".abc") { return "abc"; }
+    if (ext == ".symc") { return "columnar"; }
     throw std::invalid_argument("Unknown file format");
 }
 
@@ -347,7 +422,13 @@ template<TType T>
 shared<Score<T>> from_file(
     const std::filesystem::path& path,
     const std::optional<std::string>& format,
-    const bool sanitize_data
+    const bool sanitize_data,
+    const size_t num_threads,
+    const std::optional<vec<std::string>>& keep,
+    const std::optional<std::pair<f64, f64>>& window,
+    const f64 min_overlap,
+    const std::string& start_mode,
+    const std::string& end_mode
 ) {
     std::string format_ = format.has_value() ? *format : "";
     if (format_.empty()) {
@@ -356,11 +437,30 @@ shared<Score<T>> from_file(
         std::transform(format_.begin(), format_.end(), format_.begin(), ::tolower);
     }
 
-    if (format_ == "midi" || format_ == "mid") { return midi2score<T>(path, sanitize_data); }
-    if (format_ == "abc") {
+    if (format_ == "midi" || format_ == "mid") {
+        ParseOptions options = make_parse_options(sanitize_data, num_threads, keep);
+        options.window       = make_parse_window(window, min_overlap, start_mode, end_mode);
+        return midi2score<T>(path, options);
+    }
+    if (format_ == "abc" || format_ == "columnar") {
         if (sanitize_data) {
             throw std::invalid_argument("sanitize_data is only supported for MIDI input");
         }
+        if (num_threads != 1) {
+            throw std::invalid_argument("num_threads is only supported for MIDI input");
+        }
+        if (keep.has_value()) {
+            throw std::invalid_argument("keep is only supported for MIDI input");
+        }
+        if (window.has_value()) {
+            throw std::invalid_argument("window is only supported for MIDI input");
+        }
+        if (format_ == "columnar") {
+            const MappedFile file(path);
+            return std::make_shared<Score<T>>(Score<T>::template parse<DataFormat::COLUMNAR>(
+                file.bytes()
+            ));
+        }
         return from_abc_file<T>(path);
     }
     throw std::invalid_argument("Unknown file format");
@@ -428,36 +528,89 @@ auto bind_score(nb::module_& m, const std::string& name_) {
         .def("__ne__", [](const self_t&, nb::handle) { return true; }, score_docstrings::kEqDoc,
            nb::sig("def __ne__(self, other: object, /) -> bool"))
         .def("__getstate__", [](const self_t& self) {
-            const auto native = to_native(*self);
-            const vec<unsigned char> data = dumps<DataFormat::ZPP>(native);
+            const vec<unsigned char> data = self->template dumps<DataFormat::ZPP>();
             return nb::bytes(reinterpret_cast<const char*>(data.data()), data.size());
         }, score_docstrings::kGetStateDoc, nb::sig("def __getstate__(self, /) -> bytes"))
-        .def("__setstate__", [](self_t& self, const nb::bytes& bytes) {
-            const auto      data = std::string_view(bytes.c_str(), bytes.size());
-            const std::span span(reinterpret_cast<const unsigned char*>(data.data()), data.size());
-            auto ans = symusic::parse<symusic::DataFormat::ZPP, ScoreNative<T>>(span);
-            new (&self) self_t(std::make_shared<Score<T>>(std::move(to_shared(std::move(ans)))));
-        }, score_docstrings::kSetStateDoc, nb::sig(fmt::format("def __setstate__(self, state: bytes, /) -> {}", name).c_str()))
+        .def("__setstate__", [](self_t& self, const nb::handle state) {
+            pyutils::with_state_bytes(state, [&](const std::span<const u8> span) {
+                new (&self) self_t(std::make_shared<Score<T>>(Score<T>::template parse<DataFormat::ZPP>(span)));
+            });
+        }, score_docstrings::kSetStateDoc, nb::sig(fmt::format("def __setstate__(self, state: bytes | memoryview, /) -> {}", name).c_str()))
+        .def("__reduce_ex__", [](const nb::handle self, const int protocol) {
+            return pyutils::reduce_ex(self, nb::cast<const self_t&>(self)->template dumps<DataFormat::ZPP>(), protocol);
+        }, nb::arg("protocol"), score_docstrings::kReduceExDoc,
+           nb::sig("def __reduce_ex__(self, protocol: int, /) -> tuple[object, ...]"))
         .def("__init__", [](self_t* self, const std::filesystem::path& path) {
             new (self) self_t(midi2score<T>(path));
         }, nb::arg("path"), score_docstrings::kScoreMidiFileCtorDoc,
            nb::sig("def __init__(self, path: pathlib.Path, /) -> None"))
-        .def_static("from_file", &from_file<T>, nb::arg("path"), nb::arg("format") = nb::none(), nb::arg("sanitize_data") = false, score_docstrings::kScoreFromFileDoc)
-        .def_static("from_midi", [](const nb::bytes& data, bool sanitize_data) {
+        .def_static("from_file", &from_file<T>, nb::arg("path"), nb::arg("format") = nb::none(), nb::arg("sanitize_data") = false, nb::arg("num_threads") = 1, nb::arg("keep") = nb::none(), nb::arg("window") = nb::none(), nb::arg("min_overlap") = 0, nb::arg("start_mode") = "remove", nb::arg("end_mode") = "remove", score_docstrings::kScoreFromFileDoc)
+        .def_static("from_midi", [](const nb::bytes& data, bool sanitize_data, size_t num_threads, const std::optional<vec<std::string>>& keep, const std::optional<std::pair<f64, f64>>& window, f64 min_overlap, const std::string& start_mode, const std::string& end_mode) {
             const auto str  = std::string_view(data.c_str(), data.size());
             const auto span = std::span(reinterpret_cast<const u8*>(str.data()), str.size());
-            return std::make_shared<Score<T>>(parse<DataFormat::MIDI, Score<T>>(span, sanitize_data));
+            ParseOptions options = make_parse_options(sanitize_data, num_threads, keep);
+            options.window       = make_parse_window(window, min_overlap, start_mode, end_mode);
+            return std::make_shared<Score<T>>(parse<DataFormat::MIDI, Score<T>>(span, options));
         },
             nb::arg("data"),
             nb::arg("sanitize_data") = false,
+            nb::arg("num_threads") = 1,
+            nb::arg("keep") = nb::none(),
+            nb::arg("window") = nb::none(),
+            nb::arg("min_overlap") = 0,
+            nb::arg("start_mode") = "remove",
+            nb::arg("end_mode") = "remove",
             score_docstrings::kScoreFromMidiDoc
         )
+        .def_static("try_from_file", [](const std::filesystem::path& path, bool sanitize_data, const std::optional<vec<std::string>>& keep, bool partial) {
+            const ParseOptions options = make_parse_options(sanitize_data, 1, keep);
+            return to_try_result(try_parse_midi<T>(path, options, partial));
+        },
+            nb::arg("path"),
+            nb::arg("sanitize_data") = false,
+            nb::arg("keep") = nb::none(),
+            nb::arg("partial") = false,
+            score_docstrings::kScoreTryFromFileDoc
+        )
+        .def_static("try_from_midi", [](const nb::bytes& data, bool sanitize_data, const std::optional<vec<std::string>>& keep, bool partial) {
+            const auto span = std::span(reinterpret_cast<const u8*>(data.c_str()), data.size());
+            const ParseOptions options = make_parse_options(sanitize_data, 1, keep);
+            return to_try_result(try_parse_midi<T>(span, options, partial));
+        },
+            nb::arg("data"),
+            nb::arg("sanitize_data") = false,
+            nb::arg("keep") = nb::none(),
+            nb::arg("partial") = false,
+            score_docstrings::kScoreTryFromMidiDoc
+        )
         .def_static("from_abc", &from_abc<T>, nb::arg("abc"), score_docstrings::kScoreFromAbcDoc)
-        .def("dump_midi", &dump_midi<T>, nb::arg("path"), score_docstrings::kScoreDumpMidiDoc)
-        .def("dumps_midi", [](const self_t& self) {
-            auto data = self->template dumps<DataFormat::MIDI>();
+        .def_static("from_columnar", [](const nb::bytes& data) {
+            const auto span = std::span(reinterpret_cast<const u8*>(data.c_str()), data.size());
+            return std::make_shared<Score<T>>(Score<T>::template parse<DataFormat::COLUMNAR>(span));
+        }, nb::arg("data"), score_docstrings::kScoreFromColumnarDoc)
+        .def("dump_midi", &dump_midi_path<T>, nb::arg("path"), nb::arg("running_status") = false, nb::arg("num_threads") = 1, nb::arg("compact") = false, nb::arg("format") = 1, score_docstrings::kScoreDumpMidiDoc)
+        .def("dumps_midi", [](const self_t& self, const bool running_status, const size_t num_threads, const bool compact, const u8 format) {
+            auto data = dumps<DataFormat::MIDI>(
+                *self,
+                DumpOptions{
+                    .running_status = running_status,
+                    .num_threads    = num_threads,
+                    .compact        = compact,
+                    .format         = format,
+                }
+            );
+            return nb::bytes(reinterpret_cast<const char*>(data.data()), data.size());
+        }, nb::arg("running_status") = false, nb::arg("num_threads") = 1, nb::arg("compact") = false, nb::arg("format") = 1, score_docstrings::kScoreDumpsMidiDoc)
+        .def("dump_columnar", [](const self_t& self, const std::filesystem::path& path) {
+            write_file(path, self->template dumps<DataFormat::COLUMNAR>());
+        }, nb::arg("path"), score_docstrings::kScoreDumpColumnarDoc)
+        .def("dumps_columnar", [](const self_t& self) {
+            const auto data = self->template dumps<DataFormat::COLUMNAR>();
             return nb::bytes(reinterpret_cast<const char*>(data.data()), data.size());
-        }, score_docstrings::kScoreDumpsMidiDoc)
+        }, score_docstrings::kScoreDumpsColumnarDoc)
+        .def("dump_score_map", [](const self_t& self, const std::filesystem::path& path) {
+            dump_score_map(*self, path);
+        }, nb::arg("path"), score_docstrings::kScoreDumpScoreMapDoc)
         .def("dump_abc", &dump_abc_path<T>, nb::arg("path"), nb::arg("warn") = false, score_docstrings::kScoreDumpAbcDoc)
         .def("dumps_abc", &dumps_abc<T>, nb::arg("warn") = false, score_docstrings::kScoreDumpsAbcDoc)
         .def("get_beats", &get_beats_array<T>, nb::arg("start_time") = static_cast<unit>(0), score_docstrings::kScoreGetBeatsDoc)
@@ -510,6 +663,7 @@ auto bind_score(nb::module_& m, const std::string& name_) {
         .def("end", [](const self_t& self) { return self->end(); }, score_docstrings::kEndDoc)
         .def("note_num", [](const self_t& self) { return self->note_num(); }, score_docstrings::kNoteNumDoc)
         .def("empty", [](const self_t& self) { return self->empty(); }, score_docstrings::kEmptyDoc)
+        .def("fingerprint", [](const self_t& self) { return fingerprint(*self).hex(); }, score_docstrings::kFingerprintDoc)
         .def("adjust_time", [](self_t& self, const vec<unit>& original_times, const vec<unit>& new_times, const bool inplace) {
             if (inplace) {
                 ops::adjust_time_inplace(*self, original_times, new_times);
@@ -99,6 +99,8 @@ constexpr const char* kReprDoc
     = R"pbdoc(Generate a textual summary of the track for debugging.)pbdoc";
 constexpr const char* kGetStateDoc
     = R"pbdoc(Serialize the track into ZPP bytes for pickling.)pbdoc";
+constexpr const char* kReduceExDoc
+    = R"pbdoc(Pickle reduction of the track; protocol 5 and later pass its state as a PickleBuffer.)pbdoc";
 constexpr const char* kSetStateDoc = R"pbdoc(Rehydrate a track from serialized ZPP bytes.)pbdoc";
 constexpr const char* kEqDoc
     = R"pbdoc(Tracks compare equal when their shared pointers or values match.)pbdoc";
@@ -195,16 +197,18 @@ auto bind_track(nb::module_& m, const std::string& name_) {
         .def("__repr__", [](const self_t& self) { return self->to_string(); }, track_docstrings::kReprDoc,
            nb::sig("def __repr__(self, /) -> str"))
         .def("__getstate__", [](const self_t& self) {
-            const auto native = to_native(*self);
-            const vec<unsigned char> data = dumps<DataFormat::ZPP>(native);
+            const vec<unsigned char> data = self->template dumps<DataFormat::ZPP>();
             return nb::bytes(reinterpret_cast<const char*>(data.data()), data.size());
         }, track_docstrings::kGetStateDoc, nb::sig("def __getstate__(self, /) -> bytes"))
-        .def("__setstate__", [](self_t& self, const nb::bytes& bytes) {
-            const auto      data = std::string_view(bytes.c_str(), bytes.size());
-            const std::span span(reinterpret_cast<const unsigned char*>(data.data()), data.size());
-            auto ans = symusic::parse<symusic::DataFormat::ZPP, TrackNative<T>>(span);
-            new (&self) self_t(std::make_shared<Track<T>>(std::move(to_shared(std::move(ans)))));
-        }, track_docstrings::kSetStateDoc, nb::sig(fmt::format("def __setstate__(self, state: bytes, /) -> {}", name).c_str()))
+        .def("__setstate__", [](self_t& self, const nb::handle state) {
+            pyutils::with_state_bytes(state, [&](const std::span<const u8> span) {
+                new (&self) self_t(std::make_shared<Track<T>>(Track<T>::template parse<DataFormat::ZPP>(span)));
+            });
+        }, track_docstrings::kSetStateDoc, nb::sig(fmt::format("def __setstate__(self, state: bytes | memoryview, /) -> {}", name).c_str()))
+        .def("__reduce_ex__", [](const nb::handle self, const int protocol) {
+            return pyutils::reduce_ex(self, nb::cast<const self_t&>(self)->template dumps<DataFormat::ZPP>(), protocol);
+        }, nb::arg("protocol"), track_docstrings::kReduceExDoc,
+           nb::sig("def __reduce_ex__(self, protocol: int, /) -> tuple[object, ...]"))
         .def_prop_ro("ttype", [](const self_t&) { return T(); }, "Time unit type — Tick/Quarter/Second",
             nb::for_getter(nb::sig(fmt::format("def ttype(self, /) -> symusic.core.{}", docstring_helpers::time_flavor<T>().suffix).c_str())))
         .def("__use_count", [](const self_t& self) { return self.use_count(); }, track_docstrings::kUseCountDoc,
@@ -47,6 +47,39 @@ nb::bytes vec_to_bytes(const pyvec<T>& self) {
     return nb::bytes(reinterpret_cast<const char*>(data.data()), data.size());
 }
 
+/**
+ * Build the result of ``__reduce_ex__`` from the ZPP encoding of ``self``. The object is recreated
+ * through ``copyreg.__newobj__`` and ``__setstate__``, as with the default reduction. From protocol
+ * 5 on, the state is a ``PickleBuffer`` over the encoding itself: pickle writes it without an
+ * intermediate ``bytes`` copy, and with a ``buffer_callback`` hands it out of band.
+ */
+inline nb::tuple reduce_ex(const nb::handle self, vec<u8>&& data, const int protocol) {
+    nb::object state;
+    if (protocol < 5) {
+        state = nb::bytes(reinterpret_cast<const char*>(data.data()), data.size());
+    } else {
+        auto*       owned = new vec<u8>(std::move(data));
+        nb::capsule owner(owned, [](void* p) noexcept { delete static_cast<vec<u8>*>(p); });
+        const auto  array = nb::ndarray<nb::numpy, const u8>(owned->data(), {owned->size()}, owner);
+        state = nb::module_::import_("pickle").attr("PickleBuffer")(nb::cast(array));
+    }
+    const auto newobj = nb::module_::import_("copyreg").attr("__newobj__");
+    return nb::make_tuple(newobj, nb::make_tuple(self.type()), state);
+}
+
+/// Call ``func`` with the bytes of ``state``, which may be any contiguous buffer (``bytes``,
+/// ``memoryview``, ``PickleBuffer``, ...), so out-of-band pickle buffers are read in place.
+template<typename Func>
+decltype(auto) with_state_bytes(const nb::handle state, Func&& func) {
+    Py_buffer view;
+    if (PyObject_GetBuffer(state.ptr(), &view, PyBUF_SIMPLE) != 0) { throw nb::python_error(); }
+    struct Release {
+        Py_buffer* view;
+        ~Release() { PyBuffer_Release(view); }
+    } release{&view};
+    return func(std::span(static_cast<const u8*>(view.buf), static_cast<size_t>(view.len)));
+}
+
 /// Restore a shared object from previously serialized bytes.
 template<typename T>
 void from_bytes(shared<T>& self, const nb::bytes& bytes) {
@@ -56,12 +89,12 @@ void from_bytes(shared<T>& self, const nb::bytes& bytes) {
     new (&self) shared<T>(std::move(ans));
 }
 
-/// Restore a python vector wrapper from bytes.
+/// Restore a python vector wrapper from bytes or any other contiguous buffer.
 template<TimeEvent T>
-void vec_from_bytes(shared<pyvec<T>>& self, const nb::bytes& bytes) {
-    const auto      data = std::string_view(bytes.c_str(), bytes.size());
-    const std::span span(reinterpret_cast<const unsigned char*>(data.data()), data.size());
-    auto            native_ans = parse<DataFormat::ZPP, vec<T>>(span);
+void vec_from_bytes(shared<pyvec<T>>& self, const nb::handle state) {
+    auto native_ans = with_state_bytes(state, [](const std::span<const u8> span) {
+        return parse<DataFormat::ZPP, vec<T>>(span);
+    });
     new (&self) shared<pyvec<T>>(std::make_shared<pyvec<T>>(std::move(native_ans)));
 }
 
@@ -1,4 +1,7 @@
 from .core import (
+    MidiInfo,
+    ParseError,
+    ShardEntry,
     dump_wav,
 )
 from .factory import (
@@ -15,6 +18,16 @@ from .factory import (
     TimeUnit,
     Track,
 )
+from .io import (
+    archive_reader,
+    corpus_reader,
+    dump_many,
+    load_many,
+    open_score_map,
+    shard_reader,
+    shard_writer,
+    stream_parser,
+)
 from .soundfont import (
     BuiltInSF2,
     BuiltInSF3,
@@ -40,4 +53,15 @@ __all__ = [
     "BuiltInSF2",
     "BuiltInSF3",
     "dump_wav",
+    "load_many",
+    "dump_many",
+    "corpus_reader",
+    "archive_reader",
+    "stream_parser",
+    "open_score_map",
+    "shard_writer",
+    "shard_reader",
+    "MidiInfo",
+    "ParseError",
+    "ShardEntry",
 ]
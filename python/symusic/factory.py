@@ -10,6 +10,8 @@ from . import types as smt
 from .soundfont import BuiltInSF3
 
 if TYPE_CHECKING:
+    from collections.abc import Iterable
+
     from numpy import ndarray
 
 __all__ = [
@@ -517,6 +519,9 @@ class ScoreFactory:
     time-unit specializations.
     """
     __core_classes = CoreClasses(core.ScoreTick, core.ScoreQuarter, core.ScoreSecond)
+    __lazy_classes = CoreClasses(
+        core.LazyScoreTick, core.LazyScoreQuarter, core.LazyScoreSecond
+    )
 
     def __call__(
         self,
@@ -544,7 +549,25 @@ class ScoreFactory:
         fmt: str | None = None,
         sanitize_data: bool = False,
         format: str | None = None,
+        num_threads: int = 1,
+        keep: Iterable[str] | None = None,
+        window: tuple[float, float] | None = None,
+        min_overlap: float = 0,
+        start_mode: str = "remove",
+        end_mode: str = "remove",
     ) -> smt.Score:
+        """
+        Load a score from disk.
+
+        :param num_threads: Decode MIDI track chunks on this many threads (``0`` uses every
+            hardware thread). The parsed score does not depend on the thread count.
+        :param keep: MIDI event classes to decode, e.g. ``["notes", "tempos"]``. Other
+            classes are skipped and tracks left empty are dropped. ``None`` keeps everything.
+        :param window: ``(start, end)`` in the unit of ``ttype``. Only this range of a MIDI
+            file is decoded, and events are kept as ``trim(start, end, min_overlap,
+            start_mode, end_mode)`` would keep them. Tracks without any event in the window
+            are dropped.
+        """
         if format is not None:
             if fmt is not None and fmt != format:
                 msg = "fmt and format must match when both are provided"
@@ -554,20 +577,116 @@ class ScoreFactory:
             path = Path(path)
         if not path.is_file():
             raise ValueError(_ := f"{path} is not a file")
-        return self.__core_classes.dispatch(ttype).from_file(path, fmt, sanitize_data)
+        return self.__core_classes.dispatch(ttype).from_file(
+            path,
+            fmt,
+            sanitize_data,
+            num_threads,
+            None if keep is None else list(keep),
+            window,
+            min_overlap,
+            start_mode,
+            end_mode,
+        )
+
+    def open(
+        self,
+        path: str | Path,
+        ttype: smt.GeneralTimeUnit = "tick",
+        lazy: bool = False,
+        sanitize_data: bool = False,
+        num_threads: int = 1,
+        keep: Iterable[str] | None = None,
+    ) -> smt.Score | smt.LazyScore:
+        """
+        Open a MIDI file, optionally without decoding its tracks up front.
+
+        :param lazy: Return a ``LazyScore`` that only decodes the header and the conductor
+            chunk; ``lazy[i]`` decodes and caches the tracks of MTrk chunk ``i`` and
+            ``to_score()`` yields the same score as :meth:`from_file`.
+        """
+        if not lazy:
+            return self.from_file(
+                path,
+                ttype,
+                sanitize_data=sanitize_data,
+                num_threads=num_threads,
+                keep=keep,
+            )
+        if isinstance(path, str):
+            path = Path(path)
+        if not path.is_file():
+            raise ValueError(_ := f"{path} is not a file")
+        return self.__lazy_classes.dispatch(ttype)(
+            path, sanitize_data, num_threads, None if keep is None else list(keep)
+        )
 
     def from_midi(
         self,
         data: bytes,
         ttype: smt.GeneralTimeUnit = "tick",
         sanitize_data: bool = False,
+        num_threads: int = 1,
+        keep: Iterable[str] | None = None,
+        window: tuple[float, float] | None = None,
+        min_overlap: float = 0,
+        start_mode: str = "remove",
+        end_mode: str = "remove",
     ) -> smt.Score:
         """
         Parse MIDI bytes into a score and optionally sanitize payload values.
 
         :param sanitize_data: Clamp MIDI payload bytes to the 7-bit range before parsing.
+        :param num_threads: Decode track chunks on this many threads (``0`` uses every
+            hardware thread).
+        :param keep: MIDI event classes to decode, see :meth:`from_file`.
+        :param window: Time range to decode, see :meth:`from_file`.
+        """
+        return self.__core_classes.dispatch(ttype).from_midi(
+            data,
+            sanitize_data,
+            num_threads,
+            None if keep is None else list(keep),
+            window,
+            min_overlap,
+            start_mode,
+            end_mode,
+        )
+
+    def try_from_file(
+        self,
+        path: str | Path,
+        ttype: smt.GeneralTimeUnit = "tick",
+        sanitize_data: bool = False,
+        keep: Iterable[str] | None = None,
+        partial: bool = False,
+    ) -> tuple[smt.Score | None, core.ParseError | None]:
+        """
+        Load a MIDI file without raising on corrupted or unreadable data.
+
+        :param partial: On failure, return the events decoded before the offending message
+            instead of ``None``.
+        :return: ``(score, None)`` on success, otherwise ``(partial_or_none, error)`` where
+            ``error.code``, ``error.offset`` and ``error.track`` locate the problem.
+        """
+        return self.__core_classes.dispatch(ttype).try_from_file(
+            Path(path), sanitize_data, None if keep is None else list(keep), partial
+        )
+
+    def try_from_midi(
+        self,
+        data: bytes,
+        ttype: smt.GeneralTimeUnit = "tick",
+        sanitize_data: bool = False,
+        keep: Iterable[str] | None = None,
+        partial: bool = False,
+    ) -> tuple[smt.Score | None, core.ParseError | None]:
+        """
+        Parse MIDI bytes without raising on corrupted data, see :meth:`try_from_file`.
         """
-        return self.__core_classes.dispatch(ttype).from_midi(data, sanitize_data)
+        return self.__core_classes.dispatch(ttype).try_from_midi(
+            data, sanitize_data, None if keep is None else list(keep), partial
+        )
 
     def from_abc(
         self,
@@ -576,6 +695,17 @@ class ScoreFactory:
     ) -> smt.Score:
         return self.__core_classes.dispatch(ttype).from_abc(abc)
 
+    def from_columnar(
+        self,
+        data: bytes,
+        ttype: smt.GeneralTimeUnit = "tick",
+    ) -> smt.Score:
+        """
+        Decode bytes written by ``Score.dumps_columnar``. A score stored in another time unit
+        is converted to ``ttype``.
+        """
+        return self.__core_classes.dispatch(ttype).from_columnar(data)
+
     def from_tpq(
         self,
         tpq: int = 960,
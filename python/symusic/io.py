@@ -0,0 +1,251 @@
+"""Corpus-scale I/O helpers backed by the native thread pool in ``symusic.core``."""
+
+from __future__ import annotations
+
+from pathlib import Path
+from typing import TYPE_CHECKING
+
+from . import core  # type: ignore
+from .factory import TimeUnit
+
+if TYPE_CHECKING:
+    from collections.abc import Iterable
+
+    from . import types as smt
+
+__all__ = [
+    "archive_reader",
+    "corpus_reader",
+    "dump_many",
+    "load_many",
+    "open_score_map",
+    "shard_reader",
+    "shard_writer",
+    "stream_parser",
+]
+
+
+def load_many(
+    paths: Iterable[str | Path],
+    ttype: smt.GeneralTimeUnit = "tick",
+    num_threads: int = 0,
+    sanitize_data: bool = False,
+    keep: Iterable[str] | None = None,
+) -> tuple[list[smt.Score | None], list[str | None]]:
+    """Read and parse many MIDI files in parallel.
+
+    Files are read and decoded on a native thread pool with the GIL released.
+
+    :param paths: MIDI files to load.
+    :param ttype: Time unit of the returned scores.
+    :param num_threads: Worker count, ``0`` uses every hardware thread.
+    :param sanitize_data: Clamp MIDI payload bytes to the 7-bit range instead of failing.
+    :param keep: MIDI event classes to decode (see ``Score.from_file``); ``None`` keeps all.
+    :return: ``(scores, errors)`` aligned with ``paths``. A file that fails to load gives
+        ``None`` in ``scores`` and its error message in ``errors``; otherwise the error
+        entry is ``None``.
+    """
+    if num_threads < 0:
+        msg = f"num_threads must be non-negative, but got {num_threads}"
+        raise ValueError(msg)
+    return core.load_many(
+        [Path(p) for p in paths],
+        TimeUnit(ttype),
+        num_threads,
+        sanitize_data,
+        None if keep is None else list(keep),
+    )
+
+
+def corpus_reader(
+    paths: Iterable[str | Path],
+    ttype: smt.GeneralTimeUnit = "tick",
+    num_threads: int = 0,
+    io_threads: int = 1,
+    prefetch: int = 0,
+    sanitize_data: bool = False,
+    keep: Iterable[str] | None = None,
+) -> smt.CorpusReader:
+    """Iterate over parsed MIDI files while the following files are read ahead.
+
+    Files are read on dedicated I/O threads and parsed on a native worker pool, both with the
+    GIL released, so read latency (e.g. on a network filesystem) hides behind parsing. At most
+    ``prefetch`` files are in flight ahead of the consumer, which bounds memory use.
+
+    :param paths: MIDI files to load.
+    :param ttype: Time unit of the returned scores.
+    :param num_threads: Parsing workers, ``0`` uses every hardware thread.
+    :param io_threads: Files read concurrently; raise it for high-latency storage.
+    :param prefetch: Files in flight ahead of the consumer, ``0`` picks four per worker.
+    :param sanitize_data: Clamp MIDI payload bytes to the 7-bit range instead of failing.
+    :param keep: MIDI event classes to decode (see ``Score.from_file``); ``None`` keeps all.
+    :return: An iterator yielding ``(path, score, error)`` in input order. A file that fails to
+        load gives ``score=None`` and its error message; otherwise ``error`` is ``None``.
+    """
+    for name, value in (
+        ("num_threads", num_threads),
+        ("io_threads", io_threads),
+        ("prefetch", prefetch),
+    ):
+        if value < 0:
+            msg = f"{name} must be non-negative, but got {value}"
+            raise ValueError(msg)
+    return core.corpus_reader(
+        [Path(p) for p in paths],
+        TimeUnit(ttype),
+        num_threads,
+        io_threads,
+        prefetch,
+        sanitize_data,
+        None if keep is None else list(keep),
+    )
+
+
+def archive_reader(
+    path: str | Path,
+    ttype: smt.GeneralTimeUnit = "tick",
+    num_threads: int = 0,
+    prefetch: int = 0,
+    suffixes: Iterable[str] = (".mid", ".midi"),
+    sanitize_data: bool = False,
+    keep: Iterable[str] | None = None,
+) -> smt.ArchiveReader:
+    """Iterate over the parsed MIDI members of a tar, tar.gz or zip archive without extracting it.
+
+    The archive is read front to back on a native thread; members are decompressed and parsed
+    on a worker pool with the GIL released. Zip members may be stored or deflate-compressed.
+
+    :param path: Archive file; the format is detected from its leading bytes.
+    :param ttype: Time unit of the returned scores.
+    :param num_threads: Parsing workers, ``0`` uses every hardware thread.
+    :param prefetch: Members in flight ahead of the consumer, ``0`` picks four per worker.
+    :param suffixes: Member name endings to parse (case-insensitive); empty parses every member.
+    :param sanitize_data: Clamp MIDI payload bytes to the 7-bit range instead of failing.
+    :param keep: MIDI event classes to decode (see ``Score.from_file``); ``None`` keeps all.
+    :return: An iterator yielding ``(name, score, error)`` in archive order. A member that fails
+        to load gives ``score=None`` and its error message; otherwise ``error`` is ``None``.
+        Damage to the archive structure raises ``RuntimeError`` once the intact members before
+        it have been yielded.
+    """
+    for name, value in (("num_threads", num_threads), ("prefetch", prefetch)):
+        if value < 0:
+            msg = f"{name} must be non-negative, but got {value}"
+            raise ValueError(msg)
+    if isinstance(suffixes, str):
+        suffixes = (suffixes,)
+    return core.archive_reader(
+        Path(path),
+        TimeUnit(ttype),
+        num_threads,
+        prefetch,
+        list(suffixes),
+        sanitize_data,
+        None if keep is None else list(keep),
+    )
+
+
+def dump_many(
+    scores: Iterable[smt.Score],
+    paths: Iterable[str | Path],
+    format: str | int = "midi",  # noqa: A002
+    num_threads: int = 0,
+    running_status: bool = False,
+    compact: bool = False,
+) -> list[str | None]:
+    """Encode many scores and write each to the path at the same position, in parallel.
+
+    Scores are encoded and written on a native thread pool with the GIL released. All scores
+    must share one time unit.
+
+    :param scores: Scores to write.
+    :param paths: Output files, one per score.
+    :param format: Output format; only ``"midi"`` is supported. The MIDI file format numbers of
+        ``Score.dump_midi`` are accepted too: ``0`` writes single-track files and ``1`` is the
+        same as ``"midi"``.
+    :param num_threads: Worker count, ``0`` uses every hardware thread.
+    :param running_status: Omit repeated status bytes, see ``Score.dump_midi``.
+    :param compact: Drop redundant tempo, program, control and pitch bend events, see
+        ``Score.dump_midi``.
+    :return: A list aligned with ``paths`` holding ``None`` for every written file and the
+        error message for every file that could not be written.
+    """
+    if isinstance(format, str) and format.lower() == "midi":
+        format = 1  # noqa: A001
+    elif isinstance(format, bool) or format not in (0, 1):
+        msg = f"dump_many only supports the 'midi' format (0 or 1), but got {format!r}"
+        raise ValueError(msg)
+    if num_threads < 0:
+        msg = f"num_threads must be non-negative, but got {num_threads}"
+        raise ValueError(msg)
+    scores = list(scores)
+    paths = [Path(p) for p in paths]
+    if len(scores) != len(paths):
+        msg = f"got {len(scores)} scores but {len(paths)} paths"
+        raise ValueError(msg)
+    if not scores:
+        return []
+    return core.dump_many(scores, paths, num_threads, running_status, compact, format)
+
+
+def stream_parser(
+    ttype: smt.GeneralTimeUnit = "tick",
+    sanitize_data: bool = False,
+    keep: Iterable[str] | None = None,
+) -> smt.MidiStreamParser:
+    """Create an incremental MIDI parser for bytes that arrive in pieces.
+
+    ``parser.feed(data)`` decodes every MTrk chunk completed by ``data`` and returns the
+    tracks decoded from them, so parsing overlaps with downloading or decompressing.
+    ``parser.finish()`` returns the same score as ``Score.from_midi`` on the whole input and
+    raises ``RuntimeError`` if fewer chunks arrived than the header declares. In seconds, the
+    parser keeps a copy of the chunks it has decoded until the last one arrives, in case a tempo
+    outside the first chunk requires a full re-parse.
+
+    :param ttype: Time unit of the decoded tracks and score.
+    :param sanitize_data: Clamp MIDI payload bytes to the 7-bit range instead of failing.
+    :param keep: MIDI event classes to decode (see ``Score.from_file``); ``None`` keeps all.
+    """
+    return core.stream_parser(
+        TimeUnit(ttype), sanitize_data, None if keep is None else list(keep)
+    )
+
+
+def open_score_map(path: str | Path, ttype: smt.GeneralTimeUnit = "tick") -> smt.ScoreMap:
+    """Memory map a file written by ``Score.dump_score_map`` without deserializing it.
+
+    Opening takes the same time whatever the number of notes, and processes mapping the same
+    file share one copy in the page cache. Event arrays are returned as read-only NumPy views
+    into the mapping; call ``to_score()`` for a mutable copy.
+
+    :param path: Score map file.
+    :param ttype: Time unit the file was written in; a different unit raises ``RuntimeError``.
+    :return: A ``ScoreMap`` whose items are the tracks of the file.
+    """
+    return core.open_score_map(Path(path), TimeUnit(ttype))
+
+
+def shard_writer(path: str | Path, ttype: smt.GeneralTimeUnit = "tick") -> smt.ShardWriter:
+    """Create a shard file that packs many scores behind an index.
+
+    Each ``add(key, score)`` appends the ZPP encoding of ``score``; ``close()``, or leaving a
+    ``with`` block, appends the index of (key, offset, length, note count, duration) entries.
+
+    :param path: Shard file, truncated if it exists.
+    :param ttype: Time unit of the scores that will be added.
+    :return: A ``ShardWriter``; keys must be unique within the shard.
+    """
+    return core.shard_writer(Path(path), TimeUnit(ttype))
+
+
+def shard_reader(path: str | Path, ttype: smt.GeneralTimeUnit = "tick") -> smt.ShardReader:
+    """Open a shard file written by ``shard_writer`` for random access.
+
+    Only the index is read up front. ``reader[i]`` and ``reader[key]`` then load one score with
+    a single positioned read, which suits a PyTorch ``Dataset.__getitem__``; ``load_many``
+    loads many scores on a native thread pool.
+
+    :param path: Shard file.
+    :param ttype: Time unit of the returned scores; a shard in another unit is converted.
+    :return: A ``ShardReader`` whose ``entries`` describe the stored scores.
+    """
+    return core.shard_reader(Path(path), TimeUnit(ttype))
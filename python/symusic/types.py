@@ -64,6 +64,26 @@ TextMetaList = Union[
     core.TextMetaSecondList,
 ]
 TrackList = Union[core.TrackTickList, core.TrackQuarterList, core.TrackSecondList]
+LazyScore = Union[core.LazyScoreTick, core.LazyScoreQuarter, core.LazyScoreSecond]
+MidiStreamParser = Union[
+    core.MidiStreamParserTick,
+    core.MidiStreamParserQuarter,
+    core.MidiStreamParserSecond,
+]
+CorpusReader = Union[
+    core.CorpusReaderTick,
+    core.CorpusReaderQuarter,
+    core.CorpusReaderSecond,
+]
+ArchiveReader = Union[
+    core.ArchiveReaderTick,
+    core.ArchiveReaderQuarter,
+    core.ArchiveReaderSecond,
+]
+ScoreMap = Union[core.ScoreMapTick, core.ScoreMapQuarter, core.ScoreMapSecond]
+TrackMap = Union[core.TrackMapTick, core.TrackMapQuarter, core.TrackMapSecond]
+ShardWriter = Union[core.ShardWriterTick, core.ShardWriterQuarter, core.ShardWriterSecond]
+ShardReader = Union[core.ShardReaderTick, core.ShardReaderQuarter, core.ShardReaderSecond]
 
 GeneralNoteList = Union[NoteList, List[core.Note]]
 GeneralKeySignatureList = Union[KeySignatureList, List[core.KeySignature]]
@@ -0,0 +1,92 @@
+//
+// Musical content fingerprint of a score.
+//
+#include <cmath>
+
+#include "fmt/core.h"
+#include "MetaMacro.h"
+
+#include "symusic/conversion.h"
+#include "symusic/fingerprint.h"
+
+namespace symusic {
+
+namespace details {
+
+// splitmix64 finalizer
+constexpr u64 mix64(u64 x) {
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return x;
+}
+
+}   // namespace details
+
+void Fingerprint::add_note(
+    const i64 onset,
+    const i64 duration,
+    const u8  pitch,
+    const u8  velocity,
+    const u8  program,
+    const bool is_drum
+) {
+    const u64 a = static_cast<u64>(onset);
+    const u64 b = static_cast<u64>(duration);
+    const u64 c = static_cast<u64>(pitch) | static_cast<u64>(velocity) << 8
+                  | static_cast<u64>(program) << 16 | static_cast<u64>(is_drum) << 24;
+    // two independently seeded lanes; summing keeps the result independent of note order
+    lo += details::mix64(a ^ details::mix64(b ^ details::mix64(c ^ 0x9E3779B97F4A7C15ULL)));
+    hi += details::mix64(a + details::mix64(b + details::mix64(c + 0xD1B54A32D192ED03ULL)));
+}
+
+i64 Fingerprint::normalize(const i64 tick, const i32 ticks_per_quarter) {
+    const i64 num = 2 * tick * RESOLUTION + ticks_per_quarter;
+    const i64 den = 2 * static_cast<i64>(ticks_per_quarter);
+    // floor division, so that negative times round the same way as positive ones
+    return num >= 0 ? num / den : -((-num + den - 1) / den);
+}
+
+std::string Fingerprint::hex() const {
+    return fmt::format("{:016x}{:016x}", hi, lo);
+}
+
+template<TType T>
+Fingerprint fingerprint(const Score<T>& score) {
+    if constexpr (std::is_same_v<T, Second>) {
+        return fingerprint(convert<Tick>(score));
+    } else {
+        const i32   tpq = score.ticks_per_quarter;
+        Fingerprint result;
+        for (const auto& track : *score.tracks) {
+            for (const auto& note : *track->notes) {
+                i64 time, duration;
+                if constexpr (std::is_same_v<T, Tick>) {
+                    time     = note.time;
+                    duration = note.duration;
+                } else {
+                    time     = std::llround(static_cast<f64>(note.time) * tpq);
+                    duration = std::llround(static_cast<f64>(note.duration) * tpq);
+                }
+                result.add_note(
+                    Fingerprint::normalize(time, tpq),
+                    Fingerprint::normalize(duration, tpq),
+                    static_cast<u8>(note.pitch),
+                    static_cast<u8>(note.velocity),
+                    track->program,
+                    track->is_drum
+                );
+            }
+        }
+        return result;
+    }
+}
+
+#define INSTANTIATE_FINGERPRINT(__COUNT, T) template Fingerprint fingerprint<T>(const Score<T>&);
+
+REPEAT_ON(INSTANTIATE_FINGERPRINT, Tick, Quarter, Second)
+#undef INSTANTIATE_FINGERPRINT
+
+}   // namespace symusic
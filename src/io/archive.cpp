@@ -0,0 +1,468 @@
+//
+// Tar, tar.gz and zip readers feeding archive members to parsing workers.
+//
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+#include "fmt/core.h"
+#include "MetaMacro.h"
+
+#include "symusic/io/archive.h"
+#include "symusic/io/common.h"
+#include "symusic/io/midi_parser.h"
+#include "symusic/detail/inflate.h"
+#include "symusic/detail/parallel.h"
+#include "symusic/detail/pipeline.h"
+
+namespace symusic {
+
+namespace {
+
+/// A selected member on its way from the reader thread to a worker.
+struct Member {
+    std::string         name;
+    vec<u8>             owned;        // tar members are copied out of the decompressed stream
+    std::span<const u8> packed;       // zip members point into the mapped archive
+    u16                 method = 0;   // zip compression method: 0 stored, 8 deflate
+    u16                 flags  = 0;   // zip general purpose flags
+    u32                 crc    = 0;
+    size_t              size   = 0;   // zip uncompressed size
+    bool                zipped = false;
+};
+
+/// Thrown through the decompressor when the pipeline is stopped while the reader is blocked.
+struct Stopped {};
+
+u16 le16(const u8* p) { return static_cast<u16>(p[0] | p[1] << 8); }
+
+u32 le32(const u8* p) {
+    return static_cast<u32>(p[0]) | static_cast<u32>(p[1]) << 8 | static_cast<u32>(p[2]) << 16
+           | static_cast<u32>(p[3]) << 24;
+}
+
+u64 le64(const u8* p) { return static_cast<u64>(le32(p)) | static_cast<u64>(le32(p + 4)) << 32; }
+
+bool has_suffix(const std::string& name, const vec<std::string>& suffixes) {
+    if (suffixes.empty()) return true;
+    return std::any_of(suffixes.begin(), suffixes.end(), [&](const std::string& suffix) {
+        if (suffix.size() > name.size()) return false;
+        return std::equal(
+            suffix.begin(), suffix.end(), name.end() - static_cast<ptrdiff_t>(suffix.size()),
+            [](const char a, const char b) {
+                return std::tolower(static_cast<unsigned char>(a))
+                       == std::tolower(static_cast<unsigned char>(b));
+            }
+        );
+    });
+}
+
+/// A NUL-terminated string field of a tar header.
+std::string tar_string(const u8* field, const size_t size) {
+    const auto* begin = reinterpret_cast<const char*>(field);
+    return {begin, static_cast<size_t>(std::find(begin, begin + size, '\0') - begin)};
+}
+
+/// A numeric tar header field: octal text, or big-endian base-256 if the top bit is set (GNU).
+u64 tar_number(const u8* field, const size_t size) {
+    u64 value = 0;
+    if (field[0] & 0x80) {
+        for (size_t i = 1; i < size; ++i) { value = value << 8 | field[i]; }
+        return value;
+    }
+    for (size_t i = 0; i < size && field[i] != 0 && field[i] != ' '; ++i) {
+        if (field[i] < '0' || field[i] > '7') throw std::runtime_error("Invalid tar header number");
+        value = value << 3 | static_cast<u64>(field[i] - '0');
+    }
+    return value;
+}
+
+/**
+ * Push-based tar parser: fed the archive in pieces of any size (as they come out of the
+ * decompressor), it reports every regular member once its data is complete. Members whose name
+ * ``select`` rejects are skipped without being copied. Understands ustar prefixes, GNU long names
+ * and pax ``path`` records.
+ */
+template<typename Select, typename Emit>
+class TarStream {
+public:
+    TarStream(Select select, Emit emit) : select(std::move(select)), emit(std::move(emit)) {}
+
+    void feed(std::span<const u8> bytes) {
+        while (!bytes.empty() && !ended) {
+            size_t take;
+            if (state == State::Header) {
+                take = std::min(bytes.size(), 512 - header.size());
+                header.insert(header.end(), bytes.begin(), bytes.begin() + take);
+                if (header.size() == 512) on_header(offset + take - 512);
+            } else if (state == State::Data) {
+                take = static_cast<size_t>(std::min<u64>(bytes.size(), remaining));
+                if (keep) data.insert(data.end(), bytes.begin(), bytes.begin() + take);
+                remaining -= take;
+                if (remaining == 0) on_data();
+            } else {
+                take = static_cast<size_t>(std::min<u64>(bytes.size(), remaining));
+                remaining -= take;
+                if (remaining == 0) state = State::Header;
+            }
+            offset += take;
+            bytes = bytes.subspan(take);
+        }
+    }
+
+    /// Check that the archive did not stop in the middle of a member.
+    void finish() const {
+        if (!ended && (state != State::Header || !header.empty())) {
+            throw std::runtime_error("Truncated tar archive");
+        }
+    }
+
+private:
+    enum class State { Header, Data, Padding };
+
+    Select      select;
+    Emit        emit;
+    State       state     = State::Header;
+    bool        ended     = false;
+    bool        keep      = false;
+    char        type      = 0;
+    u64         remaining = 0;
+    u64         padding   = 0;
+    u64         offset    = 0;
+    vec<u8>     header;
+    vec<u8>     data;
+    std::string name;
+    std::string long_name;   // from a preceding GNU long name or pax header
+
+    void on_header(const u64 header_offset) {
+        const u8* block = header.data();
+        if (std::all_of(header.begin(), header.end(), [](const u8 b) { return b == 0; })) {
+            ended = true;   // end-of-archive marker
+            return;
+        }
+        u64 sum = 0;
+        for (size_t i = 0; i < 512; ++i) { sum += (i >= 148 && i < 156) ? u64{' '} : block[i]; }
+        if (sum != tar_number(block + 148, 8)) {
+            throw std::runtime_error(fmt::format("Invalid tar header at offset {}", header_offset));
+        }
+
+        type           = static_cast<char>(block[156]);
+        const u64 size = tar_number(block + 124, 12);
+        name           = std::exchange(long_name, {});
+        if (name.empty()) {
+            name = tar_string(block, 100);
+            const std::string prefix = tar_string(block + 345, 155);
+            if (std::memcmp(block + 257, "ustar", 5) == 0 && !prefix.empty()) {
+                name = prefix + "/" + name;
+            }
+        }
+        const bool regular = type == '0' || type == '\0' || type == '7';
+        keep               = type == 'L' || type == 'x' || (regular && select(name));
+        header.clear();
+        data.clear();
+        if (keep) data.reserve(static_cast<size_t>(std::min<u64>(size, u64{1} << 26)));
+        remaining = size;
+        padding   = (512 - size % 512) % 512;
+        state     = State::Data;
+        if (remaining == 0) on_data();
+    }
+
+    void on_data() {
+        if (type == 'L') {
+            long_name = tar_string(data.data(), data.size());
+        } else if (type == 'x') {
+            read_pax();
+        } else if (keep) {
+            emit(std::move(name), std::move(data));
+            data = {};
+        }
+        remaining = padding;
+        state     = remaining == 0 ? State::Header : State::Padding;
+    }
+
+    /// pax records look like ``"<length> <key>=<value>\n"``; only ``path`` matters here.
+    void read_pax() {
+        const std::string_view text(reinterpret_cast<const char*>(data.data()), data.size());
+        size_t                 pos = 0;
+        while (pos < text.size()) {
+            const size_t space = text.find(' ', pos);
+            if (space == std::string_view::npos) break;
+            size_t length = 0;
+            for (size_t i = pos; i < space; ++i) {
+                if (text[i] < '0' || text[i] > '9') throw std::runtime_error("Invalid pax header");
+                length = length * 10 + static_cast<size_t>(text[i] - '0');
+            }
+            if (length <= space - pos || pos + length > text.size()) {
+                throw std::runtime_error("Invalid pax header");
+            }
+            const auto record = text.substr(space + 1, pos + length - space - 2);
+            if (record.substr(0, 5) == "path=") long_name = std::string(record.substr(5));
+            pos += length;
+        }
+    }
+};
+
+/// Location of a zip member, taken from the central directory.
+struct ZipEntry {
+    std::string name;
+    u16         flags;
+    u16         method;
+    u32         crc;
+    u64         packed_size;
+    u64         size;
+    u64         local_offset;
+};
+
+[[noreturn]] void bad_zip(const char* what) {
+    throw std::runtime_error(fmt::format("Invalid zip archive: {}", what));
+}
+
+vec<ZipEntry> read_zip_directory(const std::span<const u8> bytes) {
+    // the end-of-central-directory record sits in the last 22 + 65535 (comment) bytes
+    if (bytes.size() < 22) bad_zip("too short");
+    size_t eocd = bytes.size() - 22;
+    while (le32(bytes.data() + eocd) != 0x06054b50) {
+        if (eocd == 0 || bytes.size() - eocd >= 22 + 65535) bad_zip("missing end of directory");
+        --eocd;
+    }
+    const u8* end_record = bytes.data() + eocd;
+    u64       count      = le16(end_record + 10);
+    u64       dir_size   = le32(end_record + 12);
+    u64       dir_offset = le32(end_record + 16);
+
+    if (count == 0xFFFF || dir_size == 0xFFFFFFFF || dir_offset == 0xFFFFFFFF) {
+        // zip64: a locator right before the record points at the zip64 end record
+        if (eocd < 20 || le32(end_record - 20) != 0x07064b50) bad_zip("missing zip64 locator");
+        const u64 record = le64(end_record - 20 + 8);
+        if (bytes.size() < 56 || record > bytes.size() - 56
+            || le32(bytes.data() + record) != 0x06064b50) {
+            bad_zip("invalid zip64 end of directory");
+        }
+        count      = le64(bytes.data() + record + 32);
+        dir_size   = le64(bytes.data() + record + 40);
+        dir_offset = le64(bytes.data() + record + 48);
+    }
+    if (dir_offset > bytes.size() || dir_size > bytes.size() - dir_offset) {
+        bad_zip("central directory out of range");
+    }
+
+    vec<ZipEntry> entries;
+    entries.reserve(static_cast<size_t>(std::min<u64>(count, dir_size / 46)));
+    const u8* p   = bytes.data() + dir_offset;
+    const u8* end = p + dir_size;
+    for (u64 i = 0; i < count; ++i) {
+        if (end - p < 46 || le32(p) != 0x02014b50) bad_zip("invalid central directory entry");
+        const size_t name_size    = le16(p + 28);
+        const size_t extra_size   = le16(p + 30);
+        const size_t comment_size = le16(p + 32);
+        if (static_cast<size_t>(end - p) < 46 + name_size + extra_size + comment_size) {
+            bad_zip("invalid central directory entry");
+        }
+        ZipEntry entry{
+            .name         = std::string(reinterpret_cast<const char*>(p + 46), name_size),
+            .flags        = le16(p + 8),
+            .method       = le16(p + 10),
+            .crc          = le32(p + 16),
+            .packed_size  = le32(p + 20),
+            .size         = le32(p + 24),
+            .local_offset = le32(p + 42),
+        };
+        // the zip64 extra field holds, in this order, whichever of the fields above overflowed
+        const u8* extra     = p + 46 + name_size;
+        const u8* extra_end = extra + extra_size;
+        while (extra_end - extra >= 4) {
+            const u16 id   = le16(extra);
+            const u16 size = le16(extra + 2);
+            if (extra_end - extra - 4 < size) break;
+            if (id == 0x0001) {
+                const u8* field = extra + 4;
+                const u8* stop  = field + size;
+                for (u64* value : {&entry.size, &entry.packed_size, &entry.local_offset}) {
+                    if (*value != 0xFFFFFFFF || stop - field < 8) continue;
+                    *value = le64(field);
+                    field += 8;
+                }
+            }
+            extra += 4 + size;
+        }
+        entries.push_back(std::move(entry));
+        p += 46 + name_size + extra_size + comment_size;
+    }
+    return entries;
+}
+
+}   // namespace
+
+template<TType T>
+struct ArchiveReader<T>::Impl {
+    MappedFile       file;
+    ParseOptions     options;
+    vec<std::string> suffixes;
+    size_t           workers;
+    size_t           emitted = 0;   // only touched by the reader thread
+
+    // declared last, so its threads are joined before the members they use are destroyed
+    details::OrderedPipeline<Member, ArchiveItem<T>> pipeline;
+
+    Impl(const std::filesystem::path& path, const ArchiveOptions& archive_options) :
+        file(path),
+        options(archive_options.parse),
+        suffixes(archive_options.suffixes),
+        workers(details::resolve_num_threads(options.num_threads, SIZE_MAX)),
+        pipeline(archive_options.prefetch == 0 ? 4 * workers : archive_options.prefetch, 1) {
+        options.num_threads = 1;
+        pipeline.spawn([this] { read_loop(); });
+        for (size_t i = 0; i < workers; ++i) { pipeline.spawn([this] { parse_loop(); }); }
+    }
+
+    /// Hand a member to the workers, or report a member error directly.
+    void emit(Member member, std::string error = {}) {
+        const auto index = pipeline.claim();
+        if (!index) throw Stopped{};
+        ++emitted;
+        if (error.empty()) {
+            pipeline.submit(*index, std::move(member));
+        } else {
+            pipeline.fill(*index, ArchiveItem<T>{*index, std::move(member.name), {{}, error}});
+        }
+    }
+
+    void read_loop() {
+        try {
+            const auto bytes = file.bytes();
+            const u32  magic = bytes.size() >= 4 ? le32(bytes.data()) : 0;
+            if (magic == 0x04034b50 || magic == 0x06054b50) {   // local header or empty zip
+                read_zip(bytes);
+            } else if (bytes.size() >= 2 && bytes[0] == 0x1F && bytes[1] == 0x8B) {
+                auto tar = make_tar();
+                details::gunzip(bytes, [&](const std::span<const u8> chunk) { tar.feed(chunk); });
+                tar.finish();
+            } else {
+                auto tar = make_tar();
+                tar.feed(bytes);
+                tar.finish();
+            }
+            pipeline.producer_done(emitted);
+        } catch (const Stopped&) {
+            pipeline.producer_done(emitted);
+        } catch (...) { pipeline.producer_done(emitted, std::current_exception()); }
+    }
+
+    auto make_tar() {
+        const auto select = [this](const std::string& name) { return has_suffix(name, suffixes); };
+        const auto push   = [this](std::string name, vec<u8> data) {
+            emit(Member{.name = std::move(name), .owned = std::move(data)});
+        };
+        return TarStream<decltype(select), decltype(push)>(select, push);
+    }
+
+    void read_zip(const std::span<const u8> bytes) {
+        auto entries = read_zip_directory(bytes);
+        // visit the members in file order, so the archive is read front to back
+        std::stable_sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+            return a.local_offset < b.local_offset;
+        });
+        for (auto& entry : entries) {
+            if (entry.name.empty() || entry.name.back() == '/') continue;   // directory
+            if (!has_suffix(entry.name, suffixes)) continue;
+
+            Member member{
+                .name   = std::move(entry.name),
+                .method = entry.method,
+                .flags  = entry.flags,
+                .crc    = entry.crc,
+                .size   = static_cast<size_t>(entry.size),
+                .zipped = true,
+            };
+            const u64 local = entry.local_offset;
+            if (bytes.size() < 30 || local > bytes.size() - 30
+                || le32(bytes.data() + local) != 0x04034b50) {
+                emit(std::move(member), "Invalid zip local header");
+                continue;
+            }
+            const u64 start = local + 30 + le16(bytes.data() + local + 26)
+                              + le16(bytes.data() + local + 28);
+            if (start > bytes.size() || entry.packed_size > bytes.size() - start) {
+                emit(std::move(member), "Zip member data out of range");
+                continue;
+            }
+            member.packed = bytes.subspan(start, entry.packed_size);
+            emit(std::move(member));
+        }
+    }
+
+    /// The raw MIDI bytes of a member, inflated into ``buffer`` when needed.
+    static std::span<const u8> unpack(const Member& member, vec<u8>& buffer) {
+        if (!member.zipped) return member.owned;
+        if (member.flags & 1) throw std::runtime_error("Encrypted zip members are not supported");
+        std::span<const u8> bytes;
+        if (member.method == 0) {
+            bytes = member.packed;
+        } else if (member.method == 8) {
+            buffer = details::inflate(member.packed, member.size);
+            bytes  = buffer;
+        } else {
+            throw std::runtime_error(
+                fmt::format("Unsupported zip compression method {}", member.method)
+            );
+        }
+        if (bytes.size() != member.size || details::crc32(bytes) != member.crc) {
+            throw std::runtime_error("Corrupted zip member: checksum mismatch");
+        }
+        return bytes;
+    }
+
+    void parse_loop() {
+        MidiParser parser;
+        vec<u8>    buffer;
+        while (auto item = pipeline.pop()) {
+            auto& [i, member] = *item;
+            ArchiveItem<T> result{i, std::move(member.name), {}};
+            try {
+                const auto bytes = unpack(member, buffer);
+                result.result.value.emplace(parser.template parse<T>(bytes, options));
+            } catch (const std::exception& e) {
+                result.result.error = e.what();
+            } catch (...) { result.result.error = "Unknown error while parsing " + result.name; }
+            pipeline.fill(i, std::move(result));
+        }
+    }
+};
+
+template<TType T>
+ArchiveReader<T>::ArchiveReader(
+    const std::filesystem::path& path, const ArchiveOptions& options
+) :
+    impl(std::make_unique<Impl>(path, options)) {}
+
+template<TType T>
+ArchiveReader<T>::ArchiveReader(ArchiveReader&&) noexcept = default;
+
+template<TType T>
+ArchiveReader<T>& ArchiveReader<T>::operator=(ArchiveReader&&) noexcept = default;
+
+template<TType T>
+ArchiveReader<T>::~ArchiveReader() = default;
+
+template<TType T>
+std::optional<ArchiveItem<T>> ArchiveReader<T>::next() {
+    auto item = impl->pipeline.take();
+    if (!item) return std::nullopt;
+    return std::move(item->second);
+}
+
+template<TType T>
+size_t ArchiveReader<T>::num_consumed() const {
+    return impl->pipeline.num_taken();
+}
+
+#define INSTANTIATE_ARCHIVE_READER(__COUNT, T) template class ArchiveReader<T>;
+
+REPEAT_ON(INSTANTIATE_ARCHIVE_READER, Tick, Quarter, Second)
+#undef INSTANTIATE_ARCHIVE_READER
+
+}   // namespace symusic
@@ -0,0 +1,126 @@
+//
+// Batch loading and writing of score files on a native thread pool.
+//
+
+#include <stdexcept>
+
+#include "MetaMacro.h"
+
+#include "symusic/score.h"
+#include "symusic/io/batch.h"
+#include "symusic/io/common.h"
+#include "symusic/io/midi_parser.h"
+#include "symusic/detail/parallel.h"
+
+namespace symusic {
+
+namespace details {
+
+template<TType T>
+vec<LoadResult<Score<T>>> parse_midi_many(
+    const std::span<const std::filesystem::path> paths, const ParseOptions& options
+) {
+    vec<LoadResult<Score<T>>> results(paths.size());
+
+    ParseOptions file_options = options;
+    file_options.num_threads  = 1;
+
+    // One parser per worker, so its scratch state is reused for every file that worker parses.
+    vec<MidiParser> parsers(resolve_num_threads(options.num_threads, paths.size()));
+
+    // Every item writes to its own slot, so no synchronisation is needed beyond the join.
+    const auto load = [&](const size_t worker, const size_t i) {
+        auto& result = results[i];
+        try {
+            const MappedFile file(paths[i]);
+            result.value.emplace(parsers[worker].template parse<T>(file.bytes(), file_options));
+        } catch (const std::exception& e) {
+            result.error = e.what();
+        } catch (...) {
+            result.error = "Unknown error while parsing " + paths[i].string();
+        }
+    };
+    parallel_for_workers(paths.size(), options.num_threads, load);
+    return results;
+}
+
+template<TType T>
+vec<LoadResult<vec<u8>>> dumps_midi_many(
+    const std::span<const Score<T>* const> scores, const DumpOptions& options
+) {
+    vec<LoadResult<vec<u8>>> results(scores.size());
+
+    DumpOptions score_options = options;
+    score_options.num_threads = 1;
+
+    // Every item writes to its own slot, so no synchronisation is needed beyond the join.
+    const auto encode = [&](size_t, const size_t i) {
+        auto& result = results[i];
+        try {
+            result.value.emplace(dumps<DataFormat::MIDI>(*scores[i], score_options));
+        } catch (const std::exception& e) {
+            result.error = e.what();
+        } catch (...) {
+            result.error = "Unknown error while encoding score " + std::to_string(i);
+        }
+    };
+    parallel_for_workers(scores.size(), options.num_threads, encode);
+    return results;
+}
+
+template<TType T>
+vec<std::string> dump_midi_many(
+    const std::span<const Score<T>* const>       scores,
+    const std::span<const std::filesystem::path> paths,
+    const DumpOptions&                           options
+) {
+    if (scores.size() != paths.size()) {
+        throw std::invalid_argument("dump_many: scores and paths must have the same length");
+    }
+    vec<std::string> errors(scores.size());
+
+    DumpOptions score_options = options;
+    score_options.num_threads = 1;
+
+    // Every item writes to its own slot, so no synchronisation is needed beyond the join.
+    const auto dump = [&](size_t, const size_t i) {
+        try {
+            write_file(paths[i], dumps<DataFormat::MIDI>(*scores[i], score_options));
+        } catch (const std::exception& e) {
+            errors[i] = e.what();
+        } catch (...) {
+            errors[i] = "Unknown error while writing " + paths[i].string();
+        }
+    };
+    parallel_for_workers(scores.size(), options.num_threads, dump);
+    return errors;
+}
+
+}   // namespace details
+
+#define INSTANTIATE_BATCH(__COUNT, T)                                                   \
+    template<>                                                                               \
+    vec<LoadResult<Score<T>>> parse_many<DataFormat::MIDI, Score<T>>(                        \
+        std::span<const std::filesystem::path> paths, const ParseOptions& options            \
+    ) {                                                                                      \
+        return details::parse_midi_many<T>(paths, options);                                  \
+    }                                                                                        \
+    template<>                                                                               \
+    vec<LoadResult<vec<u8>>> dumps_many<DataFormat::MIDI, Score<T>>(                         \
+        std::span<const Score<T>* const> scores, const DumpOptions& options                  \
+    ) {                                                                                      \
+        return details::dumps_midi_many<T>(scores, options);                                 \
+    }                                                                                        \
+    template<>                                                                               \
+    vec<std::string> dump_many<DataFormat::MIDI, Score<T>>(                                  \
+        std::span<const Score<T>* const>       scores,                                       \
+        std::span<const std::filesystem::path> paths,                                        \
+        const DumpOptions&                     options                                       \
+    ) {                                                                                      \
+        return details::dump_midi_many<T>(scores, paths, options);                           \
+    }
+
+REPEAT_ON(INSTANTIATE_BATCH, Tick, Quarter, Second)
+#undef INSTANTIATE_BATCH
+
+}   // namespace symusic
@@ -0,0 +1,543 @@
+//
+// Columnar binary score format (DataFormat::COLUMNAR), meant as a compact dataset cache.
+//
+// Layout, all multi-byte integers little endian:
+//
+//   header   "SYMC" | u8 version | u8 time unit (0 Tick, 1 Quarter, 2 Second) | u16 reserved
+//   score    varint(zigzag tpq) | time_signatures | key_signatures | tempos | markers
+//            varint(track count) | track*
+//   track    varint(name length) name | u8 program | u8 is_drum
+//            notes | controls | pitch_bends | pedals | lyrics
+//   events   varint(count) followed by one packed column per field, in declaration order
+//   text     the packed byte lengths, followed by the concatenated bytes
+//
+// Times are stored as the zigzag-coded difference between the bit patterns of consecutive times,
+// so sorted integer ticks and sorted positive floats both turn into small numbers. Durations,
+// keys, tempos and pitch bends are zigzag coded (floats keep their bit pattern), every other
+// field is stored as an unsigned byte value.
+//
+// A packed column is split into blocks of 128 values. Each block is one byte holding a bit width
+// w (0 to 32) and the varint block minimum, followed by ceil(128 * w / 8) bytes (fewer for the
+// last block) with the values minus the block minimum in little-endian bit order. Unlike
+// byte-oriented varints, every value of a block sits at a fixed bit offset, so decoding is a
+// branch-free loop of unaligned loads, shifts and masks.
+//
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "fmt/format.h"
+#include "MetaMacro.h"
+#include "symusic/event.h"
+#include "symusic/track.h"
+#include "symusic/score.h"
+#include "symusic/conversion.h"
+
+namespace symusic {
+
+namespace details {
+
+namespace {
+
+constexpr std::array<u8, 4> kColumnarMagic{'S', 'Y', 'M', 'C'};
+constexpr u8                kColumnarVersion = 1;
+constexpr size_t            kBlockSize       = 128;
+
+[[noreturn]] void invalid_columnar(const std::string_view what) {
+    throw std::runtime_error(fmt::format("Invalid columnar data: {}", what));
+}
+
+template<TType T>
+constexpr u8 unit_code() {
+    if constexpr (std::is_same_v<T, Tick>) return 0;
+    else if constexpr (std::is_same_v<T, Quarter>) return 1;
+    else return 2;
+}
+
+constexpr u32 zigzag(const i32 value) {
+    return (static_cast<u32>(value) << 1) ^ static_cast<u32>(value >> 31);
+}
+
+constexpr i32 unzigzag(const u32 value) {
+    return static_cast<i32>((value >> 1) ^ (0u - (value & 1u)));
+}
+
+// Durations and other unit values: zigzag for ticks, the raw bit pattern for floats.
+template<typename U>
+u32 encode_value(const U value) {
+    if constexpr (std::is_integral_v<U>) return zigzag(value);
+    else return std::bit_cast<u32>(value);
+}
+
+template<typename U>
+U decode_value(const u32 value) {
+    if constexpr (std::is_integral_v<U>) return unzigzag(value);
+    else return std::bit_cast<U>(value);
+}
+
+u64 load_u64(const u8* src) {
+    u64 word;
+    std::memcpy(&word, src, sizeof(word));
+    if constexpr (std::endian::native == std::endian::big) {
+        u64 swapped = 0;
+        for (int i = 0; i < 8; ++i) swapped |= ((word >> (8 * i)) & 0xFF) << (8 * (7 - i));
+        word = swapped;
+    }
+    return word;
+}
+
+class ColumnWriter {
+public:
+    vec<u8> out;
+
+    void byte(const u8 value) { out.push_back(value); }
+
+    void varint(u64 value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<u8>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<u8>(value));
+    }
+
+    void bytes(const std::string_view data) { out.insert(out.end(), data.begin(), data.end()); }
+
+    // Fill the scratch column with ``field(event)`` and pack it
+    template<typename Events, typename Field>
+    void column(const Events& events, Field&& field) {
+        scratch.clear();
+        for (const auto& event : events) scratch.push_back(field(event));
+        pack();
+    }
+
+    template<typename Events>
+    void times(const Events& events) {
+        scratch.clear();
+        u32 prev = 0;
+        for (const auto& event : events) {
+            const u32 bits = encode_time(event.time);
+            scratch.push_back(zigzag(static_cast<i32>(bits - prev)));
+            prev = bits;
+        }
+        pack();
+    }
+
+    template<typename Events>
+    void texts(const Events& events) {
+        column(events, [](const auto& event) { return static_cast<u32>(event.text.size()); });
+        for (const auto& event : events) bytes(event.text);
+    }
+
+private:
+    vec<u32> scratch;
+
+    template<typename U>
+    static u32 encode_time(const U time) {
+        return std::bit_cast<u32>(time);
+    }
+
+    void pack() {
+        for (size_t start = 0; start < scratch.size(); start += kBlockSize) {
+            const size_t n    = std::min(kBlockSize, scratch.size() - start);
+            const auto   last = scratch.begin() + static_cast<std::ptrdiff_t>(start + n);
+            const auto [min, max] = std::minmax_element(scratch.begin() + start, last);
+            const u32 base  = *min;
+            const u32 width = std::bit_width(*max - base);
+            out.push_back(static_cast<u8>(width));
+            varint(base);
+            if (width == 0) continue;
+
+            const size_t pos = out.size();
+            out.resize(pos + (n * width + 7) / 8);
+            u8* dst  = out.data() + pos;
+            u64 acc  = 0;
+            u32 bits = 0;
+            for (size_t i = 0; i < n; ++i) {
+                acc |= static_cast<u64>(scratch[start + i] - base) << bits;
+                bits += width;
+                while (bits >= 8) {
+                    *dst++ = static_cast<u8>(acc);
+                    acc >>= 8;
+                    bits -= 8;
+                }
+            }
+            if (bits > 0) *dst = static_cast<u8>(acc);
+        }
+    }
+};
+
+// Eight values of ``Width`` bits span exactly ``Width`` bytes, so within a group every load
+// offset and shift is a compile-time constant.
+template<u32 Width, u32... J>
+void unpack_group(const u8* src, u32* dst, const u32 base, std::integer_sequence<u32, J...>) {
+    constexpr u64 mask = (u64{1} << Width) - 1;
+    ((dst[J] = base + static_cast<u32>((load_u64(src + J * Width / 8) >> J * Width % 8) & mask)),
+     ...);
+}
+
+// Unpack ``n`` values of ``Width`` bits starting at ``src`` and add ``base``.
+template<u32 Width>
+void unpack_block(const u8* src, u32* dst, const size_t n, const u32 base) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8, src += Width) {
+        unpack_group<Width>(src, dst + i, base, std::make_integer_sequence<u32, 8>{});
+    }
+    constexpr u64 mask = (u64{1} << Width) - 1;
+    for (u32 j = 0; i < n; ++i, ++j) {
+        const u64 word = load_u64(src + j * Width / 8) >> (j * Width % 8);
+        dst[i]         = base + static_cast<u32>(word & mask);
+    }
+}
+
+using UnpackKernel = void (*)(const u8*, u32*, size_t, u32);
+
+constexpr auto kUnpackKernels = []<u32... Width>(std::integer_sequence<u32, Width...>) {
+    return std::array<UnpackKernel, sizeof...(Width)>{&unpack_block<Width>...};
+}(std::make_integer_sequence<u32, 33>{});
+
+class ColumnReader {
+public:
+    explicit ColumnReader(const std::span<const u8> bytes) :
+        cur(bytes.data()), end(bytes.data() + bytes.size()) {}
+
+    [[nodiscard]] size_t remaining() const { return static_cast<size_t>(end - cur); }
+
+    const u8* take(const size_t n) {
+        if (n > remaining()) invalid_columnar("unexpected end of data");
+        const u8* begin = cur;
+        cur += n;
+        return begin;
+    }
+
+    u8 byte() { return *take(1); }
+
+    u64 varint() {
+        u64 value = 0;
+        for (u32 shift = 0; shift < 64; shift += 7) {
+            const u8 b = byte();
+            value |= static_cast<u64>(b & 0x7F) << shift;
+            if (!(b & 0x80)) return value;
+        }
+        invalid_columnar("varint too long");
+    }
+
+    // An event count; every value of a column takes at least one byte per block
+    size_t count() {
+        const u64 n = varint();
+        if (n > remaining() * kBlockSize) invalid_columnar("event count exceeds the data size");
+        return static_cast<size_t>(n);
+    }
+
+    std::string text(const size_t size) {
+        const auto* data = reinterpret_cast<const char*>(take(size));
+        return {data, size};
+    }
+
+    vec<u32>& unpack(vec<u32>& column, const size_t n) {
+        column.resize(n);
+        u32* dst = column.data();
+        // Each value is read with an 8-byte load at its first byte. A block too close to the end of
+        // the input is copied into a padded buffer first so those loads stay in bounds.
+        std::array<u8, kBlockSize * 4 + 8> padded;
+        for (size_t start = 0; start < n; start += kBlockSize) {
+            const size_t m     = std::min(kBlockSize, n - start);
+            const u32    width = byte();
+            if (width > 32) invalid_columnar("bit width larger than 32");
+            const u32    base = static_cast<u32>(varint());
+            const size_t size = (m * width + 7) / 8;
+            const u8*    src  = take(size);
+            if (remaining() < 8) {
+                std::memcpy(padded.data(), src, size);
+                std::memset(padded.data() + size, 0, 8);
+                src = padded.data();
+            }
+            kUnpackKernels[width](src, dst + start, m, base);
+        }
+        return column;
+    }
+
+    template<typename U>
+    void times(vec<U>& out, const size_t n) {
+        unpack(scratch, n);
+        out.resize(n);
+        u32 prev = 0;
+        for (size_t i = 0; i < n; ++i) {
+            prev += static_cast<u32>(unzigzag(scratch[i]));
+            out[i] = std::bit_cast<U>(prev);
+        }
+    }
+
+    vec<u32> a, b, c;
+
+private:
+    const u8* cur;
+    const u8* end;
+    vec<u32>  scratch;
+};
+
+template<TType T>
+void write_texts(ColumnWriter& out, const pyvec<TextMeta<T>>& events) {
+    out.varint(events.size());
+    out.times(events);
+    out.texts(events);
+}
+
+template<TType T>
+void write_track(ColumnWriter& out, const Track<T>& track) {
+    out.varint(track.name.size());
+    out.bytes(track.name);
+    out.byte(track.program);
+    out.byte(track.is_drum ? 1 : 0);
+
+    using unit = typename T::unit;
+    const auto duration = [](const auto& event) { return encode_value<unit>(event.duration); };
+    const auto& notes   = *track.notes;
+    out.varint(notes.size());
+    out.times(notes);
+    out.column(notes, duration);
+    out.column(notes, [](const auto& note) {
+        return static_cast<u32>(static_cast<u8>(note.pitch));
+    });
+    out.column(notes, [](const auto& note) {
+        return static_cast<u32>(static_cast<u8>(note.velocity));
+    });
+
+    const auto& controls = *track.controls;
+    out.varint(controls.size());
+    out.times(controls);
+    out.column(controls, [](const auto& control) { return static_cast<u32>(control.number); });
+    out.column(controls, [](const auto& control) { return static_cast<u32>(control.value); });
+
+    const auto& pitch_bends = *track.pitch_bends;
+    out.varint(pitch_bends.size());
+    out.times(pitch_bends);
+    out.column(pitch_bends, [](const auto& bend) { return zigzag(bend.value); });
+
+    const auto& pedals = *track.pedals;
+    out.varint(pedals.size());
+    out.times(pedals);
+    out.column(pedals, duration);
+
+    write_texts(out, *track.lyrics);
+}
+
+template<TType T>
+vec<u8> dumps_columnar(const Score<T>& score) {
+    ColumnWriter out;
+    out.out.insert(out.out.end(), kColumnarMagic.begin(), kColumnarMagic.end());
+    out.byte(kColumnarVersion);
+    out.byte(unit_code<T>());
+    out.byte(0);
+    out.byte(0);
+    out.varint(zigzag(score.ticks_per_quarter));
+
+    const auto& time_signatures = *score.time_signatures;
+    out.varint(time_signatures.size());
+    out.times(time_signatures);
+    out.column(time_signatures, [](const auto& ts) { return static_cast<u32>(ts.numerator); });
+    out.column(time_signatures, [](const auto& ts) { return static_cast<u32>(ts.denominator); });
+
+    const auto& key_signatures = *score.key_signatures;
+    out.varint(key_signatures.size());
+    out.times(key_signatures);
+    out.column(key_signatures, [](const auto& ks) { return zigzag(ks.key); });
+    out.column(key_signatures, [](const auto& ks) {
+        return static_cast<u32>(static_cast<u8>(ks.tonality));
+    });
+
+    const auto& tempos = *score.tempos;
+    out.varint(tempos.size());
+    out.times(tempos);
+    out.column(tempos, [](const auto& tempo) { return zigzag(tempo.mspq); });
+
+    write_texts(out, *score.markers);
+
+    out.varint(score.tracks->size());
+    for (const auto& track : *score.tracks) write_track(out, *track);
+    return std::move(out.out);
+}
+
+template<TType T>
+shared<pyvec<TextMeta<T>>> read_texts(ColumnReader& in) {
+    using unit   = typename T::unit;
+    const size_t n = in.count();
+    vec<unit>    times;
+    in.times(times, n);
+    const auto& sizes = in.unpack(in.a, n);
+
+    vec<TextMeta<T>> events;
+    events.reserve(n);
+    for (size_t i = 0; i < n; ++i) events.emplace_back(times[i], in.text(sizes[i]));
+    return std::make_shared<pyvec<TextMeta<T>>>(std::move(events));
+}
+
+template<TType T>
+shared<Track<T>> read_track(ColumnReader& in) {
+    using unit = typename T::unit;
+    vec<unit>  times;
+
+    const size_t name_size = in.varint();
+    std::string  name      = in.text(name_size);
+    const u8     program   = in.byte();
+    const bool   is_drum   = in.byte() != 0;
+
+    size_t n = in.count();
+    in.times(times, n);
+    in.unpack(in.a, n);
+    in.unpack(in.b, n);
+    in.unpack(in.c, n);
+    vec<Note<T>> notes(n);
+    for (size_t i = 0; i < n; ++i) {
+        notes[i] = Note<T>(
+            times[i], decode_value<unit>(in.a[i]), static_cast<i8>(in.b[i]),
+            static_cast<i8>(in.c[i])
+        );
+    }
+
+    n = in.count();
+    in.times(times, n);
+    in.unpack(in.a, n);
+    in.unpack(in.b, n);
+    vec<ControlChange<T>> controls(n);
+    for (size_t i = 0; i < n; ++i) {
+        controls[i]
+            = ControlChange<T>(times[i], static_cast<u8>(in.a[i]), static_cast<u8>(in.b[i]));
+    }
+
+    n = in.count();
+    in.times(times, n);
+    in.unpack(in.a, n);
+    vec<PitchBend<T>> pitch_bends(n);
+    for (size_t i = 0; i < n; ++i) pitch_bends[i] = PitchBend<T>(times[i], unzigzag(in.a[i]));
+
+    n = in.count();
+    in.times(times, n);
+    in.unpack(in.a, n);
+    vec<Pedal<T>> pedals(n);
+    for (size_t i = 0; i < n; ++i) pedals[i] = Pedal<T>(times[i], decode_value<unit>(in.a[i]));
+
+    auto lyrics = read_texts<T>(in);
+    return std::make_shared<Track<T>>(
+        std::move(name), program, is_drum,
+        std::make_shared<pyvec<Note<T>>>(std::move(notes)),
+        std::make_shared<pyvec<ControlChange<T>>>(std::move(controls)),
+        std::make_shared<pyvec<PitchBend<T>>>(std::move(pitch_bends)),
+        std::make_shared<pyvec<Pedal<T>>>(std::move(pedals)), std::move(lyrics)
+    );
+}
+
+template<TType T>
+Score<T> read_score(ColumnReader& in) {
+    using unit = typename T::unit;
+    vec<unit>  times;
+    const i32  tpq = unzigzag(static_cast<u32>(in.varint()));
+
+    size_t n = in.count();
+    in.times(times, n);
+    in.unpack(in.a, n);
+    in.unpack(in.b, n);
+    vec<TimeSignature<T>> time_signatures(n);
+    for (size_t i = 0; i < n; ++i) {
+        time_signatures[i]
+            = TimeSignature<T>(times[i], static_cast<u8>(in.a[i]), static_cast<u8>(in.b[i]));
+    }
+
+    n = in.count();
+    in.times(times, n);
+    in.unpack(in.a, n);
+    in.unpack(in.b, n);
+    vec<KeySignature<T>> key_signatures(n);
+    for (size_t i = 0; i < n; ++i) {
+        key_signatures[i] = KeySignature<T>(
+            times[i], static_cast<i8>(unzigzag(in.a[i])), static_cast<i8>(in.b[i])
+        );
+    }
+
+    n = in.count();
+    in.times(times, n);
+    in.unpack(in.a, n);
+    vec<Tempo<T>> tempos(n);
+    for (size_t i = 0; i < n; ++i) tempos[i] = Tempo<T>(times[i], unzigzag(in.a[i]));
+
+    auto markers = read_texts<T>(in);
+
+    const size_t num_tracks = in.count();
+    auto         tracks     = std::make_shared<vec<shared<Track<T>>>>();
+    tracks->reserve(num_tracks);
+    for (size_t i = 0; i < num_tracks; ++i) tracks->push_back(read_track<T>(in));
+    if (in.remaining() != 0) invalid_columnar("trailing bytes after the score");
+
+    return {
+        tpq,
+        std::move(tracks),
+        std::make_shared<pyvec<TimeSignature<T>>>(std::move(time_signatures)),
+        std::make_shared<pyvec<KeySignature<T>>>(std::move(key_signatures)),
+        std::make_shared<pyvec<Tempo<T>>>(std::move(tempos)),
+        std::move(markers)
+    };
+}
+
+template<TType To, TType From>
+Score<To> read_score_as(ColumnReader& in) {
+    if constexpr (std::is_same_v<To, From>) return read_score<From>(in);
+    else return convert<To>(read_score<From>(in));
+}
+
+// A score stored in another time unit is decoded in that unit and converted.
+template<TType T>
+Score<T> parse_columnar(const std::span<const u8> bytes) {
+    ColumnReader in(bytes);
+    const u8*    magic = in.take(kColumnarMagic.size());
+    if (!std::equal(kColumnarMagic.begin(), kColumnarMagic.end(), magic)) {
+        invalid_columnar("missing SYMC header");
+    }
+    if (const u8 version = in.byte(); version != kColumnarVersion) {
+        throw std::runtime_error(fmt::format(
+            "Unsupported columnar format version {} (this build reads version {})", version,
+            kColumnarVersion
+        ));
+    }
+    const u8 unit = in.byte();
+    in.take(2);
+    switch (unit) {
+    case unit_code<Tick>(): return read_score_as<T, Tick>(in);
+    case unit_code<Quarter>(): return read_score_as<T, Quarter>(in);
+    case unit_code<Second>(): return read_score_as<T, Second>(in);
+    default: invalid_columnar("unknown time unit");
+    }
+}
+
+}   // namespace
+
+}   // namespace details
+
+#define INSTANTIATE_COLUMNAR(__COUNT, T)                                              \
+    template<>                                                                        \
+    template<>                                                                        \
+    vec<u8> Score<T>::dumps<DataFormat::COLUMNAR>() const {                           \
+        return details::dumps_columnar(*this);                                        \
+    }                                                                                 \
+    template<>                                                                        \
+    template<>                                                                        \
+    Score<T> Score<T>::parse<DataFormat::COLUMNAR>(std::span<const u8> bytes) {       \
+        return details::parse_columnar<T>(bytes);                                     \
+    }                                                                                 \
+    template<>                                                                        \
+    vec<u8> dumps<DataFormat::COLUMNAR>(const Score<T>& data) {                       \
+        return data.dumps<DataFormat::COLUMNAR>();                                    \
+    }                                                                                 \
+    template<>                                                                        \
+    Score<T> parse<DataFormat::COLUMNAR>(std::span<const u8> bytes) {                 \
+        return Score<T>::parse<DataFormat::COLUMNAR>(bytes);                          \
+    }
+
+REPEAT_ON(INSTANTIATE_COLUMNAR, Tick, Quarter, Second)
+
+#undef INSTANTIATE_COLUMNAR
+
+}   // namespace symusic
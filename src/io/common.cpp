@@ -5,6 +5,7 @@
 #include <stdexcept>
 
 #include <span>
+#include <utility>
 
 #include "fmt/core.h"
 
@@ -15,7 +16,21 @@
 #endif
 
 #ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
 #include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
 
 namespace {
 
@@ -105,10 +120,12 @@ void write_file(const std::string& path, const std::span<const u8> buffer) {
     }
 #endif
     if (fp == nullptr) {
-        throw std::runtime_error("File not found");
+        throw std::runtime_error(fmt::format("File not found: {}", path));
+    }
+    const size_t written = fwrite(buffer.data(), 1, buffer.size(), fp);
+    if (fclose(fp) != 0 || written != buffer.size()) {
+        throw std::runtime_error(fmt::format("Failed to write file: {}", path));
     }
-    fwrite(buffer.data(), 1, buffer.size(), fp);
-    fclose(fp);
 }
 
 void write_file(const std::filesystem::path& path, const std::span<const u8> buffer) {
@@ -123,9 +140,97 @@ void write_file(const std::filesystem::path& path, const std::span<const u8> buf
             fmt::format("File not found file (error:{}): {}", err, path_to_utf8(path))
         );
     }
-    fwrite(buffer.data(), 1, buffer.size(), fp);
-    fclose(fp);
+    const size_t written = fwrite(buffer.data(), 1, buffer.size(), fp);
+    if (fclose(fp) != 0 || written != buffer.size()) {
+        throw std::runtime_error(fmt::format("Failed to write file: {}", path_to_utf8(path)));
+    }
+#endif
+}
+
+MappedFile::MappedFile(const std::filesystem::path& path) {
+#ifndef _WIN32
+    const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error(fmt::format("File not found file: {}", path.string()));
+    }
+    struct stat info{};
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+        const auto size = static_cast<size_t>(info.st_size);
+        void*      map  = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map != MAP_FAILED) {
+            // the parser reads every chunk front to back
+            madvise(map, size, MADV_SEQUENTIAL);
+            mapping = map;
+            view    = static_cast<const u8*>(map);
+            length  = size;
+        }
+    }
+    close(fd);
+    if (mapping != nullptr) return;
+#else
+    HANDLE file = CreateFileW(
+        path.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+        nullptr
+    );
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error(fmt::format("File not found file: {}", path_to_utf8(path)));
+    }
+    LARGE_INTEGER size{};
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+        HANDLE section = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (section != nullptr) {
+            // the view keeps the section alive after its handle is closed
+            void* map = MapViewOfFile(section, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(section);
+            if (map != nullptr) {
+                mapping = map;
+                view    = static_cast<const u8*>(map);
+                length  = static_cast<size_t>(size.QuadPart);
+            }
+        }
+    }
+    CloseHandle(file);
+    if (mapping != nullptr) return;
 #endif
+    // empty and unmappable files are read the usual way
+    fallback = read_file(path);
+    view     = fallback.data();
+    length   = fallback.size();
+}
+
+MappedFile::~MappedFile() { release(); }
+
+MappedFile::MappedFile(MappedFile&& other) noexcept { *this = std::move(other); }
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        release();
+        mapping  = std::exchange(other.mapping, nullptr);
+        fallback = std::move(other.fallback);
+        length   = std::exchange(other.length, 0);
+        view     = mapping != nullptr ? std::exchange(other.view, nullptr) : fallback.data();
+        other.view = nullptr;
+    }
+    return *this;
+}
+
+void MappedFile::release() noexcept {
+    if (mapping != nullptr) {
+#ifndef _WIN32
+        munmap(mapping, length);
+#else
+        UnmapViewOfFile(mapping);
+#endif
+        mapping = nullptr;
+    }
+    fallback.clear();
+    view   = nullptr;
+    length = 0;
 }
 
 }   // namespace symusic
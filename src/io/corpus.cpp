@@ -0,0 +1,161 @@
+//
+// Read-ahead pipeline: I/O threads feed parsing workers through a bounded queue.
+//
+
+#include <stdexcept>
+#include <utility>
+
+#include "fmt/core.h"
+#include "MetaMacro.h"
+
+#include "symusic/io/corpus.h"
+#include "symusic/io/common.h"
+#include "symusic/io/midi_parser.h"
+#include "symusic/detail/parallel.h"
+#include "symusic/detail/pipeline.h"
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace symusic {
+
+namespace {
+
+/**
+ * Read a whole file into memory. The kernel is told up front that the file will be read in full,
+ * so it can fetch it in large requests instead of growing its read-ahead window step by step.
+ */
+vec<u8> read_whole_file(const std::filesystem::path& path) {
+#ifndef _WIN32
+    const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error(fmt::format("File not found file: {}", path.string()));
+    }
+    struct stat info{};
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+        // pipes and special files have no size to read up to
+        close(fd);
+        return read_file(path);
+    }
+#ifdef POSIX_FADV_WILLNEED
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+#endif
+    vec<u8> buffer(static_cast<size_t>(info.st_size));
+    size_t  filled = 0;
+    while (filled < buffer.size()) {
+        const ssize_t got = read(fd, buffer.data() + filled, buffer.size() - filled);
+        if (got < 0 && errno == EINTR) continue;
+        if (got < 0) {
+            close(fd);
+            throw std::runtime_error(fmt::format("Failed to read file: {}", path.string()));
+        }
+        if (got == 0) break;   // truncated while reading
+        filled += static_cast<size_t>(got);
+    }
+    close(fd);
+    buffer.resize(filled);
+    return buffer;
+#else
+    return read_file(path);
+#endif
+}
+
+}   // namespace
+
+template<TType T>
+struct CorpusReader<T>::Impl {
+    vec<std::filesystem::path> paths;
+    ParseOptions               options;
+    size_t                     workers;
+
+    // declared last, so its threads are joined before the members they use are destroyed
+    details::OrderedPipeline<vec<u8>, LoadResult<Score<T>>> pipeline;
+
+    Impl(vec<std::filesystem::path> paths_, const CorpusOptions& corpus_options) :
+        paths(std::move(paths_)),
+        options(corpus_options.parse),
+        workers(details::resolve_num_threads(options.num_threads, paths.size())),
+        pipeline(
+            corpus_options.prefetch == 0 ? 4 * workers : corpus_options.prefetch,
+            details::resolve_num_threads(corpus_options.io_threads, paths.size()),
+            paths.size()
+        ) {
+        options.num_threads = 1;
+        if (paths.empty()) return;
+
+        const size_t io = details::resolve_num_threads(corpus_options.io_threads, paths.size());
+        for (size_t i = 0; i < io; ++i) { pipeline.spawn([this] { read_loop(); }); }
+        for (size_t i = 0; i < workers; ++i) { pipeline.spawn([this] { parse_loop(); }); }
+    }
+
+    void read_loop() {
+        while (const auto index = pipeline.claim()) {
+            const size_t i = *index;
+            LoadResult<Score<T>> failure;
+            try {
+                pipeline.submit(i, read_whole_file(paths[i]));
+                continue;
+            } catch (const std::exception& e) {
+                failure.error = e.what();
+            } catch (...) { failure.error = "Unknown error while reading " + paths[i].string(); }
+            pipeline.fill(i, std::move(failure));
+        }
+        pipeline.producer_done();
+    }
+
+    void parse_loop() {
+        MidiParser parser;
+        while (auto item = pipeline.pop()) {
+            const auto& [i, bytes] = *item;
+            LoadResult<Score<T>> result;
+            try {
+                result.value.emplace(parser.template parse<T>(bytes, options));
+            } catch (const std::exception& e) {
+                result.error = e.what();
+            } catch (...) { result.error = "Unknown error while parsing " + paths[i].string(); }
+            pipeline.fill(i, std::move(result));
+        }
+    }
+};
+
+template<TType T>
+CorpusReader<T>::CorpusReader(vec<std::filesystem::path> paths, const CorpusOptions& options) :
+    impl(std::make_unique<Impl>(std::move(paths), options)) {}
+
+template<TType T>
+CorpusReader<T>::CorpusReader(CorpusReader&&) noexcept = default;
+
+template<TType T>
+CorpusReader<T>& CorpusReader<T>::operator=(CorpusReader&&) noexcept = default;
+
+template<TType T>
+CorpusReader<T>::~CorpusReader() = default;
+
+template<TType T>
+std::optional<CorpusItem<T>> CorpusReader<T>::next() {
+    auto item = impl->pipeline.take();
+    if (!item) return std::nullopt;
+    return CorpusItem<T>{item->first, impl->paths[item->first], std::move(item->second)};
+}
+
+template<TType T>
+size_t CorpusReader<T>::size() const {
+    return impl->paths.size();
+}
+
+template<TType T>
+size_t CorpusReader<T>::num_consumed() const {
+    return impl->pipeline.num_taken();
+}
+
+#define INSTANTIATE_CORPUS_READER(__COUNT, T) template class CorpusReader<T>;
+
+REPEAT_ON(INSTANTIATE_CORPUS_READER, Tick, Quarter, Second)
+#undef INSTANTIATE_CORPUS_READER
+
+}   // namespace symusic
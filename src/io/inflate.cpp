@@ -0,0 +1,401 @@
+//
+// DEFLATE, gzip and CRC-32 decoding for reading compressed archives without external libraries.
+//
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include "fmt/core.h"
+
+#include "symusic/detail/inflate.h"
+
+namespace symusic::details {
+
+namespace {
+
+constexpr std::array<u32, 256> make_crc_table() {
+    std::array<u32, 256> table{};
+    for (u32 i = 0; i < 256; ++i) {
+        u32 crc = i;
+        for (int k = 0; k < 8; ++k) { crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1; }
+        table[i] = crc;
+    }
+    return table;
+}
+
+constexpr auto kCrcTable = make_crc_table();
+
+[[noreturn]] void corrupted(const char* what) {
+    throw std::runtime_error(fmt::format("Invalid deflate stream: {}", what));
+}
+
+constexpr u32 kMaxBits  = 15;
+constexpr u32 kFastBits = 10;
+
+// The last 32 KiB of output may be referenced by later matches, everything before it is flushed
+// once the buffer has grown past ``kFlushSize``.
+constexpr size_t kWindowSize = 32768;
+constexpr size_t kFlushSize  = 256 * 1024 + kWindowSize;
+
+constexpr std::array<u16, 29> kLengthBase{3,  4,  5,  6,  7,  8,  9,  10,  11,  13,
+                                          15, 17, 19, 23, 27, 31, 35, 43,  51,  59,
+                                          67, 83, 99, 115, 131, 163, 195, 227, 258};
+constexpr std::array<u8, 29> kLengthExtra{0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                          2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+constexpr std::array<u16, 30> kDistBase{1,    2,    3,    4,    5,    7,     9,     13,
+                                        17,   25,   33,   49,   65,   97,    129,   193,
+                                        257,  385,  513,  769,  1025, 1537,  2049,  3073,
+                                        4097, 6145, 8193, 12289, 16385, 24577};
+constexpr std::array<u8, 30> kDistExtra{0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+                                        6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+constexpr std::array<u8, 19> kCodeLengthOrder{16, 17, 18, 0, 8,  7, 9,  6, 10, 5,
+                                              11, 4,  12, 3, 13, 2, 14, 1, 15};
+
+/// Least-significant-bit-first reader over the compressed bytes.
+class BitReader {
+public:
+    explicit BitReader(const std::span<const u8> input) :
+        begin(input.data()), cursor(input.data()), end(input.data() + input.size()) {}
+
+    void refill() {
+        while (count <= 56 && cursor < end) {
+            buffer |= static_cast<u64>(*cursor++) << count;
+            count += 8;
+        }
+    }
+
+    /// The next ``n`` bits, zero-padded past the end of the input.
+    [[nodiscard]] u32 peek(const u32 n) const {
+        return static_cast<u32>(buffer & ((u64{1} << n) - 1));
+    }
+
+    [[nodiscard]] u32 available() const { return count; }
+
+    void drop(const u32 n) {
+        buffer >>= n;
+        count -= n;
+    }
+
+    u32 bits(const u32 n) {
+        if (count < n) {
+            refill();
+            if (count < n) corrupted("unexpected end of data");
+        }
+        const u32 value = peek(n);
+        drop(n);
+        return value;
+    }
+
+    void align() { drop(count % 8); }
+
+    /// Copy ``size`` whole bytes after ``align()``.
+    void copy(u8* out, size_t size) {
+        while (size > 0 && count >= 8) {
+            *out++ = static_cast<u8>(buffer);
+            drop(8);
+            --size;
+        }
+        if (static_cast<size_t>(end - cursor) < size) corrupted("unexpected end of data");
+        std::memcpy(out, cursor, size);
+        cursor += size;
+    }
+
+    /// Bytes read so far, counting a partially consumed byte as read.
+    [[nodiscard]] size_t consumed() const {
+        return static_cast<size_t>(cursor - begin) - count / 8;
+    }
+
+private:
+    const u8* begin;
+    const u8* cursor;
+    const u8* end;
+    u64       buffer = 0;
+    u32       count  = 0;
+};
+
+/**
+ * Canonical Huffman code. Codes of up to ``kFastBits`` bits are resolved with one table lookup on
+ * the bit-reversed input, longer ones by walking the code lengths as in zlib's ``puff``.
+ */
+struct Huffman {
+    std::array<u16, kMaxBits + 1>   count{};
+    std::array<u16, 288>            symbol{};
+    std::array<u16, 1 << kFastBits> fast{};   // (symbol << 4) | length, 0 if not a short code
+
+    void build(const u8* lengths, const u32 num_symbols) {
+        count.fill(0);
+        fast.fill(0);
+        for (u32 s = 0; s < num_symbols; ++s) { ++count[lengths[s]]; }
+        count[0] = 0;
+
+        int left = 1;
+        for (u32 len = 1; len <= kMaxBits; ++len) {
+            left = (left << 1) - count[len];
+            if (left < 0) corrupted("over-subscribed Huffman code");
+        }
+
+        std::array<u16, kMaxBits + 2> offset{};
+        std::array<u32, kMaxBits + 1> next_code{};
+        u32                           code = 0;
+        for (u32 len = 1; len <= kMaxBits; ++len) {
+            offset[len + 1] = offset[len] + count[len];
+            code            = (code + count[len - 1]) << 1;
+            next_code[len]  = code;
+        }
+        for (u32 s = 0; s < num_symbols; ++s) {
+            const u32 len = lengths[s];
+            if (len == 0) continue;
+            symbol[offset[len]++] = static_cast<u16>(s);
+            const u32 c = next_code[len]++;
+            if (len > kFastBits) continue;
+            u32 reversed = 0;
+            for (u32 b = 0; b < len; ++b) { reversed |= ((c >> b) & 1) << (len - 1 - b); }
+            for (u32 k = reversed; k < (1u << kFastBits); k += 1u << len) {
+                fast[k] = static_cast<u16>((s << 4) | len);
+            }
+        }
+    }
+
+    u32 decode(BitReader& in) const {
+        in.refill();
+        if (const u16 entry = fast[in.peek(kFastBits)]; entry != 0) {
+            const u32 len = entry & 15;
+            if (len > in.available()) corrupted("unexpected end of data");
+            in.drop(len);
+            return entry >> 4;
+        }
+        int code = 0, first = 0, index = 0;
+        for (u32 len = 1; len <= kMaxBits; ++len) {
+            code |= static_cast<int>(in.bits(1));
+            const int n = count[len];
+            if (code - n < first) return symbol[index + (code - first)];
+            index += n;
+            first = (first + n) << 1;
+            code <<= 1;
+        }
+        corrupted("invalid Huffman code");
+    }
+};
+
+class Inflater {
+public:
+    Inflater(
+        const std::span<const u8> input,
+        vec<u8>&                  out,
+        const ByteSink*           sink,
+        const size_t              limit = std::numeric_limits<size_t>::max()
+    ) : in(input), out(out), sink(sink), limit(limit) {}
+
+    size_t run() {
+        bool last = false;
+        while (!last) {
+            last            = in.bits(1) != 0;
+            const u32 type  = in.bits(2);
+            if (type == 0) {
+                stored();
+            } else if (type == 1) {
+                fixed();
+            } else if (type == 2) {
+                dynamic();
+            } else {
+                corrupted("invalid block type");
+            }
+        }
+        if (sink != nullptr && !out.empty()) { (*sink)(out); }
+        return in.consumed();
+    }
+
+private:
+    BitReader       in;
+    vec<u8>&        out;
+    const ByteSink* sink;
+    size_t          limit;   // most bytes ``out`` may hold
+    Huffman         lengths, distances;
+
+    /// Make sure ``count`` more bytes fit in the output before producing them.
+    void ensure_room(const size_t count) const {
+        if (count > limit - out.size()) corrupted("output larger than declared");
+    }
+
+    void flush() {
+        if (sink == nullptr || out.size() < kFlushSize) return;
+        const size_t ready = out.size() - kWindowSize;
+        (*sink)(std::span<const u8>(out.data(), ready));
+        std::memmove(out.data(), out.data() + ready, kWindowSize);
+        out.resize(kWindowSize);
+    }
+
+    void stored() {
+        in.align();
+        const u32 len  = in.bits(16);
+        const u32 nlen = in.bits(16);
+        if ((len ^ 0xFFFF) != nlen) corrupted("stored block length mismatch");
+        ensure_room(len);
+        const size_t pos = out.size();
+        out.resize(pos + len);
+        in.copy(out.data() + pos, len);
+        flush();
+    }
+
+    void fixed() {
+        std::array<u8, 288> code_lengths{};
+        std::fill_n(code_lengths.begin(), 144, u8{8});
+        std::fill_n(code_lengths.begin() + 144, 112, u8{9});
+        std::fill_n(code_lengths.begin() + 256, 24, u8{7});
+        std::fill_n(code_lengths.begin() + 280, 8, u8{8});
+        lengths.build(code_lengths.data(), 288);
+        std::fill_n(code_lengths.begin(), 30, u8{5});
+        distances.build(code_lengths.data(), 30);
+        codes();
+    }
+
+    void dynamic() {
+        const u32 num_lengths   = in.bits(5) + 257;
+        const u32 num_distances = in.bits(5) + 1;
+        const u32 num_codes     = in.bits(4) + 4;
+        if (num_lengths > 286 || num_distances > 30) corrupted("too many length or distance codes");
+
+        std::array<u8, 320> code_lengths{};
+        for (u32 i = 0; i < num_codes; ++i) {
+            code_lengths[kCodeLengthOrder[i]] = static_cast<u8>(in.bits(3));
+        }
+        Huffman meta;
+        meta.build(code_lengths.data(), 19);
+
+        code_lengths.fill(0);
+        for (u32 i = 0; i < num_lengths + num_distances;) {
+            const u32 symbol = meta.decode(in);
+            if (symbol < 16) {
+                code_lengths[i++] = static_cast<u8>(symbol);
+                continue;
+            }
+            u8  value  = 0;
+            u32 repeat = 0;
+            if (symbol == 16) {
+                if (i == 0) corrupted("repeated length without a previous length");
+                value  = code_lengths[i - 1];
+                repeat = 3 + in.bits(2);
+            } else if (symbol == 17) {
+                repeat = 3 + in.bits(3);
+            } else {
+                repeat = 11 + in.bits(7);
+            }
+            if (i + repeat > num_lengths + num_distances) corrupted("too many code lengths");
+            while (repeat-- > 0) { code_lengths[i++] = value; }
+        }
+        if (code_lengths[256] == 0) corrupted("missing end-of-block code");
+        lengths.build(code_lengths.data(), num_lengths);
+        distances.build(code_lengths.data() + num_lengths, num_distances);
+        codes();
+    }
+
+    void codes() {
+        for (;;) {
+            const u32 symbol = lengths.decode(in);
+            if (symbol < 256) {
+                ensure_room(1);
+                out.push_back(static_cast<u8>(symbol));
+                if (out.size() >= kFlushSize) flush();
+                continue;
+            }
+            if (symbol == 256) return;
+            const u32 length_code = symbol - 257;
+            if (length_code >= kLengthBase.size()) corrupted("invalid length code");
+            const u32 length = kLengthBase[length_code] + in.bits(kLengthExtra[length_code]);
+
+            const u32 dist_code = distances.decode(in);
+            if (dist_code >= kDistBase.size()) corrupted("invalid distance code");
+            const u32 dist = kDistBase[dist_code] + in.bits(kDistExtra[dist_code]);
+            if (dist > out.size()) corrupted("distance too far back");
+
+            ensure_room(length);
+            const size_t pos = out.size();
+            out.resize(pos + length);
+            u8* dst = out.data() + pos;
+            const u8* src = dst - dist;
+            // byte by byte, as a match may overlap the bytes it produces
+            for (u32 k = 0; k < length; ++k) { dst[k] = src[k]; }
+            if (out.size() >= kFlushSize) flush();
+        }
+    }
+};
+
+u32 read_le32(const u8* p) {
+    return static_cast<u32>(p[0]) | static_cast<u32>(p[1]) << 8 | static_cast<u32>(p[2]) << 16
+           | static_cast<u32>(p[3]) << 24;
+}
+
+}   // namespace
+
+u32 crc32(const std::span<const u8> bytes, u32 crc) {
+    crc = ~crc;
+    for (const u8 byte : bytes) { crc = kCrcTable[(crc ^ byte) & 0xFF] ^ (crc >> 8); }
+    return ~crc;
+}
+
+size_t inflate(const std::span<const u8> input, const ByteSink& sink) {
+    vec<u8> out;
+    out.reserve(kFlushSize);
+    return Inflater(input, out, &sink).run();
+}
+
+vec<u8> inflate(const std::span<const u8> input, const size_t max_size) {
+    vec<u8> out;
+    // max_size may come from an untrusted header; DEFLATE expands at most 1032 times
+    out.reserve(std::min(max_size, input.size() * 1032));
+    Inflater(input, out, nullptr, max_size).run();
+    return out;
+}
+
+void gunzip(const std::span<const u8> input, const ByteSink& sink) {
+    size_t pos = 0;
+    // a member starts with the magic bytes; anything else after the first member is padding
+    while (pos == 0 || (input.size() - pos >= 2 && input[pos] == 0x1F && input[pos + 1] == 0x8B)) {
+        const auto need = [&](const size_t n) {
+            if (input.size() - pos < n) throw std::runtime_error("Truncated gzip file");
+        };
+        need(10);
+        if (input[pos] != 0x1F || input[pos + 1] != 0x8B || input[pos + 2] != 8) {
+            throw std::runtime_error("Not a gzip file");
+        }
+        const u8 flags = input[pos + 3];
+        pos += 10;
+        if (flags & 0x04) {   // FEXTRA
+            need(2);
+            const size_t extra = input[pos] | input[pos + 1] << 8;
+            pos += 2;
+            need(extra);
+            pos += extra;
+        }
+        for (const u8 field : {u8{0x08}, u8{0x10}}) {   // FNAME, FCOMMENT
+            if (!(flags & field)) continue;
+            while (true) {
+                need(1);
+                if (input[pos++] == 0) break;
+            }
+        }
+        if (flags & 0x02) {   // FHCRC
+            need(2);
+            pos += 2;
+        }
+
+        u32    crc  = 0;
+        size_t size = 0;
+        pos += inflate(input.subspan(pos), [&](const std::span<const u8> bytes) {
+            crc = crc32(bytes, crc);
+            size += bytes.size();
+            sink(bytes);
+        });
+        need(8);
+        if (read_le32(input.data() + pos) != crc
+            || read_le32(input.data() + pos + 4) != static_cast<u32>(size)) {
+            throw std::runtime_error("Corrupted gzip file: checksum mismatch");
+        }
+        pos += 8;
+    }
+}
+
+}   // namespace symusic::details
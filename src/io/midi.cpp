@@ -2,8 +2,12 @@
 // Created by lyk on 23-12-25.
 //
 
-#include <map>
-#include <queue>
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
 
 #ifdef _MSC_VER
 #pragma warning(disable : 4996)
@@ -17,6 +21,13 @@
 #include "symusic/ops.h"
 #include "symusic/utils.h"
 #include "symusic/conversion.h"
+#include "symusic/io/common.h"
+#include "symusic/io/lazy.h"
+#include "symusic/io/midi_parser.h"
+#include "symusic/io/midi_stream.h"
+#include "symusic/detail/note_queue.h"
+#include "symusic/detail/parallel.h"
+#include "symusic/detail/time_conversion.h"
 
 namespace symusic {
 
@@ -25,14 +36,17 @@ namespace details {
 
 [[nodiscard]] bool is_valid_midi_data_byte(const uint8_t value) { return value <= 0x7F; }
 
-void ensure_valid_midi_data_byte(
+/**
+ * Validate a channel message data byte. The chunk views always hand out the raw file bytes, so
+ * this is where ``sanitize_data`` takes effect: out-of-range values are clamped to 0x7F instead of
+ * being rejected, and valid bytes pass through untouched.
+ */
+[[nodiscard]] uint8_t midi_data_byte(
     const char* const field_name, const uint8_t value, const bool sanitize_data
 ) {
-    if (!sanitize_data && !is_valid_midi_data_byte(value)) {
-        throw std::runtime_error(
-            "Get " + std::string(field_name) + "=" + std::to_string(value)
-        );
-    }
+    if (is_valid_midi_data_byte(value)) [[likely]] { return value; }
+    if (sanitize_data) { return 0x7F; }
+    throw std::runtime_error("Get " + std::string(field_name) + "=" + std::to_string(value));
 }
 
 template<typename T>
@@ -53,140 +67,167 @@ struct TrackHandler {
 
 template<typename T>
 struct NoteManager {
-    struct Slot {
-        uint32_t              count = 0;
-        uint32_t              index = 0;
-        std::vector<Note<T>>* notes = nullptr;
+    // an open note: its index in the notes of the track ``track`` of the TrackManager
+    struct Pending {
+        uint32_t index = 0;
+        uint32_t track = 0;
     };
 
-    // 16 channels * 128 pitches
-    std::array<Slot, 16 * 128> slots{};
-    // useed if multiple note is activated at the same channel and pitch
-    std::unordered_map<uint16_t, std::queue<std::pair<uint32_t, std::vector<Note<T>>*>>> overflow;
+    NoteQueue<Pending> queue;
+
+    void reset() { queue.reset(); }
 
     void add(
         const uint8_t         channel,
         uint8_t               pitch,
         typename T::unit      time,
         int8_t                velocity,
+        const uint32_t        track,
         std::vector<Note<T>>& notes
     ) {
-        const uint16_t key = channel * 128 + pitch;
         // Create a note placeholder with duration -1
         notes.emplace_back(time, -1, pitch, velocity);
-        const auto idx = notes.size() - 1;
-
-        if (Slot& slot = slots[key]; slot.count++ == 0) {
-            slot.index = idx;
-            slot.notes = &notes;
-        } else {
-            // Put the extra note into the queue
-            overflow.try_emplace(key).first->second.emplace(idx, &notes);
-        }
+        queue.push(
+            NoteQueue<Pending>::key_of(channel, pitch),
+            Pending{static_cast<uint32_t>(notes.size() - 1), track}
+        );
     }
 
-    bool end(const uint8_t channel, const uint8_t pitch, typename T::unit end_time) {
-        const uint16_t key  = channel * 128 + pitch;
-        Slot&          slot = slots[key];
-        if (slot.count == 0 || !slot.notes) return false;
+    template<typename Handlers>
+    bool end(
+        const uint8_t channel, const uint8_t pitch, typename T::unit end_time, Handlers& handlers
+    ) {
+        const uint16_t key = NoteQueue<Pending>::key_of(channel, pitch);
+        if (queue.count(key) == 0) return false;
 
         // Modify the duration of the placeholder
-        auto& note    = (*slot.notes)[slot.index];
-        note.duration = end_time - note.time;
-
-        if (--slot.count > 0) {
-            // Pop the queue if needed
-            auto& [new_idx, new_notes] = overflow[key].front();
-            slot.index                 = new_idx;
-            slot.notes                 = new_notes;
-            overflow[key].pop();
-        }
+        const Pending& pending = queue.front(key);
+        auto&          note    = handlers[pending.track].track.notes[pending.index];
+        note.duration          = end_time - note.time;
+        queue.pop(key);
         return true;
     }
-};
-
-struct TrackKey {
-    uint8_t channel;
-    uint8_t program;
 
-    bool operator==(const TrackKey& other) const {
-        return channel == other.channel && program == other.program;
-    }
-    auto operator<=>(const TrackKey& other) const {
-        return std::tie(channel, program) <=> std::tie(other.channel, other.program);
+    /// Close every open note at ``end_time``.
+    template<typename Handlers>
+    void end_all(const typename T::unit end_time, Handlers& handlers) {
+        for (const uint16_t key : queue.touched()) {
+            while (queue.count(key) > 0) end(key / 128, key % 128, end_time, handlers);
+        }
     }
 };
 
-
-
+/**
+ * Maps the (channel, program) pairs of one MTrk chunk to symusic tracks.
+ *
+ * All lookup structures are flat tables or vectors that keep their capacity, so one manager can
+ * be reused for every chunk of every file decoded by the same worker. Only the decoded tracks,
+ * which are moved into the output score, allocate.
+ */
 template<typename T>
 class TrackManager {
+    static constexpr uint16_t no_key = std::numeric_limits<uint16_t>::max();
+
     // Used to manager multiple symusic Track corresponding to a single MIDI Track
-    NoteManager<T>                      noteManager;
-    std::map<TrackKey, TrackHandler<T>> formalTracks;
+    NoteManager<T> noteManager;
+    // channel * 128 + program -> index in handlers, -1 if that track has not been created
+    std::array<int32_t, 16 * 128> track_index;
+    vec<TrackHandler<T>>          handlers;
+    vec<uint16_t>                 created_keys;
     // used to store events if a real track haven't been created
     std::array<TrackHandler<T>, 16> stragglers;
     // last track cache to accelerate track searching
-    TrackHandler<T>* lastTrack = nullptr;
-    TrackKey         lastKey{255, 255};
+    uint16_t lastKey   = no_key;
+    int32_t  lastIndex = -1;
     // used to reserve enough space when create a track
-    size_t msg_num = 0;
+    size_t note_reserve = 0;
     // the current program number for each channel
     std::array<uint8_t, 16> cur_instr{};
 
-    std::vector<Note<T>>& get_notes(uint8_t channel) { return get<false>(channel).track.notes; }
-
 public:
-    explicit TrackManager(const size_t msg_num) : msg_num(msg_num) {}
+    TrackManager() { track_index.fill(-1); }
+
+    /**
+     * Prepare the manager for a new chunk, dropping anything left over from the previous one.
+     *
+     * @param msg_num Estimated number of messages in the chunk.
+     * @param keep_notes Whether notes are decoded; skips the note reservation otherwise.
+     */
+    void reset(const size_t msg_num, const bool keep_notes = true) {
+        for (const uint16_t key : created_keys) track_index[key] = -1;
+        created_keys.clear();
+        handlers.clear();
+        for (auto& straggler : stragglers) {
+            auto& track = straggler.track;
+            track.notes.clear();
+            track.controls.clear();
+            track.pitch_bends.clear();
+            track.pedals.clear();
+            track.lyrics.clear();
+        }
+        noteManager.reset();
+        lastKey      = no_key;
+        lastIndex    = -1;
+        note_reserve = keep_notes ? msg_num / 2 + 1 : 0;
+        cur_instr.fill(0);
+    }
 
     void set_program(uint8_t channel, uint8_t program) { cur_instr[channel] = program; }
 
     template<bool create_new>
     TrackHandler<T>& get(uint8_t channel) {
-        const uint8_t  program = cur_instr[channel];
-        const TrackKey key{channel, program};
+        const uint16_t key = channel * 128 + cur_instr[channel];
 
-        if (lastTrack && lastKey == key) { return *lastTrack; }
+        if (lastKey == key) { return handlers[lastIndex]; }
 
-        if (auto it = formalTracks.find(key); it != formalTracks.end()) {
+        if (const int32_t index = track_index[key]; index >= 0) {
             lastKey   = key;
-            lastTrack = &it->second;
-            return *lastTrack;
+            lastIndex = index;
+            return handlers[index];
         }
         // Only create real track if handling notes or lyrics
         auto& straggler = stragglers[channel];
         if constexpr (!create_new) return straggler;
 
-        straggler.track.program = program;
+        straggler.track.program = cur_instr[channel];
         straggler.track.is_drum = channel == 9;
 
-        auto [iter, inserted] = formalTracks.try_emplace(key, std::move(straggler));
-
+        const auto index = static_cast<int32_t>(handlers.size());
+        handlers.push_back(std::move(straggler));
         stragglers[channel] = TrackHandler<T>();
+        track_index[key]    = index;
+        created_keys.push_back(key);
 
-        auto& newTrack = iter->second;
-        newTrack.track.notes.reserve(msg_num / 2 + 1);
+        auto& newTrack = handlers.back();
+        if (note_reserve > 0) newTrack.track.notes.reserve(note_reserve);
         lastKey   = key;
-        lastTrack = &newTrack;
-        return *lastTrack;
+        lastIndex = index;
+        return newTrack;
     }
 
     void add_note(uint8_t channel, uint8_t pitch, typename T::unit time, int8_t velocity) {
         // Add a note placeholder with duration == -1
         // This strategy removes the need for sorting the notes
         auto& track = get<true>(channel).track;
-        noteManager.add(channel, pitch, time, velocity, track.notes);
+        noteManager.add(
+            channel, pitch, time, velocity, static_cast<uint32_t>(lastIndex), track.notes
+        );
     }
 
     bool end_note(uint8_t channel, uint8_t pitch, typename T::unit end_time) {
         // Close a note on event (modify the note placeholder)
-        return noteManager.end(channel, pitch, end_time);
+        return noteManager.end(channel, pitch, end_time, handlers);
     }
 
+    void end_all_notes(typename T::unit end_time) { noteManager.end_all(end_time, handlers); }
+
     void finalize(ScoreNative<T>& score, const std::string& name) {
-        // Remove invalid placeholder (duration == -1)
-        for (auto& [_, handler] : formalTracks) {
+        // emit tracks ordered by (channel, program)
+        std::sort(created_keys.begin(), created_keys.end());
+        for (const uint16_t key : created_keys) {
+            auto& handler = handlers[track_index[key]];
             if (!handler.track.empty()) {
+                // Remove invalid placeholder (duration == -1)
                 auto& notes = handler.track.notes;
                 notes.erase(
                     std::remove_if(
@@ -202,341 +243,509 @@ public:
     }
 };
 
+/// Convert a window bound to ``T::unit``, saturating for integer units.
+template<TType T>
+typename T::unit window_bound(const f64 value) {
+    using unit = typename T::unit;
+    if constexpr (std::is_integral_v<unit>) {
+        constexpr auto lowest  = static_cast<f64>(std::numeric_limits<unit>::lowest());
+        constexpr auto highest = static_cast<f64>(std::numeric_limits<unit>::max());
+        return static_cast<unit>(std::clamp(value, lowest, highest));
+    } else {
+        return static_cast<unit>(value);
+    }
+}
+
 /**
- * Parse the given MIDI view while optionally sanitizing payload bytes prior to decoding.
+ * Decode a single MTrk chunk, appending its tracks and score-level meta events to ``score``.
  *
- * @param midi MIDI view produced by minimidi.
- * @param tick2unit Converter that maps MIDI ticks to the desired time unit.
- * @param sanitize_data Clamp payload bytes to the 7-bit MIDI range before parsing.
+ * Each chunk owns its running status, program state and pending notes, so chunks can be decoded
+ * independently and in any order as long as the results are merged back in file order.
+ *
+ * @param midi_track Track view produced by minimidi.
+ * @param tick2unit Converter that maps MIDI ticks to the desired time unit. It is taken by value
+ *        so that stateful converters (e.g. a tempo-map cursor) start fresh for every chunk.
+ * @param options Sanitization, projection and window settings. Event classes that are not kept
+ *        are skipped before any validation or allocation; CC64 is still tracked for pedals. With a
+ *        window, the chunk is left as soon as the running time passes its end, and controls,
+ *        pitch bends, lyrics and markers before its start are not stored. Notes and meta events
+ *        are kept for ``apply_window``, which needs them for the boundary modes and sentinels.
+ * @param trackManager Scratch state, reset here so that it can be reused across chunks.
+ * @param score Destination for decoded tracks and meta events.
  */
-template<TType T, typename Conv, typename Container>   // only works for Tick and Quarter
-    requires(std::is_same_v<T, Tick> || std::is_same_v<T, Quarter>)
-[[nodiscard]] Score<T> parse_midi(
-    const minimidi::MidiFileView<Container>& midi, Conv tick2unit, bool sanitize_data = false
+template<TType T, typename Conv, typename Container>
+void parse_track(
+    const minimidi::TrackView<Container>& midi_track,
+    Conv                                  tick2unit,
+    const ParseOptions&                   options,
+    TrackManager<T>&                      trackManager,
+    ScoreNative<T>&                       score
 ) {
     typedef typename T::unit unit;
-    // remove this redundant copy in the future
-    const u16      tpq = midi.ticks_per_quarter();
-    ScoreNative<T> score(tpq);   // create a score with the given ticks per quarter
-    int            count = -1;
-    for (const minimidi::TrackView<Container>& midi_track : midi) {
-
-        const size_t    message_num = midi_track.size / 3 + 100;
-        TrackManager<T> trackManager(message_num);
-        std::string     cur_name;
-        count += 1;
-        // channel -> pedal_on
-        std::array<unit, 16> last_pedal_on{-1};
-        // iter midi messages in the track
-
-        for (const auto& msg : midi_track) {
-            const auto cur_tick = static_cast<Tick::unit>(msg.time);
-            const auto cur_time = tick2unit(cur_tick);
-            switch (msg.type()) {
-            case minimidi::MessageType::NoteOn: {
-                const auto& note_on = msg.template cast<minimidi::NoteOn>();
-                ensure_valid_midi_data_byte("pitch", note_on.pitch(), sanitize_data);
-                ensure_valid_midi_data_byte("velocity", note_on.velocity(), sanitize_data);
-                if (note_on.velocity() != 0) {
-                    trackManager.add_note(
-                        note_on.channel(), note_on.pitch(), cur_time, note_on.velocity()
-                    );
-                    break;
-                }
-                // The msg is treated as a NoteOff Message if velocity == 0
-            }
-            case minimidi::MessageType::NoteOff: {
-                const auto& note_off = msg.template cast<minimidi::NoteOff>();
-                ensure_valid_midi_data_byte("pitch", note_off.pitch(), sanitize_data);
-                ensure_valid_midi_data_byte("velocity", note_off.velocity(), sanitize_data);
-                trackManager.end_note(note_off.channel(), note_off.pitch(), cur_time);
+
+    const bool   sanitize_data = options.sanitize_data;
+    const size_t message_num   = midi_track.size / 3 + 100;
+    trackManager.reset(message_num, options.keep_notes);
+    std::string cur_name;
+    // channel -> pedal_on
+    std::array<unit, 16> last_pedal_on{-1};
+    // the whole chunk is decoded without a window
+    const auto& window = options.window;
+    const unit  window_start
+        = window ? window_bound<T>(window->start) : std::numeric_limits<unit>::lowest();
+    const unit window_end = window ? window_bound<T>(window->end) : std::numeric_limits<unit>::max();
+    bool       cut_off    = false;
+    // iter midi messages in the track
+
+    for (const auto& msg : midi_track) {
+        const auto cur_tick = static_cast<Tick::unit>(msg.time);
+        const auto cur_time = tick2unit(cur_tick);
+        if (cur_time > window_end) [[unlikely]] {
+            cut_off = true;
+            break;
+        }
+        switch (msg.type()) {
+        case minimidi::MessageType::NoteOn: {
+            const auto& note_on = msg.template cast<minimidi::NoteOn>();
+            if (!options.keep_notes) {
+                // still create the track so that its other events land where they normally would
+                if (note_on.velocity() != 0) trackManager.template get<true>(note_on.channel());
                 break;
             }
-            case minimidi::MessageType::ProgramChange: {
-                const auto&   program_change = msg.template cast<minimidi::ProgramChange>();
-                const uint8_t channel        = program_change.channel();
-                const uint8_t program        = program_change.program();
-                ensure_valid_midi_data_byte("program", program, sanitize_data);
-                trackManager.set_program(
-                    channel, program
-                );   // Changed to call TrackManager's method
+            const uint8_t pitch    = midi_data_byte("pitch", note_on.pitch(), sanitize_data);
+            const uint8_t velocity = midi_data_byte("velocity", note_on.velocity(), sanitize_data);
+            if (velocity != 0) {
+                trackManager.add_note(note_on.channel(), pitch, cur_time, velocity);
                 break;
             }
-            case minimidi::MessageType::ControlChange: {
-                const auto&   control_change = msg.template cast<minimidi::ControlChange>();
-                const uint8_t channel        = control_change.channel();
+            // The msg is treated as a NoteOff Message if velocity == 0
+        }
+        case minimidi::MessageType::NoteOff: {
+            if (!options.keep_notes) break;
+            const auto& note_off = msg.template cast<minimidi::NoteOff>();
+            const uint8_t pitch    = midi_data_byte("pitch", note_off.pitch(), sanitize_data);
+            (void)midi_data_byte("velocity", note_off.velocity(), sanitize_data);
+            trackManager.end_note(note_off.channel(), pitch, cur_time);
+            break;
+        }
+        case minimidi::MessageType::ProgramChange: {
+            const auto&   program_change = msg.template cast<minimidi::ProgramChange>();
+            const uint8_t channel        = program_change.channel();
+            const uint8_t program
+                = midi_data_byte("program", program_change.program(), sanitize_data);
+            trackManager.set_program(
+                channel, program
+            );   // Changed to call TrackManager's method
+            break;
+        }
+        case minimidi::MessageType::ControlChange: {
+            const auto&   control_change = msg.template cast<minimidi::ControlChange>();
+            const uint8_t channel        = control_change.channel();
+
+            // clamping never turns another controller into 64, so the raw byte can be tested
+            const bool is_pedal = control_change.control_number() == 64 && options.keep_pedals;
+            if (!options.keep_controls && !is_pedal) break;
+
+            auto& handler = trackManager.template get<false>(channel);
+            auto& track   = handler.track;
 
-                auto& handler = trackManager.template get<false>(channel);
-                auto& track   = handler.track;
+            const uint8_t control_number = midi_data_byte(
+                "control_number", control_change.control_number(), sanitize_data
+            );
+            const uint8_t control_value
+                = midi_data_byte("control_value", control_change.control_value(), sanitize_data);
+            if (options.keep_controls && cur_time >= window_start) {
                 if (track.controls.capacity() < message_num / 2) [[unlikely]] {
                     track.controls.reserve(message_num / 2);
                 }
-
-                const uint8_t control_number = control_change.control_number();
-                const uint8_t control_value  = control_change.control_value();
-
-                ensure_valid_midi_data_byte("control_number", control_number, sanitize_data);
-                ensure_valid_midi_data_byte("control_value", control_value, sanitize_data);
                 track.controls.emplace_back(cur_time, control_number, control_value);
-                // Pedal Part
-                if (control_number == 64) {
-                    if (control_value >= 64) {
-                        if (last_pedal_on[channel] < 0) last_pedal_on[channel] = cur_time;
-                    } else {
-                        if (last_pedal_on[channel] >= 0) {
-                            track.pedals.emplace_back(
-                                last_pedal_on[channel], cur_time - last_pedal_on[channel]
-                            );
-                            last_pedal_on[channel] = -1;
-                        }
+            }
+            // Pedal Part
+            if (is_pedal) {
+                if (control_value >= 64) {
+                    if (last_pedal_on[channel] < 0) last_pedal_on[channel] = cur_time;
+                } else {
+                    if (last_pedal_on[channel] >= 0) {
+                        track.pedals.emplace_back(
+                            last_pedal_on[channel], cur_time - last_pedal_on[channel]
+                        );
+                        last_pedal_on[channel] = -1;
                     }
                 }
+            }
+            break;
+        }
+        case minimidi::MessageType::PitchBend: {
+            if (!options.keep_pitch_bends) break;
+            const auto& pitch_bend = msg.template cast<minimidi::PitchBend>();
+            auto&       track = trackManager.template get<false>(pitch_bend.channel()).track;
+            // check each byte before combining them, as a LSB of 0x80 or more carries into the MSB
+            const uint8_t lsb = midi_data_byte("pitch_bend", pitch_bend.data[0], sanitize_data);
+            const uint8_t msb = midi_data_byte("pitch_bend", pitch_bend.data[1], sanitize_data);
+            if (cur_time < window_start) break;
+            track.pitch_bends.emplace_back(
+                cur_time, (msb << 7 | lsb) + minimidi::PitchBend<>::MIN_PITCH_BEND
+            );
+            break;
+        }
+            // Meta Message
+        case minimidi::MessageType::Meta: {
+            switch (const auto& meta = msg.template cast<minimidi::Meta>(); meta.meta_type()) {
+            case (minimidi::MetaType::TrackName): {
+                auto data = meta.meta_value();
+                auto tmp  = std::string(data.begin(), data.end());
+                cur_name  = strip_non_utf_8(tmp);
                 break;
             }
-            case minimidi::MessageType::PitchBend: {
-                const auto& pitch_bend = msg.template cast<minimidi::PitchBend>();
-                auto&       track = trackManager.template get<false>(pitch_bend.channel()).track;
-                auto        value = pitch_bend.pitch_bend();
-                if (!sanitize_data
-                    && (value < minimidi::PitchBend<>::MIN_PITCH_BEND
-                        || value > minimidi::PitchBend<>::MAX_PITCH_BEND))
-                    throw std::runtime_error("Get pitch_bend=" + std::to_string(value));
-                track.pitch_bends.emplace_back(cur_time, value);
+            case (minimidi::MetaType::TimeSignature): {
+                if (!options.keep_time_signatures) break;
+                const auto& time_sig = meta.template cast<minimidi::TimeSignature>();
+                score.time_signatures.emplace_back(
+                    tick2unit(cur_tick), time_sig.numerator(), time_sig.denominator()
+                );
                 break;
             }
-                // Meta Message
-            case minimidi::MessageType::Meta: {
-                switch (const auto& meta = msg.template cast<minimidi::Meta>(); meta.meta_type()) {
-                case (minimidi::MetaType::TrackName): {
-                    auto data = meta.meta_value();
-                    auto tmp  = std::string(data.begin(), data.end());
-                    cur_name  = strip_non_utf_8(tmp);
-                    break;
-                }
-                case (minimidi::MetaType::TimeSignature): {
-                    const auto& time_sig = meta.template cast<minimidi::TimeSignature>();
-                    score.time_signatures.emplace_back(
-                        tick2unit(cur_tick), time_sig.numerator(), time_sig.denominator()
-                    );
-                    break;
-                }
-                case (minimidi::MetaType::SetTempo): {
-                    // store the raw tempo value(mspq) directly
-                    // qpm is calculated when needed
-                    score.tempos.emplace_back(
-                        cur_time, meta.template cast<minimidi::SetTempo>().tempo()
-                    );
-                    break;
-                }
-                case (minimidi::MetaType::KeySignature): {
-                    const auto& k_msg = meta.template cast<minimidi::KeySignature>();
-                    score.key_signatures.emplace_back(cur_time, k_msg.key(), k_msg.tonality());
-                    break;
-                }
-                case (minimidi::MetaType::Lyric): {
-                    auto  data  = meta.meta_value();
-                    auto& track = trackManager.template get<true>(meta.channel()).track;
-                    auto  text  = strip_non_utf_8(std::string(data.begin(), data.end()));
-
-                    if (text.empty()) break;
-                    track.lyrics.emplace_back(cur_time, text);
-                    break;
-                }
-                case (minimidi::MetaType::Marker): {
-                    auto data = meta.meta_value();
-                    auto tmp  = std::string(data.begin(), data.end());
-                    auto text = strip_non_utf_8(tmp);
-                    if (text.empty()) break;
-                    score.markers.emplace_back(cur_time, text);
-                    break;
-                }
-                default: break;
-                }
+            case (minimidi::MetaType::SetTempo): {
+                if (!options.keep_tempos) break;
+                // store the raw tempo value(mspq) directly
+                // qpm is calculated when needed
+                score.tempos.emplace_back(
+                    cur_time, meta.template cast<minimidi::SetTempo>().tempo()
+                );
+                break;
+            }
+            case (minimidi::MetaType::KeySignature): {
+                if (!options.keep_key_signatures) break;
+                const auto& k_msg = meta.template cast<minimidi::KeySignature>();
+                score.key_signatures.emplace_back(cur_time, k_msg.key(), k_msg.tonality());
+                break;
+            }
+            case (minimidi::MetaType::Lyric): {
+                auto& track = trackManager.template get<true>(meta.channel()).track;
+                if (!options.keep_lyrics || cur_time < window_start) break;
+                auto  data  = meta.meta_value();
+                auto  text  = strip_non_utf_8(std::string(data.begin(), data.end()));
+
+                if (text.empty()) break;
+                track.lyrics.emplace_back(cur_time, text);
+                break;
+            }
+            case (minimidi::MetaType::Marker): {
+                if (!options.keep_markers || cur_time < window_start) break;
+                auto data = meta.meta_value();
+                auto tmp  = std::string(data.begin(), data.end());
+                auto text = strip_non_utf_8(tmp);
+                if (text.empty()) break;
+                score.markers.emplace_back(cur_time, text);
                 break;
             }
             default: break;
             }
+            break;
+        }
+        default: break;
         }
-        trackManager.finalize(score, cur_name);
     }
-    sort_by_time(score.time_signatures);
-    sort_by_time(score.key_signatures);
-    sort_by_time(score.tempos);
-    sort_by_time(score.markers);
-    return to_shared(std::move(score));
+    // notes sounding across the window end, their real ends lie past the cut
+    if (cut_off && window->end_mode == "truncate") { trackManager.end_all_notes(window_end); }
+    trackManager.finalize(score, cur_name);
 }
 
-minimidi::MidiFile<> to_midi(const Score<Tick>& score) {
-    minimidi::MidiFile<> midi{
-        minimidi::MidiFormat::MultiTrack, 0, static_cast<u16>(score.ticks_per_quarter)
+/**
+ * Move the tracks and meta events of a per-chunk fragment into the destination score.
+ */
+template<typename T>
+void merge_fragment(ScoreNative<T>& score, ScoreNative<T>&& fragment) {
+    const auto append = [](auto& dst, auto& src) {
+        dst.insert(
+            dst.end(), std::make_move_iterator(src.begin()), std::make_move_iterator(src.end())
+        );
     };
+    append(score.tracks, fragment.tracks);
+    append(score.time_signatures, fragment.time_signatures);
+    append(score.key_signatures, fragment.key_signatures);
+    append(score.tempos, fragment.tempos);
+    append(score.markers, fragment.markers);
+}
 
-    midi.tracks.reserve(score.tracks->size() + 1);
-    minimidi::Messages<> init_msgs{};
-    {   // add meta messages
-        auto&        msgs        = init_msgs;
-        const size_t message_num = score.time_signatures->size() + score.key_signatures->size()
-                                   + score.tempos->size() + score.markers->size();
-        msgs.reserve(message_num);
-        // add time signatures
-        for (const auto& time_signature : *score.time_signatures) {
-            msgs.emplace_back(
-                minimidi::TimeSignature(
-                    time_signature->time, time_signature->numerator, time_signature->denominator
-                )
-            );
-        }
-        // add key signatures
-        for (const auto& key_signature : *score.key_signatures) {
-            msgs.emplace_back(
-                minimidi::KeySignature(
-                    key_signature->time, key_signature->key, key_signature->tonality
-                )
-            );
-        }
-        // add tempos
-        for (const auto& tempo : *score.tempos) {
-            msgs.emplace_back(minimidi::SetTempo(tempo->time, tempo->mspq));
-        }
-        // add markers
-        for (const auto& marker : *score.markers) {
-            msgs.emplace_back(minimidi::Marker(marker->time, marker->text));
+/**
+ * Scratch state of one time unit that outlives a single file: a TrackManager per worker, the
+ * per-chunk fragments of the parallel path and the list of chunk views. Everything is cleared
+ * rather than freed, so reusing a scratch leaves the decoded score as the only allocation.
+ */
+template<TType T>
+struct ParseScratch {
+    vec<TrackManager<T>>                               managers;
+    vec<ScoreNative<T>>                                fragments;
+    vec<minimidi::TrackView<std::span<const uint8_t>>> views;
+
+    /// Make sure there is a manager for each of ``workers`` workers; call before spawning them.
+    void reserve_workers(const size_t workers) {
+        if (managers.size() < workers) managers.resize(workers);
+    }
+
+    /// Return ``num`` empty fragments, reusing the capacity left by earlier files.
+    std::span<ScoreNative<T>> take_fragments(const size_t num) {
+        if (fragments.size() < num) fragments.resize(num);
+        for (size_t i = 0; i < num; ++i) {
+            auto& fragment = fragments[i];
+            fragment.tracks.clear();
+            fragment.time_signatures.clear();
+            fragment.key_signatures.clear();
+            fragment.tempos.clear();
+            fragment.markers.clear();
         }
+        return {fragments.data(), num};
     }
-    const std::array<u8, 15> valid_channel{0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 11, 12, 13, 14, 15};
+};
+
+/// The scratch states of every time unit, owned by a ``MidiParser``.
+struct ParseScratchSet {
+    ParseScratch<Tick>    tick;
+    ParseScratch<Quarter> quarter;
+    ParseScratch<Second>  second;
 
-    for (size_t idx = 0; const auto& track : *score.tracks) {
-        minimidi::Messages<> msgs;
-        if (!init_msgs.empty()) {
-            msgs      = std::move(init_msgs);
-            init_msgs = {};
+    template<TType T>
+    ParseScratch<T>& get() {
+        if constexpr (std::is_same_v<T, Tick>) {
+            return tick;
+        } else if constexpr (std::is_same_v<T, Quarter>) {
+            return quarter;
         } else {
-            msgs = {};
-            msgs.reserve(
-                msgs.size() + track->note_num() * 2 + track->controls->size()
-                + track->pitch_bends->size() + track->lyrics->size() + 10
-            );
-        }
-        const u8 channel = track->is_drum ? 9 : valid_channel[idx % 15];
-        // add track name
-        if (!track->name.empty()) msgs.emplace_back(minimidi::TrackName(0, track->name));
-        // add program change
-        msgs.emplace_back(minimidi::ProgramChange(0, channel, track->program));
-        // Todo add check for Pedal
-        // add control change
-        for (const auto& control : *track->controls) {
-            msgs.emplace_back(
-                minimidi::ControlChange(control->time, channel, control->number, control->value)
-            );
-        }
-        // add pitch bend
-        for (const auto& pitch_bend : *track->pitch_bends) {
-            msgs.emplace_back(
-                minimidi::PitchBend(pitch_bend->time, channel, static_cast<i16>(pitch_bend->value))
-            );
-        }
-        // add lyrics
-        for (const auto& lyric : *track->lyrics) {
-            msgs.emplace_back(minimidi::Lyric(lyric->time, lyric->text));
+            return second;
         }
+    }
+};
 
-        gfx::timsort(msgs.begin(), msgs.end(), [](const auto& a, const auto& b) {
-            return (a.time) < (b.time);
-        });
-        // add notes
-        const size_t note_size  = track->notes->size();
-        const auto   note_begin = static_cast<ptrdiff_t>(msgs.size());
-
-        // collect notes and make sure they are sorted
-        vec<Note<Tick>> notes(track->notes->size());
-        bool            sorted    = true;
-        Tick::unit      prev_time = 0;
-        for (size_t j = 0; const auto& note : *track->notes) {
-            notes[j++] = note;
-            sorted &= note.time >= prev_time;
-            prev_time = note.time;
+/**
+ * Parse the given MIDI view; ``options.sanitize_data`` is applied by ``parse_track``.
+ *
+ * With ``num_threads != 1`` every MTrk chunk is decoded into its own ``ScoreNative`` fragment on a
+ * worker pool, and the fragments are merged in chunk order. Since the meta vectors are concatenated
+ * in the same order as the sequential loop would have filled them, the final sort yields an
+ * identical score.
+ *
+ * @param midi MIDI view produced by minimidi.
+ * @param tick2unit Converter that maps MIDI ticks to the desired time unit; copied per chunk.
+ * @param options Sanitization, projection and worker count (``0`` means all hardware threads).
+ * @param scratch Reusable per-worker state.
+ */
+template<TType T, typename Conv, typename Container>
+[[nodiscard]] Score<T> parse_midi(
+    const minimidi::MidiFileView<Container>& midi,
+    Conv                                     tick2unit,
+    const ParseOptions&                      options,
+    ParseScratch<T>&                         scratch
+) {
+    const size_t num_threads = options.num_threads;
+    // remove this redundant copy in the future
+    const u16      tpq = midi.ticks_per_quarter();
+    ScoreNative<T> score(tpq);   // create a score with the given ticks per quarter
+
+    if (num_threads == 1) {
+        scratch.reserve_workers(1);
+        for (const minimidi::TrackView<Container>& midi_track : midi) {
+            parse_track<T>(midi_track, tick2unit, options, scratch.managers[0], score);
+        }
+    } else {
+        auto& midi_tracks = scratch.views;
+        midi_tracks.clear();
+        for (const minimidi::TrackView<Container>& midi_track : midi) {
+            midi_tracks.push_back(midi_track);
         }
-        if (!sorted) { sort_by_time(notes); }
-        // add notes to messages
-        msgs.resize(msgs.size() + note_size * 2);
-        for (size_t i = note_begin; const auto& note : notes) {
-            if (note.duration > 0) {
-                msgs[i] = minimidi::NoteOff(note.end(), channel, note.pitch, note.velocity);
-                msgs[i + note_size]
-                    = minimidi::NoteOn(note.time, channel, note.pitch, note.velocity);
-            } else {   // empty note
-                msgs[i + note_size]
-                    = minimidi::NoteOff(note.time, channel, note.pitch, note.velocity);
-                msgs[i] = minimidi::NoteOn(note.time, channel, note.pitch, note.velocity);
+        scratch.reserve_workers(resolve_num_threads(num_threads, midi_tracks.size()));
+        auto fragments = scratch.take_fragments(midi_tracks.size());
+        parallel_for_workers(
+            midi_tracks.size(),
+            num_threads,
+            [&](const size_t worker, const size_t i) {
+                parse_track<T>(
+                    midi_tracks[i], tick2unit, options, scratch.managers[worker], fragments[i]
+                );
             }
-            i += 1;
+        );
+        for (auto& fragment : fragments) { merge_fragment(score, std::move(fragment)); }
+    }
+    sort_by_time(score.time_signatures);
+    sort_by_time(score.key_signatures);
+    sort_by_time(score.tempos);
+    sort_by_time(score.markers);
+    return to_shared(std::move(score));
+}
+
+/**
+ * Append the SetTempo events of one MTrk chunk to ``tempos`` without decoding anything else.
+ */
+template<typename Container>
+void collect_tempos(const minimidi::TrackView<Container>& chunk, vec<Tempo<Tick>>& tempos) {
+    for (const auto& msg : chunk) {
+        if (msg.type() != minimidi::MessageType::Meta) continue;
+        const auto& meta = msg.template cast<minimidi::Meta>();
+        if (meta.meta_type() != minimidi::MetaType::SetTempo) continue;
+        tempos.emplace_back(
+            static_cast<Tick::unit>(msg.time), meta.template cast<minimidi::SetTempo>().tempo()
+        );
+    }
+}
+
+/**
+ * Parse a MIDI view straight into seconds without an intermediate ``Score<Tick>``.
+ *
+ * A cheap pre-scan of the conductor (first) chunk collects the tempo map, then every chunk is
+ * decoded through a per-chunk ``Tick2SecondConverter::Cursor``. The tempo map is built exactly as
+ * ``convert<Second>`` would build it from the tick score, so both paths yield identical values.
+ * Files that carry tempo events outside the conductor chunk are rare but legal; their tempo map is
+ * only known after a full decode, so they fall back to ``convert<Second>(parse<Tick>)``.
+ * Tempos are always decoded because the fallback check needs them; they are dropped afterwards
+ * when ``options.keep_tempos`` is false.
+ */
+template<typename Container>
+[[nodiscard]] Score<Second> parse_midi_second(
+    const minimidi::MidiFileView<Container>& midi,
+    const ParseOptions&                      options,
+    ParseScratchSet&                         scratch
+) {
+    Score<Tick> tempo_map(midi.ticks_per_quarter());
+    for (const minimidi::TrackView<Container>& conductor : midi) {
+        vec<Tempo<Tick>> tempos;
+        collect_tempos(conductor, tempos);
+        sort_by_time(tempos);
+        tempo_map.tempos = std::make_shared<pyvec<Tempo<Tick>>>(std::move(tempos));
+        break;
+    }
+
+    ParseOptions decode_options = options;
+    decode_options.keep_tempos  = true;
+
+    const Tick2SecondConverter converter(tempo_map);
+    Score<Second> score
+        = parse_midi<Second>(midi, converter.cursor(), decode_options, scratch.second);
+    // a windowed decode only sees the conductor tempos up to the window end
+    size_t conductor_tempos = tempo_map.tempos->size();
+    if (options.window) {
+        const Second::unit end    = window_bound<Second>(options.window->end);
+        auto               cursor = converter.cursor();
+        conductor_tempos          = 0;
+        for (const auto& tempo : *tempo_map.tempos) {
+            if (cursor(tempo->time) > end) break;
+            ++conductor_tempos;
         }
-        // insertion sort note_off
-        pdqsort_detail::insertion_sort(
-            msgs.begin() + note_begin,
-            msgs.begin() + (note_begin + static_cast<ptrdiff_t>(note_size)),
-            [](const auto& a, const auto& b) { return (a.time) < (b.time); }
+    }
+    if (score.tempos->size() != conductor_tempos) {
+        // the window is in seconds, so the tick decode has to cover the whole file
+        decode_options.window.reset();
+        score = convert<Second>(parse_midi<Tick>(
+            midi, [](const Tick::unit x) { return x; }, decode_options, scratch.tick
+        ));
+    }
+    if (!options.keep_tempos) { score.tempos->clear(); }
+    return score;
+}
+
+/**
+ * Decode a single MTrk chunk into ``fragment`` with the tick converter that matches ``T``.
+ * ``tick2second`` must point to the tempo map for seconds and is ignored otherwise.
+ */
+template<TType T, typename Container>
+void parse_chunk(
+    const minimidi::TrackView<Container>& chunk,
+    const i32                             tpq,
+    const Tick2SecondConverter*           tick2second,
+    const ParseOptions&                   options,
+    TrackManager<T>&                      manager,
+    ScoreNative<T>&                       fragment
+) {
+    if constexpr (std::is_same_v<T, Tick>) {
+        parse_track<Tick>(chunk, [](const Tick::unit x) { return x; }, options, manager, fragment);
+    } else if constexpr (std::is_same_v<T, Quarter>) {
+        const auto quarter_tpq = static_cast<float>(tpq);
+        parse_track<Quarter>(
+            chunk,
+            [quarter_tpq](const Tick::unit x) { return static_cast<float>(x) / quarter_tpq; },
+            options,
+            manager,
+            fragment
         );
-        // merge note on and note off
-        gfx::timmerge(
-            msgs.begin() + note_begin,
-            msgs.begin() + note_begin + static_cast<ptrdiff_t>(note_size),
-            msgs.end(),
-            [](const auto& a, const auto& b) { return (a.time) < (b.time); }
+    } else {
+        parse_track<Second>(chunk, tick2second->cursor(), options, manager, fragment);
+    }
+}
+
+void check_window(const ParseWindow& window) {
+    const auto valid_mode = [](const std::string& mode) {
+        return mode == "remove" || mode == "truncate";
+    };
+    if (!valid_mode(window.start_mode) || !valid_mode(window.end_mode)) {
+        throw std::invalid_argument(
+            "Window modes must be \"remove\" or \"truncate\", got \"" + window.start_mode
+            + "\" and \"" + window.end_mode + "\""
         );
-        // merge prev to (note on and note off)
-        gfx::timmerge(
-            msgs.begin(), msgs.begin() + note_begin, msgs.end(), [](const auto& a, const auto& b) {
-                return (a.time) < (b.time);
-            }
+    }
+    if (!(window.start <= window.end)) {
+        throw std::invalid_argument(
+            "Window start " + std::to_string(window.start) + " is after its end "
+            + std::to_string(window.end)
         );
-        // messages will be sorted by time in minimidi
-        if (!msgs.empty()) {
-            // sort msgs by time using timsort
-            midi.tracks.emplace_back(std::move(msgs));
-            idx += 1;
-        }
     }
-    if (!init_msgs.empty()) { midi.tracks.emplace_back(std::move(init_msgs)); }
-    return std::move(midi);
 }
 
 /**
- * Parse raw MIDI bytes to a score, optionally sanitizing payloads before decoding.
+ * Finish a windowed decode. ``parse_track`` has already left out most events past the window, so
+ * this trims a score that is roughly the size of the window, then drops the tracks it emptied.
+ */
+template<TType T>
+void apply_window(Score<T>& score, const ParseWindow& window) {
+    score.trim_inplace(
+        window_bound<T>(window.start),
+        window_bound<T>(window.end),
+        window_bound<T>(window.min_overlap),
+        window.start_mode,
+        window.end_mode
+    );
+    ops::filter_inplace(*score.tracks, [](const shared<Track<T>>& track) {
+        return !track->empty();
+    });
+}
+
+/**
+ * Parse raw MIDI bytes to a score through the zero-copy view.
  *
  * @param bytes Raw MIDI bytes to parse.
- * @param sanitize_data Clamp payload bytes to the 7-bit MIDI range.
+ * @param options Sanitization, projection, window and track-level parallelism settings.
+ * @param scratch Reusable state, e.g. the one owned by a ``MidiParser``.
  */
 template<TType T>
-Score<T> parse_midi(const std::span<const u8> bytes, bool sanitize_data = false) {
-    const auto parse_view = [&](const auto& midi_view) -> Score<T> {
+Score<T> parse_midi(
+    const std::span<const u8> bytes, const ParseOptions& options, ParseScratchSet& scratch
+) {
+    if (options.window) check_window(*options.window);
+    // the zero-copy view serves both modes, parse_track clamps invalid bytes when sanitizing
+    const minimidi::MidiFileView<std::span<const uint8_t>> midi{bytes.data(), bytes.size()};
+    Score<T> score = [&] {
         if constexpr (std::is_same_v<T, Tick>) {
-            return parse_midi<Tick>(midi_view, [](const Tick::unit x) { return x; }, sanitize_data);
+            return parse_midi<Tick>(
+                midi, [](const Tick::unit x) { return x; }, options, scratch.tick
+            );
         } else if constexpr (std::is_same_v<T, Quarter>) {
-            const auto tpq = static_cast<float>(midi_view.ticks_per_quarter());
+            const auto tpq = static_cast<float>(midi.ticks_per_quarter());
             return parse_midi<Quarter>(
-                midi_view,
+                midi,
                 [tpq](const Tick::unit x) { return static_cast<float>(x) / tpq; },
-                sanitize_data
+                options,
+                scratch.quarter
             );
         } else {
-            return convert<Second>(
-                parse_midi<Tick>(midi_view, [](const Tick::unit x) { return x; }, sanitize_data)
-            );
+            return parse_midi_second(midi, options, scratch);
         }
-    };
-
-    if (sanitize_data) {
-        const minimidi::MidiFileView<minimidi::container::SmallBytes> midi{
-            bytes.data(),
-            bytes.size(),
-            true   // sanitize data payloads to enforce strict MIDI range
-        };
-        return parse_view(midi);
-    }
+    }();
+    if (options.window) apply_window(score, *options.window);
+    return score;
+}
 
-    const minimidi::MidiFileView<std::span<const uint8_t>> midi{bytes.data(), bytes.size()};
-    return parse_view(midi);
+template<TType T>
+Score<T> parse_midi(const std::span<const u8> bytes, const ParseOptions& options = {}) {
+    ParseScratchSet scratch;
+    return parse_midi<T>(bytes, options, scratch);
 }
 }   // namespace details
 
@@ -558,24 +767,420 @@ Score<Second> Score<Second>::parse<DataFormat::MIDI>(const std::span<const u8> b
     return details::parse_midi<Second>(bytes);
 }
 
-template<>
-template<>
-vec<u8> Score<Tick>::dumps<DataFormat::MIDI>() const {
-    return details::to_midi(*this).to_bytes_sorted();
+/*
+ *  MidiParser
+ */
+
+struct MidiParser::Impl {
+    details::ParseScratchSet scratch;
+};
+
+MidiParser::MidiParser() : impl(std::make_unique<Impl>()) {}
+
+MidiParser::MidiParser(MidiParser&&) noexcept = default;
+
+MidiParser& MidiParser::operator=(MidiParser&&) noexcept = default;
+
+MidiParser::~MidiParser() = default;
+
+template<TType T>
+Score<T> MidiParser::parse(const std::span<const u8> bytes, const ParseOptions& options) {
+    return details::parse_midi<T>(bytes, options, impl->scratch);
 }
 
-template<>
-template<>
-vec<u8> Score<Quarter>::dumps<DataFormat::MIDI>() const {
-    return details::to_midi(convert<Tick>(*this)).to_bytes_sorted();
+template Score<Tick>    MidiParser::parse<Tick>(std::span<const u8>, const ParseOptions&);
+template Score<Quarter> MidiParser::parse<Quarter>(std::span<const u8>, const ParseOptions&);
+template Score<Second>  MidiParser::parse<Second>(std::span<const u8>, const ParseOptions&);
+
+/*
+ *  LazyScore
+ */
+
+template<TType T>
+struct LazyScore<T>::Impl {
+    using Container = std::span<const uint8_t>;
+
+    struct Chunk {
+        bool                  decoded = false;
+        vec<shared<Track<T>>> tracks;
+        ScoreNative<T>        meta;   // unsorted meta events, merged like in parse_midi
+    };
+
+    vec<u8>      bytes;
+    ParseOptions options;
+    i32          tpq = 0;
+
+    minimidi::MidiFileView<Container>   view;
+    vec<minimidi::TrackView<Container>> views;
+
+    std::optional<details::Tick2SecondConverter> tick2second;   // only used by LazyScore<Second>
+    vec<Chunk>                                   chunks;
+    Score<T>                                     conductor;
+    details::ParseScratch<T>                     scratch;
+
+    Impl(vec<u8>&& data, const ParseOptions& opts) :
+        bytes(std::move(data)), options(opts), view(bytes.data(), bytes.size()) {
+        if (options.window) {
+            throw std::invalid_argument("LazyScore does not support a parse window");
+        }
+        tpq = view.ticks_per_quarter();
+        for (const minimidi::TrackView<Container>& midi_track : view) views.push_back(midi_track);
+        chunks.resize(views.size());
+
+        if constexpr (std::is_same_v<T, Second>) {
+            // the tempo map must be complete before any chunk can be converted to seconds
+            Score<Tick>      tempo_map(tpq);
+            vec<Tempo<Tick>> tempos;
+            for (const auto& chunk : views) details::collect_tempos(chunk, tempos);
+            details::sort_by_time(tempos);
+            tempo_map.tempos = std::make_shared<pyvec<Tempo<Tick>>>(std::move(tempos));
+            tick2second.emplace(tempo_map);
+        }
+
+        conductor = Score<T>(tpq);
+        if (chunks.empty()) return;
+        scratch.reserve_workers(1);
+        store(0, decode(0, scratch.managers[0]));
+        ScoreNative<T> meta = chunks[0].meta;
+        details::sort_by_time(meta.time_signatures);
+        details::sort_by_time(meta.key_signatures);
+        details::sort_by_time(meta.tempos);
+        details::sort_by_time(meta.markers);
+        conductor = to_shared(std::move(meta));
+    }
+
+    [[nodiscard]] ScoreNative<T> decode(
+        const size_t index, details::TrackManager<T>& manager
+    ) const {
+        ScoreNative<T> fragment(tpq);
+        const auto*    converter = tick2second ? &*tick2second : nullptr;
+        details::parse_chunk<T>(views[index], tpq, converter, options, manager, fragment);
+        return fragment;
+    }
+
+    void store(const size_t index, ScoreNative<T>&& fragment) {
+        auto& chunk = chunks[index];
+        chunk.tracks.reserve(fragment.tracks.size());
+        for (auto& track : fragment.tracks) {
+            chunk.tracks.push_back(std::make_shared<Track<T>>(to_shared(std::move(track))));
+        }
+        fragment.tracks.clear();
+        chunk.meta    = std::move(fragment);
+        chunk.decoded = true;
+    }
+};
+
+template<TType T>
+LazyScore<T>::LazyScore(vec<u8> bytes, const ParseOptions& options) :
+    impl(std::make_unique<Impl>(std::move(bytes), options)) {}
+
+template<TType T>
+LazyScore<T> LazyScore<T>::from_file(
+    const std::filesystem::path& path, const ParseOptions& options
+) {
+    return LazyScore(read_file(path), options);
 }
 
-template<>
-template<>
-vec<u8> Score<Second>::dumps<DataFormat::MIDI>() const {
-    return details::to_midi(convert<Tick>(*this)).to_bytes_sorted();
+template<TType T>
+LazyScore<T>::LazyScore(LazyScore&&) noexcept = default;
+
+template<TType T>
+LazyScore<T>& LazyScore<T>::operator=(LazyScore&&) noexcept = default;
+
+template<TType T>
+LazyScore<T>::~LazyScore() = default;
+
+template<TType T>
+i32 LazyScore<T>::ticks_per_quarter() const {
+    return impl->tpq;
+}
+
+template<TType T>
+size_t LazyScore<T>::num_midi_tracks() const {
+    return impl->chunks.size();
 }
 
+template<TType T>
+bool LazyScore<T>::is_decoded(const size_t index) const {
+    return impl->chunks.at(index).decoded;
+}
+
+template<TType T>
+const vec<shared<Track<T>>>& LazyScore<T>::midi_track(const size_t index) {
+    auto& chunk = impl->chunks.at(index);
+    if (!chunk.decoded) {
+        impl->scratch.reserve_workers(1);
+        impl->store(index, impl->decode(index, impl->scratch.managers[0]));
+    }
+    return chunk.tracks;
+}
+
+template<TType T>
+const Score<T>& LazyScore<T>::conductor() const {
+    return impl->conductor;
+}
+
+template<TType T>
+Score<T> LazyScore<T>::to_score() {
+    auto& chunks = impl->chunks;
+
+    vec<size_t> pending;
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        if (!chunks[i].decoded) pending.push_back(i);
+    }
+    const size_t num_threads = impl->options.num_threads;
+    impl->scratch.reserve_workers(details::resolve_num_threads(num_threads, pending.size()));
+    vec<ScoreNative<T>> fragments(pending.size());
+    details::parallel_for_workers(
+        pending.size(),
+        num_threads,
+        [&](const size_t worker, const size_t i) {
+            fragments[i] = impl->decode(pending[i], impl->scratch.managers[worker]);
+        }
+    );
+    for (size_t i = 0; i < pending.size(); ++i) {
+        impl->store(pending[i], std::move(fragments[i]));
+    }
+
+    ScoreNative<T> meta(impl->tpq);
+    size_t         num_tracks = 0;
+    for (const auto& chunk : chunks) {
+        const auto append = [](auto& dst, const auto& src) {
+            dst.insert(dst.end(), src.begin(), src.end());
+        };
+        append(meta.time_signatures, chunk.meta.time_signatures);
+        append(meta.key_signatures, chunk.meta.key_signatures);
+        append(meta.tempos, chunk.meta.tempos);
+        append(meta.markers, chunk.meta.markers);
+        num_tracks += chunk.tracks.size();
+    }
+    details::sort_by_time(meta.time_signatures);
+    details::sort_by_time(meta.key_signatures);
+    details::sort_by_time(meta.tempos);
+    details::sort_by_time(meta.markers);
+
+    Score<T> score = to_shared(std::move(meta));
+    score.tracks->reserve(num_tracks);
+    for (const auto& chunk : chunks) {
+        score.tracks->insert(score.tracks->end(), chunk.tracks.begin(), chunk.tracks.end());
+    }
+    return score;
+}
+
+template class LazyScore<Tick>;
+template class LazyScore<Quarter>;
+template class LazyScore<Second>;
+
+/*
+ *  MidiStreamParser
+ */
+
+template<TType T>
+struct MidiStreamParser<T>::Impl {
+    ParseOptions  options;   // keep_tempos is forced on for seconds, see finish()
+    bool          keep_tempos;
+    TrackCallback on_tracks;
+
+    vec<u8> pending;   // fed bytes that do not form a complete chunk yet
+    vec<u8> header;    // the MThd chunk, patched to declare a single track
+    vec<u8> file;      // header followed by one chunk, viewed as a single-track file
+    vec<u8> consumed;  // the header and every chunk consumed so far, only kept for seconds
+    size_t  declared_chunks = 0;
+    size_t  num_chunks      = 0;   // chunks consumed, including unknown chunk types
+    size_t  num_decoded     = 0;   // MTrk chunks decoded
+    i32     tpq             = 0;
+    bool    finished        = false;
+
+    std::optional<details::Tick2SecondConverter> tick2second;   // seconds only
+    size_t                                       conductor_tempos = 0;
+
+    details::TrackManager<T> manager;
+    ScoreNative<T>           meta;   // unsorted meta events, merged like in parse_midi
+    vec<shared<Track<T>>>    tracks;
+    vec<shared<Track<T>>>    ready;
+
+    Impl(const ParseOptions& opts, TrackCallback&& callback) :
+        options(opts), keep_tempos(opts.keep_tempos), on_tracks(std::move(callback)) {
+        if (options.window) {
+            throw std::invalid_argument("MidiStreamParser does not support a parse window");
+        }
+        if constexpr (std::is_same_v<T, Second>) options.keep_tempos = true;
+    }
+
+    static size_t read_u32(const u8* data) {
+        return static_cast<size_t>(data[0]) << 24 | static_cast<size_t>(data[1]) << 16
+               | static_cast<size_t>(data[2]) << 8 | static_cast<size_t>(data[3]);
+    }
+
+    [[nodiscard]] bool complete() const {
+        return !header.empty() && num_chunks == declared_chunks;
+    }
+
+    void feed(const std::span<const u8> bytes) {
+        if (finished) throw std::runtime_error("MidiStreamParser: feed() called after finish()");
+        // bytes after the last declared chunk are ignored, like in a full parse
+        if (complete()) return;
+        pending.insert(pending.end(), bytes.begin(), bytes.end());
+
+        size_t pos = 0;
+        while (!complete() && pending.size() - pos >= 8) {
+            const u8* chunk = pending.data() + pos;
+            if (header.empty() && !std::equal(chunk, chunk + 4, "MThd")) {
+                throw std::runtime_error("MiniMidi: Invalid MIDI header!");
+            }
+            const size_t size = 8 + read_u32(chunk + 4);
+            if (pending.size() - pos < size) break;
+            if (header.empty()) {
+                read_header(chunk, size);
+            } else {
+                decode(chunk, size);
+            }
+            pos += size;
+        }
+        if (complete()) {
+            pending.clear();
+            if constexpr (std::is_same_v<T, Second>) {
+                // every tempo has been seen, so the fallback of finish() is known to be unneeded
+                if (meta.tempos.size() == conductor_tempos) vec<u8>().swap(consumed);
+            }
+        } else {
+            pending.erase(pending.begin(), pending.begin() + static_cast<std::ptrdiff_t>(pos));
+        }
+    }
+
+    void read_header(const u8* chunk, const size_t size) {
+        if constexpr (std::is_same_v<T, Second>) consumed.assign(chunk, chunk + size);
+        header.assign(chunk, chunk + size);
+        if (size >= 12) {
+            declared_chunks = static_cast<size_t>(header[10]) << 8 | header[11];
+            header[10]      = 0;
+            header[11]      = 0;
+        }
+        // let minimidi validate the header on its own
+        const minimidi::MidiFileView<std::span<const uint8_t>> view{header.data(), header.size()};
+        tpq        = view.ticks_per_quarter();
+        header[11] = 1;
+        meta       = ScoreNative<T>(tpq);
+    }
+
+    void decode(const u8* chunk, const size_t size) {
+        ++num_chunks;
+        if constexpr (std::is_same_v<T, Second>) {
+            consumed.insert(consumed.end(), chunk, chunk + size);
+        }
+        file.assign(header.begin(), header.end());
+        file.insert(file.end(), chunk, chunk + size);
+        decode(minimidi::MidiFileView<std::span<const uint8_t>>{file.data(), file.size()});
+    }
+
+    template<typename Container>
+    void decode(const minimidi::MidiFileView<Container>& midi) {
+        // chunk types other than MTrk produce no track view
+        for (const minimidi::TrackView<Container>& chunk : midi) {
+            if constexpr (std::is_same_v<T, Second>) {
+                if (!tick2second) {
+                    // the first MTrk chunk is the conductor, like in parse_midi_second
+                    Score<Tick>      tempo_map(tpq);
+                    vec<Tempo<Tick>> tempos;
+                    details::collect_tempos(chunk, tempos);
+                    details::sort_by_time(tempos);
+                    conductor_tempos = tempos.size();
+                    tempo_map.tempos = std::make_shared<pyvec<Tempo<Tick>>>(std::move(tempos));
+                    tick2second.emplace(tempo_map);
+                }
+            }
+            ScoreNative<T> fragment(tpq);
+            details::parse_chunk<T>(
+                chunk, tpq, tick2second ? &*tick2second : nullptr, options, manager, fragment
+            );
+            emit(std::move(fragment));
+        }
+    }
+
+    void emit(ScoreNative<T>&& fragment) {
+        vec<shared<Track<T>>> chunk_tracks;
+        chunk_tracks.reserve(fragment.tracks.size());
+        for (auto& track : fragment.tracks) {
+            chunk_tracks.push_back(std::make_shared<Track<T>>(to_shared(std::move(track))));
+        }
+        fragment.tracks.clear();
+        details::merge_fragment(meta, std::move(fragment));
+        tracks.insert(tracks.end(), chunk_tracks.begin(), chunk_tracks.end());
+        ready.insert(ready.end(), chunk_tracks.begin(), chunk_tracks.end());
+        if (on_tracks) on_tracks(num_decoded, chunk_tracks);
+        ++num_decoded;
+    }
+
+    [[nodiscard]] Score<T> finish() {
+        if (finished) throw std::runtime_error("MidiStreamParser: finish() called twice");
+        finished = true;
+        if (header.empty()) throw std::runtime_error("MiniMidi: Invalid MIDI header!");
+        if (!complete()) {
+            throw std::runtime_error(
+                "MidiStreamParser: input ended after " + std::to_string(num_chunks) + " of "
+                + std::to_string(declared_chunks) + " chunks"
+            );
+        }
+
+        if constexpr (std::is_same_v<T, Second>) {
+            if (meta.tempos.size() != conductor_tempos) {
+                // tempo events outside the conductor chunk, see parse_midi_second
+                Score<Second> score
+                    = convert<Second>(details::parse_midi<Tick>(consumed, options));
+                if (!keep_tempos) { score.tempos->clear(); }
+                return score;
+            }
+        }
+        details::sort_by_time(meta.time_signatures);
+        details::sort_by_time(meta.key_signatures);
+        details::sort_by_time(meta.tempos);
+        details::sort_by_time(meta.markers);
+        if (!keep_tempos) { meta.tempos.clear(); }
+
+        Score<T> score = to_shared(std::move(meta));
+        score.tracks->reserve(tracks.size());
+        score.tracks->insert(score.tracks->end(), tracks.begin(), tracks.end());
+        return score;
+    }
+};
+
+template<TType T>
+MidiStreamParser<T>::MidiStreamParser(const ParseOptions& options, TrackCallback on_tracks) :
+    impl(std::make_unique<Impl>(options, std::move(on_tracks))) {}
+
+template<TType T>
+MidiStreamParser<T>::MidiStreamParser(MidiStreamParser&&) noexcept = default;
+
+template<TType T>
+MidiStreamParser<T>& MidiStreamParser<T>::operator=(MidiStreamParser&&) noexcept = default;
+
+template<TType T>
+MidiStreamParser<T>::~MidiStreamParser() = default;
+
+template<TType T>
+void MidiStreamParser<T>::feed(const std::span<const u8> bytes) {
+    impl->feed(bytes);
+}
+
+template<TType T>
+vec<shared<Track<T>>> MidiStreamParser<T>::take_ready() {
+    return std::exchange(impl->ready, {});
+}
+
+template<TType T>
+size_t MidiStreamParser<T>::num_decoded() const {
+    return impl->num_decoded;
+}
+
+template<TType T>
+Score<T> MidiStreamParser<T>::finish() {
+    return impl->finish();
+}
+
+template class MidiStreamParser<Tick>;
+template class MidiStreamParser<Quarter>;
+template class MidiStreamParser<Second>;
+
 #define INSTANTIATE_GLOBAL_FUNC(__COUNT, T)                                                   \
     template<>                                                                                \
     Score<T> parse<DataFormat::MIDI, Score<T>>(std::span<const u8> bytes) {                   \
@@ -583,11 +1188,13 @@ vec<u8> Score<Second>::dumps<DataFormat::MIDI>() const {
     }                                                                                         \
     template<>                                                                                \
     Score<T> parse<DataFormat::MIDI, Score<T>>(std::span<const u8> bytes, bool sanitize_data) { \
-        return details::parse_midi<T>(bytes, sanitize_data);                                    \
+        return details::parse_midi<T>(bytes, ParseOptions{.sanitize_data = sanitize_data});     \
     }                                                                                         \
     template<>                                                                                \
-    vec<u8> dumps<DataFormat::MIDI, Score<T>>(const Score<T>& data) {                         \
-        return data.dumps<DataFormat::MIDI>();                                                \
+    Score<T> parse<DataFormat::MIDI, Score<T>>(                                               \
+        std::span<const u8> bytes, const ParseOptions& options                                \
+    ) {                                                                                       \
+        return details::parse_midi<T>(bytes, options);                                        \
     }
 
 REPEAT_ON(INSTANTIATE_GLOBAL_FUNC, Tick, Quarter, Second)
@@ -0,0 +1,306 @@
+//
+// Metadata-only MIDI scan. Mirrors the bookkeeping of parse_track in midi.cpp, but only keeps
+// counters, so no event, track or pyvec is ever allocated.
+//
+
+#include <algorithm>
+#include <bitset>
+#include <stdexcept>
+#include <string>
+
+#ifdef _MSC_VER
+#pragma warning(disable : 4996)
+#endif
+
+#include "minimidi/MiniMidi.hpp"
+
+#include "symusic/event.h"
+#include "symusic/utils.h"
+#include "symusic/io/common.h"
+#include "symusic/io/midi_info.h"
+#include "symusic/detail/note_queue.h"
+
+namespace symusic {
+
+namespace details {
+
+namespace {
+
+/// Same contract as ``midi_data_byte`` in midi.cpp: clamp when sanitizing, reject otherwise.
+uint8_t data_byte(const char* const field_name, const uint8_t value, const bool sanitize_data) {
+    if (value <= 0x7F) [[likely]] { return value; }
+    if (sanitize_data) { return 0x7F; }
+    throw std::runtime_error("Get " + std::string(field_name) + "=" + std::to_string(value));
+}
+
+/**
+ * Per-MTrk state. Tracks are identified by (channel, program) like in TrackManager: they are
+ * created by a NoteOn or a Lyric, and channel events that arrive before that are held by a
+ * per-channel straggler which the first created track of that channel takes over. One scanner is
+ * reset for every chunk, so its tables are only allocated once per file.
+ */
+class ChunkScanner {
+    struct Straggler {
+        bool       has_content = false;
+        Tick::unit end         = 0;
+    };
+
+    MidiInfo& info;
+
+    std::array<uint8_t, 16>   cur_program{};
+    std::array<Straggler, 16> stragglers{};
+    std::bitset<16 * 128>     created;
+    std::bitset<16 * 128>     has_content;
+
+    // what a note needs when it closes: its program for the counters, the rest for the fingerprint
+    struct OpenNote {
+        Tick::unit start    = 0;
+        uint8_t    program  = 0;
+        uint8_t    velocity = 0;
+    };
+
+    // open notes per (channel, pitch), matched first in first out like NoteManager
+    NoteQueue<OpenNote> open_notes;
+
+    [[nodiscard]] uint16_t key_of(const uint8_t channel) const {
+        return channel * 128 + cur_program[channel];
+    }
+
+    void touch_end(const Tick::unit time) { info.end_tick = std::max(info.end_tick, time); }
+
+    /// Whether ``parse_track`` keeps a lyric or marker with ``data`` after its UTF-8 cleanup.
+    template<typename Bytes>
+    static bool has_text(const Bytes& data) {
+        return !data.empty() && !strip_non_utf_8(std::string(data.begin(), data.end())).empty();
+    }
+
+    // equivalent of TrackManager::get<true>
+    uint16_t create(const uint8_t channel) {
+        const uint16_t key = key_of(channel);
+        if (!created[key]) {
+            created.set(key);
+            auto& straggler = stragglers[channel];
+            if (straggler.has_content) {
+                has_content.set(key);
+                touch_end(straggler.end);
+            }
+            straggler = Straggler{};
+        }
+        return key;
+    }
+
+    // equivalent of TrackManager::get<false> followed by storing an event at ``time``
+    void add_channel_event(const uint8_t channel, const Tick::unit time) {
+        if (const uint16_t key = key_of(channel); created[key]) {
+            has_content.set(key);
+            touch_end(time);
+        } else {
+            auto& straggler       = stragglers[channel];
+            straggler.has_content = true;
+            straggler.end         = std::max(straggler.end, time);
+        }
+    }
+
+    void note_on(
+        const uint8_t channel, const uint8_t pitch, const uint8_t velocity, const Tick::unit time
+    ) {
+        has_content.set(create(channel));
+        open_notes.push(
+            NoteQueue<OpenNote>::key_of(channel, pitch),
+            OpenNote{time, cur_program[channel], velocity}
+        );
+    }
+
+    void note_off(const uint8_t channel, const uint8_t pitch, const Tick::unit time) {
+        const uint16_t slot = NoteQueue<OpenNote>::key_of(channel, pitch);
+        if (open_notes.count(slot) == 0) return;
+
+        const OpenNote& note = open_notes.front(slot);
+        ++info.note_num;
+        if (channel == 9) {
+            ++info.drum_note_num;
+        } else {
+            ++info.notes_per_program[note.program];
+        }
+        const i32 tpq = info.ticks_per_quarter;
+        info.fingerprint.add_note(
+            Fingerprint::normalize(note.start, tpq),
+            Fingerprint::normalize(time - note.start, tpq),
+            pitch,
+            note.velocity,
+            note.program,
+            channel == 9
+        );
+        touch_end(time);
+        open_notes.pop(slot);
+    }
+
+public:
+    explicit ChunkScanner(MidiInfo& info) : info(info) {}
+
+    /// Forget the state of the previous chunk.
+    void reset() {
+        cur_program.fill(0);
+        stragglers.fill(Straggler{});
+        created.reset();
+        has_content.reset();
+        open_notes.reset();
+    }
+
+    template<typename Container>
+    void scan(
+        const minimidi::TrackView<Container>& midi_track,
+        const bool                            sanitize_data,
+        vec<std::pair<Tick::unit, i32>>&      tempos,
+        Tick::unit&                           first_time_signature
+    ) {
+        for (const auto& msg : midi_track) {
+            const auto cur_tick = static_cast<Tick::unit>(msg.time);
+            switch (msg.type()) {
+            case minimidi::MessageType::NoteOn: {
+                const auto&   note_on = msg.template cast<minimidi::NoteOn>();
+                const uint8_t pitch   = data_byte("pitch", note_on.pitch(), sanitize_data);
+                if (const uint8_t velocity = data_byte("velocity", note_on.velocity(), sanitize_data);
+                    velocity != 0) {
+                    this->note_on(note_on.channel(), pitch, velocity, cur_tick);
+                } else {
+                    note_off(note_on.channel(), pitch, cur_tick);
+                }
+                break;
+            }
+            case minimidi::MessageType::NoteOff: {
+                const auto&   msg_off = msg.template cast<minimidi::NoteOff>();
+                const uint8_t pitch   = data_byte("pitch", msg_off.pitch(), sanitize_data);
+                (void)data_byte("velocity", msg_off.velocity(), sanitize_data);
+                note_off(msg_off.channel(), pitch, cur_tick);
+                break;
+            }
+            case minimidi::MessageType::ProgramChange: {
+                const auto& program_change = msg.template cast<minimidi::ProgramChange>();
+                cur_program[program_change.channel()]
+                    = data_byte("program", program_change.program(), sanitize_data);
+                break;
+            }
+            case minimidi::MessageType::ControlChange: {
+                const auto& control_change = msg.template cast<minimidi::ControlChange>();
+                (void)data_byte("control_number", control_change.control_number(), sanitize_data);
+                (void)data_byte("control_value", control_change.control_value(), sanitize_data);
+                add_channel_event(control_change.channel(), cur_tick);
+                break;
+            }
+            case minimidi::MessageType::PitchBend: {
+                const auto& pitch_bend = msg.template cast<minimidi::PitchBend>();
+                (void)data_byte("pitch_bend", pitch_bend.data[0], sanitize_data);
+                (void)data_byte("pitch_bend", pitch_bend.data[1], sanitize_data);
+                add_channel_event(pitch_bend.channel(), cur_tick);
+                break;
+            }
+            case minimidi::MessageType::Meta: {
+                switch (const auto& meta = msg.template cast<minimidi::Meta>(); meta.meta_type()) {
+                case (minimidi::MetaType::TimeSignature): {
+                    const auto& time_sig = meta.template cast<minimidi::TimeSignature>();
+                    if (info.time_signature_num++ == 0 || cur_tick < first_time_signature) {
+                        first_time_signature = cur_tick;
+                        info.numerator       = time_sig.numerator();
+                        info.denominator     = time_sig.denominator();
+                    }
+                    touch_end(cur_tick);
+                    break;
+                }
+                case (minimidi::MetaType::SetTempo): {
+                    tempos.emplace_back(cur_tick, meta.template cast<minimidi::SetTempo>().tempo());
+                    touch_end(cur_tick);
+                    break;
+                }
+                case (minimidi::MetaType::KeySignature): {
+                    ++info.key_signature_num;
+                    touch_end(cur_tick);
+                    break;
+                }
+                case (minimidi::MetaType::Lyric): {
+                    const uint16_t key = create(meta.channel());
+                    if (has_text(meta.meta_value())) {
+                        has_content.set(key);
+                        touch_end(cur_tick);
+                    }
+                    break;
+                }
+                case (minimidi::MetaType::Marker): {
+                    if (has_text(meta.meta_value())) touch_end(cur_tick);
+                    break;
+                }
+                default: break;
+                }
+                break;
+            }
+            default: break;
+            }
+        }
+        info.num_tracks += static_cast<u32>(has_content.count());
+    }
+};
+
+/// Map ``tick`` to seconds with the same segment walk as ``Tick2SecondConverter``.
+f32 tick_to_second(vec<std::pair<Tick::unit, i32>> tempos, const f64 tpq, const Tick::unit tick) {
+    std::sort(tempos.begin(), tempos.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.first < rhs.first;
+    });
+    if (tempos.empty() || tempos.front().first != 0) tempos.insert(tempos.begin(), {0, 500000});
+
+    f32        pivot_to   = 0;
+    Tick::unit pivot_from = 0;
+    f64        factor     = static_cast<f64>(tempos.front().second) / 1000000. / tpq;
+    for (size_t i = 1; i < tempos.size() && tempos[i].first <= tick; ++i) {
+        pivot_to += static_cast<f32>(factor * (tempos[i].first - pivot_from));
+        pivot_from = tempos[i].first;
+        factor     = static_cast<f64>(tempos[i].second) / 1000000. / tpq;
+    }
+    return pivot_to + static_cast<f32>(factor * (tick - pivot_from));
+}
+
+template<typename Container>
+MidiInfo scan_midi(const minimidi::MidiFileView<Container>& midi, const bool sanitize_data) {
+    MidiInfo info;
+    info.ticks_per_quarter = midi.ticks_per_quarter();
+
+    vec<std::pair<Tick::unit, i32>> tempos;
+    Tick::unit                      first_time_signature = 0;
+    ChunkScanner                    scanner(info);
+    for (const minimidi::TrackView<Container>& midi_track : midi) {
+        ++info.num_midi_tracks;
+        scanner.reset();
+        scanner.scan(midi_track, sanitize_data, tempos, first_time_signature);
+    }
+
+    info.tempo_num = static_cast<u32>(tempos.size());
+    if (!tempos.empty()) {
+        const auto [min_it, max_it] = std::minmax_element(
+            tempos.begin(), tempos.end(), [](const auto& a, const auto& b) {
+                return a.second < b.second;
+            }
+        );
+        // a larger mspq is a slower tempo
+        info.min_qpm = Tempo<Tick>::mspq2qpm(max_it->second);
+        info.max_qpm = Tempo<Tick>::mspq2qpm(min_it->second);
+    }
+    info.end_second = tick_to_second(
+        std::move(tempos), static_cast<f64>(info.ticks_per_quarter), info.end_tick
+    );
+    return info;
+}
+
+}   // namespace
+
+}   // namespace details
+
+MidiInfo scan_midi(const std::span<const u8> bytes, const bool sanitize_data) {
+    const minimidi::MidiFileView<std::span<const uint8_t>> midi{bytes.data(), bytes.size()};
+    return details::scan_midi(midi, sanitize_data);
+}
+
+MidiInfo scan_midi(const std::filesystem::path& path, const bool sanitize_data) {
+    const MappedFile file(path);
+    return scan_midi(file.bytes(), sanitize_data);
+}
+
+}   // namespace symusic
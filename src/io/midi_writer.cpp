@@ -0,0 +1,775 @@
+//
+// Direct MIDI encoder. Every track is written by a k-way merge over its event lists, so events go
+// from the score to wire-format bytes without being collected into message objects first.
+//
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdio>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+#include "MetaMacro.h"
+
+#include "symusic/detail/parallel.h"
+#include "symusic/detail/time_conversion.h"
+#include "symusic/io/midi_writer.h"
+
+namespace symusic {
+
+namespace details {
+
+namespace {
+
+/// Appends Standard MIDI File chunks to a byte buffer.
+class MidiEncoder {
+    vec<u8>&   out;
+    const bool running_status;
+    size_t     chunk_begin = 0;
+    u32        last_time   = 0;
+    u8         running     = 0;
+
+    void vlq(u32 value) {
+        u8     buffer[5];
+        size_t num    = 0;
+        buffer[num++] = value & 0x7F;
+        while (value >>= 7) buffer[num++] = 0x80 | (value & 0x7F);
+        while (num > 0) out.push_back(buffer[--num]);
+    }
+
+    void be(const u32 value, const size_t num) {
+        for (size_t i = num; i-- > 0;) out.push_back(static_cast<u8>(value >> (8 * i)));
+    }
+
+    void delta(const u32 time) {
+        vlq(time - last_time);
+        last_time = time;
+    }
+
+    void status(const u8 status) {
+        if (!running_status || status != running) out.push_back(status);
+        running = status;
+    }
+
+public:
+    MidiEncoder(vec<u8>& out, const bool running_status) :
+        out(out), running_status(running_status) {}
+
+    void header(const u16 format, const u16 num_tracks, const u16 ticks_per_quarter) {
+        out.insert(out.end(), {'M', 'T', 'h', 'd'});
+        be(6, 4);
+        be(format, 2);
+        be(num_tracks, 2);
+        be(ticks_per_quarter, 2);
+    }
+
+    void begin_track() {
+        chunk_begin = out.size();
+        out.insert(out.end(), {'M', 'T', 'r', 'k', 0, 0, 0, 0});
+        last_time = 0;
+        running   = 0;
+    }
+
+    /// Append the End of Track event and patch the chunk length.
+    void end_track() {
+        meta(last_time, 0x2F, {});
+        const size_t length = out.size() - chunk_begin - 8;
+        for (size_t i = 0; i < 4; ++i) {
+            out[chunk_begin + 4 + i] = static_cast<u8>(length >> (24 - 8 * i));
+        }
+    }
+
+    void channel(const u32 time, const u8 status_byte, const u8 data) {
+        delta(time);
+        status(status_byte);
+        out.push_back(data);
+    }
+
+    void channel(const u32 time, const u8 status_byte, const u8 data0, const u8 data1) {
+        delta(time);
+        status(status_byte);
+        out.push_back(data0);
+        out.push_back(data1);
+    }
+
+    void meta(const u32 time, const u8 type, const std::span<const u8> data) {
+        delta(time);
+        out.push_back(0xFF);
+        out.push_back(type);
+        vlq(static_cast<u32>(data.size()));
+        out.insert(out.end(), data.begin(), data.end());
+        // meta events cancel running status
+        running = 0;
+    }
+
+    void text(const u32 time, const u8 type, const std::string& text) {
+        meta(time, type, {reinterpret_cast<const u8*>(text.data()), text.size()});
+    }
+};
+
+constexpr u64 exhausted = std::numeric_limits<u64>::max();
+
+/// Ticks are written as unsigned deltas, negative times are clamped to the start of the track.
+u32 to_wire_time(const Tick::unit time) { return time < 0 ? 0 : static_cast<u32>(time); }
+
+/**
+ * Maps the times of a score to ticks exactly like ``convert<Tick>`` would, one event at a time, so
+ * that no tick copy of the score is needed.
+ */
+template<TType T>
+struct TickClock;
+
+template<>
+struct TickClock<Tick> {
+    explicit TickClock(const Score<Tick>&) {}
+
+    [[nodiscard]] static Tick::unit time(const Tick::unit time) { return time; }
+
+    [[nodiscard]] static Tick::unit end(const Note<Tick>& note, const Tick::unit start) {
+        return note.duration > 0 ? start + note.duration : start;
+    }
+};
+
+template<>
+struct TickClock<Quarter> {
+    Quarter2TickConverter converter;
+
+    explicit TickClock(const Score<Quarter>& score) : converter(score) {}
+
+    [[nodiscard]] Tick::unit time(const Quarter::unit time) const {
+        return converter.time_value(time);
+    }
+
+    // durations are rounded on their own, like convert<Tick> does
+    [[nodiscard]] Tick::unit end(const Note<Quarter>& note, const Tick::unit start) const {
+        return start + std::max(converter.time_value(note.duration), 0);
+    }
+};
+
+template<>
+struct TickClock<Second> {
+    Second2TickConverter converter;
+
+    explicit TickClock(const Score<Second>& score) : converter(score) {}
+
+    // the tempo map starts at zero, and negative times end up at the track start anyway
+    [[nodiscard]] Tick::unit time(const Second::unit time) const {
+        return time > 0 ? converter.time_value(time) : 0;
+    }
+
+    [[nodiscard]] Tick::unit end(const Note<Second>& note, const Tick::unit start) const {
+        return std::max(start, time(note.end()));
+    }
+};
+
+/// Reusable buffers of a ``Cursor``, kept between tracks.
+struct CursorScratch {
+    vec<Tick::unit> keys;
+    vec<u32>        order;
+};
+
+/**
+ * Walks one event list in the order of its tick ``key``: in place when the list is already
+ * ordered, otherwise through a stable index order, so that events with equal keys keep their list
+ * order. Keys are computed once per event.
+ */
+template<typename Event, typename Key>
+class Cursor {
+    const pyvec<Event>* events = nullptr;
+    const Tick::unit*   keys   = nullptr;
+    const u32*          order  = nullptr;
+    size_t              pos    = 0;
+    size_t              size   = 0;
+
+    void update() {
+        time = pos < size ? to_wire_time(keys[order ? order[pos] : pos]) : exhausted;
+    }
+
+public:
+    u64 time = exhausted;   // wire time of the current event
+
+    void reset(const pyvec<Event>& list, const Key& key, CursorScratch& scratch) {
+        events = &list;
+        size   = list.size();
+        pos    = 0;
+        order  = nullptr;
+        scratch.keys.resize(size);
+        bool sorted = true;
+        for (size_t i = 0; i < size; ++i) {
+            scratch.keys[i] = key(list[i]);
+            sorted          = sorted && (i == 0 || scratch.keys[i - 1] <= scratch.keys[i]);
+        }
+        keys = scratch.keys.data();
+        if (!sorted) {
+            auto& indices = scratch.order;
+            indices.resize(size);
+            std::iota(indices.begin(), indices.end(), 0);
+            std::stable_sort(indices.begin(), indices.end(), [this](const u32 a, const u32 b) {
+                return keys[a] < keys[b];
+            });
+            order = indices.data();
+        }
+        update();
+    }
+
+    void clear() {
+        size = pos = 0;
+        update();
+    }
+
+    [[nodiscard]] const Event& current() const {
+        return order ? (*events)[order[pos]] : (*events)[pos];
+    }
+
+    void next() {
+        ++pos;
+        update();
+    }
+};
+
+template<TType T>
+struct TimeKey {
+    const TickClock<T>* clock;
+
+    template<typename Event>
+    Tick::unit operator()(const Event& event) const {
+        return clock->time(event.time);
+    }
+};
+
+/// Note-offs and the note-ons of zero-length notes, which come first at equal times.
+template<TType T>
+struct EarlyNoteKey {
+    const TickClock<T>* clock;
+
+    Tick::unit operator()(const Note<T>& note) const {
+        return clock->end(note, clock->time(note.time));
+    }
+};
+
+/**
+ * Whether control change ``number`` sets a value rather than triggering an action, so that
+ * repeating the last value sent has no effect. Data entry (6, 38), data increment and decrement
+ * (96, 97), parameter number selects (98-101) and channel mode messages (120-127) are actions.
+ */
+constexpr bool is_state_controller(const u8 number) {
+    return number != 6 && number != 38 && (number < 96 || number > 101) && number < 120;
+}
+
+/// Last values sent on one MIDI channel, used to drop repeated values in compact output.
+struct ChannelState {
+    std::array<i16, 128> controls;
+    i32                  pitch_bend;
+
+    ChannelState() { reset(); }
+
+    void reset() {
+        controls.fill(-1);
+        pitch_bend = -1;
+    }
+};
+
+/**
+ * Encodes the tracks of a score, converting times to ticks on the fly. The cursor scratch is kept
+ * between tracks.
+ *
+ * Within a track, events are ordered by time, and at equal times by source: time signatures, key
+ * signatures, tempos and markers (first track only), track name, program change, controls, pitch
+ * bends, lyrics, then note-offs before note-ons. Note-offs of zero-length notes follow their
+ * note-ons.
+ *
+ * ``begin`` starts a track and ``emit`` writes its next event, so that several writers can share
+ * one chunk for format 0 output. In compact mode, a tempo that repeats the last one is left out,
+ * and so are a program change to program 0 and every control change (of a state controller, see
+ * ``is_state_controller``) or pitch bend that repeats the last value sent, unless the channel is
+ * shared with another track: there, the other track may have changed the program or value in
+ * between. Reset All Controllers forgets the last values sent.
+ */
+template<TType T>
+class TrackWriter {
+    enum Source : u8 {
+        TimeSignatures,
+        KeySignatures,
+        Tempos,
+        Markers,
+        TrackName,
+        ProgramChange,
+        Controls,
+        PitchBends,
+        Lyrics,
+        EarlyNotes,
+        LateNotes,
+        NumSources,
+    };
+
+    const TickClock<T>*                   clock;
+    bool                                  compact;
+    std::array<CursorScratch, NumSources> scratch;
+
+    Cursor<TimeSignature<T>, TimeKey<T>> time_signatures;
+    Cursor<KeySignature<T>, TimeKey<T>>  key_signatures;
+    Cursor<Tempo<T>, TimeKey<T>>         tempos;
+    Cursor<TextMeta<T>, TimeKey<T>>      markers;
+    Cursor<ControlChange<T>, TimeKey<T>> controls;
+    Cursor<PitchBend<T>, TimeKey<T>>     pitch_bends;
+    Cursor<TextMeta<T>, TimeKey<T>>      lyrics;
+    Cursor<Note<T>, EarlyNoteKey<T>>     early_notes;
+    Cursor<Note<T>, TimeKey<T>>          late_notes;
+
+    const Track<T>*             track   = nullptr;
+    u8                          channel = 0;
+    ChannelState*               state   = nullptr;
+    bool                        dedup   = false;   // drop redundant channel messages
+    i32                         tempo   = -1;   // last tempo written
+    std::array<u64, NumSources> next{};
+    size_t                      source = 0;     // source of the next event
+
+    /// Whether ``note`` lasts at least one tick after conversion.
+    [[nodiscard]] bool sounding(const Note<T>& note) const {
+        const auto start = clock->time(note.time);
+        return clock->end(note, start) > start;
+    }
+
+    void select() {
+        // the first source wins ties, which keeps the order documented above
+        source = 0;
+        for (size_t i = 1; i < NumSources; ++i) {
+            if (next[i] < next[source]) source = i;
+        }
+    }
+
+public:
+    TrackWriter(const TickClock<T>& clock, const bool compact) : clock(&clock), compact(compact) {}
+
+    /**
+     * Start on the conductor events of ``score`` and, if given, the events of ``track``, sent on
+     * ``channel`` whose last values are kept in ``channel_state``. ``shared`` tells whether other
+     * tracks are sent on the same channel.
+     */
+    void begin(
+        const Score<T>& score,
+        const bool      conductor,
+        const Track<T>* track_,
+        const u8        channel_,
+        ChannelState&   channel_state,
+        const bool      shared,
+        const bool      with_name = true
+    ) {
+        track   = track_;
+        channel = channel_;
+        state   = &channel_state;
+        dedup   = compact && !shared;
+        tempo   = -1;
+
+        const TimeKey<T>      time_key{clock};
+        const EarlyNoteKey<T> early_key{clock};
+        if (conductor) {
+            time_signatures.reset(*score.time_signatures, time_key, scratch[TimeSignatures]);
+            key_signatures.reset(*score.key_signatures, time_key, scratch[KeySignatures]);
+            tempos.reset(*score.tempos, time_key, scratch[Tempos]);
+            markers.reset(*score.markers, time_key, scratch[Markers]);
+        } else {
+            time_signatures.clear();
+            key_signatures.clear();
+            tempos.clear();
+            markers.clear();
+        }
+        next.fill(exhausted);
+        if (track) {
+            controls.reset(*track->controls, time_key, scratch[Controls]);
+            pitch_bends.reset(*track->pitch_bends, time_key, scratch[PitchBends]);
+            lyrics.reset(*track->lyrics, time_key, scratch[Lyrics]);
+            early_notes.reset(*track->notes, early_key, scratch[EarlyNotes]);
+            late_notes.reset(*track->notes, time_key, scratch[LateNotes]);
+            if (with_name && !track->name.empty()) next[TrackName] = 0;
+            if (!dedup || track->program != 0) next[ProgramChange] = 0;
+        } else {
+            controls.clear();
+            pitch_bends.clear();
+            lyrics.clear();
+            early_notes.clear();
+            late_notes.clear();
+        }
+        next[TimeSignatures] = time_signatures.time;
+        next[KeySignatures]  = key_signatures.time;
+        next[Tempos]         = tempos.time;
+        next[Markers]        = markers.time;
+        next[Controls]       = controls.time;
+        next[PitchBends]     = pitch_bends.time;
+        next[Lyrics]         = lyrics.time;
+        next[EarlyNotes]     = early_notes.time;
+        next[LateNotes]      = late_notes.time;
+        select();
+    }
+
+    /// Wire time of the next event, ``exhausted`` once every event has been written.
+    [[nodiscard]] u64 time() const { return next[source]; }
+
+    /// Write the next event, or drop it if it is redundant in compact mode.
+    void emit(MidiEncoder& encoder) {
+        const auto time     = static_cast<u32>(next[source]);
+        const u8   note_on  = 0x90 | channel;
+        const u8   note_off = 0x80 | channel;
+
+        switch (source) {
+        case TimeSignatures: {
+            const auto& event = time_signatures.current();
+            const u8    data[4]{
+                event.numerator,
+                static_cast<u8>(event.denominator ? std::bit_width(event.denominator) - 1 : 0),
+                24,
+                8,
+            };
+            encoder.meta(time, 0x58, data);
+            time_signatures.next();
+            next[source] = time_signatures.time;
+            break;
+        }
+        case KeySignatures: {
+            const auto& event = key_signatures.current();
+            const u8    data[2]{static_cast<u8>(event.key), static_cast<u8>(event.tonality)};
+            encoder.meta(time, 0x59, data);
+            key_signatures.next();
+            next[source] = key_signatures.time;
+            break;
+        }
+        case Tempos: {
+            const auto mspq = tempos.current().mspq;
+            if (!compact || mspq != tempo) {
+                const auto bytes = static_cast<u32>(mspq);
+                const u8   data[3]{
+                    static_cast<u8>(bytes >> 16), static_cast<u8>(bytes >> 8), static_cast<u8>(bytes)
+                };
+                encoder.meta(time, 0x51, data);
+                tempo = mspq;
+            }
+            tempos.next();
+            next[source] = tempos.time;
+            break;
+        }
+        case Markers: {
+            encoder.text(time, 0x06, markers.current().text);
+            markers.next();
+            next[source] = markers.time;
+            break;
+        }
+        case TrackName: {
+            encoder.text(time, 0x03, track->name);
+            next[source] = exhausted;
+            break;
+        }
+        case ProgramChange: {
+            encoder.channel(time, 0xC0 | channel, track->program);
+            next[source] = exhausted;
+            break;
+        }
+        case Controls: {
+            const auto& event  = controls.current();
+            const u8    number = event.number & 0x7F;
+            auto&       last   = state->controls[number];
+            if (!dedup || !is_state_controller(number) || last != event.value) {
+                encoder.channel(time, 0xB0 | channel, event.number, event.value);
+                last = event.value;
+                if (number == 121) state->reset();   // Reset All Controllers
+            }
+            controls.next();
+            next[source] = controls.time;
+            break;
+        }
+        case PitchBends: {
+            const auto value = std::clamp(pitch_bends.current().value + 8192, 0, 16383);
+            if (!dedup || state->pitch_bend != value) {
+                encoder.channel(
+                    time, 0xE0 | channel, static_cast<u8>(value & 0x7F), static_cast<u8>(value >> 7)
+                );
+                state->pitch_bend = value;
+            }
+            pitch_bends.next();
+            next[source] = pitch_bends.time;
+            break;
+        }
+        case Lyrics: {
+            encoder.text(time, 0x05, lyrics.current().text);
+            lyrics.next();
+            next[source] = lyrics.time;
+            break;
+        }
+        case EarlyNotes: {
+            const auto& note = early_notes.current();
+            encoder.channel(
+                time,
+                sounding(note) ? note_off : note_on,
+                static_cast<u8>(note.pitch),
+                static_cast<u8>(note.velocity)
+            );
+            early_notes.next();
+            next[source] = early_notes.time;
+            break;
+        }
+        case LateNotes: {
+            const auto& note = late_notes.current();
+            encoder.channel(
+                time,
+                sounding(note) ? note_on : note_off,
+                static_cast<u8>(note.pitch),
+                static_cast<u8>(note.velocity)
+            );
+            late_notes.next();
+            next[source] = late_notes.time;
+            break;
+        }
+        default: break;
+        }
+        select();
+    }
+
+    /// Write the conductor events of ``score`` and, if given, the events of ``track`` as a chunk.
+    void write(
+        MidiEncoder&    encoder,
+        const Score<T>& score,
+        const bool      conductor,
+        const Track<T>* track_,
+        const u8        channel_,
+        const bool      shared
+    ) {
+        ChannelState channel_state;
+        begin(score, conductor, track_, channel_, channel_state, shared);
+        encoder.begin_track();
+        while (time() != exhausted) { emit(encoder); }
+        encoder.end_track();
+    }
+};
+
+/// Rough size of an encoded track chunk, used to reserve its buffer once.
+template<TType T>
+size_t estimate_size(const Track<T>& track) {
+    return 8 + 16 + track.name.size() + 8 * track.notes->size()
+           + 4 * (track.controls->size() + track.pitch_bends->size()) + 16 * track.lyrics->size();
+}
+
+/// Rough size of the encoded score, used to reserve the output buffer once.
+template<TType T>
+size_t estimate_size(const Score<T>& score) {
+    size_t size = 14 + 8 + 16 * (score.time_signatures->size() + score.key_signatures->size()
+                                 + score.tempos->size() + score.markers->size());
+    for (const auto& track : *score.tracks) { size += estimate_size(*track); }
+    return size;
+}
+
+constexpr std::array<u8, 15> valid_channel{0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 11, 12, 13, 14, 15};
+
+/// Drums go to channel 10, other tracks take the remaining channels in turn.
+template<TType T>
+u8 track_channel(const Track<T>& track, const size_t idx) {
+    return track.is_drum ? 9 : valid_channel[idx % valid_channel.size()];
+}
+
+/// Number of tracks of ``score`` sent on each channel.
+template<TType T>
+std::array<size_t, 16> channel_tracks(const Score<T>& score) {
+    std::array<size_t, 16> counts{};
+    for (size_t idx = 0; const auto& track : *score.tracks) {
+        ++counts[track_channel(*track, idx)];
+        ++idx;
+    }
+    return counts;
+}
+
+/**
+ * Encode ``score`` into ``buffer`` and hand it to ``flush`` after the header and after every track
+ * chunk. ``flush`` may consume and clear the buffer; the encoder only appends to it.
+ */
+template<TType T, typename Flush>
+void write_midi(
+    const Score<T>&     score,
+    const TickClock<T>& clock,
+    const DumpOptions&  options,
+    vec<u8>&            buffer,
+    Flush&&             flush
+) {
+    // conductor events go into the first track, or into a track of their own if there is none
+    const bool has_conductor = !score.time_signatures->empty() || !score.key_signatures->empty()
+                               || !score.tempos->empty() || !score.markers->empty();
+    const auto& tracks = *score.tracks;
+    const size_t num_tracks
+        = options.format == 0 ? 1 : (tracks.empty() ? (has_conductor ? 1 : 0) : tracks.size());
+
+    MidiEncoder encoder(buffer, options.running_status || options.compact);
+    encoder.header(
+        options.format, static_cast<u16>(num_tracks), static_cast<u16>(score.ticks_per_quarter)
+    );
+    flush();
+
+    if (options.format == 0) {
+        // one writer per track, interleaved by time into a single chunk; ties go to the earlier
+        // track, and only the first track name is kept
+        std::array<ChannelState, 16> channels;
+        const auto                   counts = channel_tracks(score);
+        vec<TrackWriter<T>>          writers;
+        writers.reserve(std::max<size_t>(tracks.size(), 1));
+        writers.emplace_back(clock, options.compact);
+        if (tracks.empty()) { writers.back().begin(score, true, nullptr, 0, channels[0], false); }
+        for (size_t idx = 0; idx < tracks.size(); ++idx) {
+            if (idx > 0) writers.emplace_back(clock, options.compact);
+            const auto& track   = *tracks[idx];
+            const u8    channel = track_channel(track, idx);
+            writers.back().begin(
+                score, idx == 0, &track, channel, channels[channel], counts[channel] > 1, idx == 0
+            );
+        }
+        encoder.begin_track();
+        while (true) {
+            TrackWriter<T>* first = nullptr;
+            for (auto& writer : writers) {
+                if (writer.time() != exhausted && (!first || writer.time() < first->time())) {
+                    first = &writer;
+                }
+            }
+            if (!first) break;
+            first->emit(encoder);
+        }
+        encoder.end_track();
+        flush();
+        return;
+    }
+
+    TrackWriter<T> writer(clock, options.compact);
+    if (tracks.empty()) {
+        if (has_conductor) {
+            writer.write(encoder, score, true, nullptr, 0, false);
+            flush();
+        }
+        return;
+    }
+    const auto counts = channel_tracks(score);
+    for (size_t idx = 0; const auto& track : tracks) {
+        const u8 channel = track_channel(*track, idx);
+        writer.write(encoder, score, idx == 0, track.get(), channel, counts[channel] > 1);
+        flush();
+        ++idx;
+    }
+}
+
+/**
+ * Encode the track chunks of ``score`` concurrently, each into a buffer of its own, and join them
+ * in track order. The bytes are the same as those of ``write_midi``.
+ */
+template<TType T>
+vec<u8> dumps_midi_parallel(
+    const Score<T>& score, const TickClock<T>& clock, const DumpOptions& options
+) {
+    const auto&  tracks     = *score.tracks;
+    const size_t num_tracks = tracks.size();
+
+    vec<vec<u8>>        chunks(num_tracks);
+    vec<TrackWriter<T>> writers;
+    const size_t        num_workers = resolve_num_threads(options.num_threads, num_tracks);
+    writers.reserve(num_workers);
+    for (size_t i = 0; i < num_workers; ++i) { writers.emplace_back(clock, options.compact); }
+    const auto counts = channel_tracks(score);
+    const auto encode = [&](const size_t worker, const size_t idx) {
+        const auto& track   = *tracks[idx];
+        const u8    channel = track_channel(track, idx);
+        chunks[idx].reserve(estimate_size(track));
+        MidiEncoder encoder(chunks[idx], options.running_status || options.compact);
+        writers[worker].write(encoder, score, idx == 0, &track, channel, counts[channel] > 1);
+    };
+    parallel_for_workers(num_tracks, options.num_threads, encode);
+
+    size_t size = 14;
+    for (const auto& chunk : chunks) { size += chunk.size(); }
+    vec<u8> buffer;
+    buffer.reserve(size);
+    MidiEncoder(buffer, options.running_status || options.compact)
+        .header(1, static_cast<u16>(num_tracks), static_cast<u16>(score.ticks_per_quarter));
+    for (const auto& chunk : chunks) { buffer.insert(buffer.end(), chunk.begin(), chunk.end()); }
+    return buffer;
+}
+
+/// Validate ``options`` and tell whether track chunks should be encoded concurrently.
+template<TType T>
+bool use_parallel(const Score<T>& score, const DumpOptions& options) {
+    if (options.format > 1) {
+        throw std::invalid_argument(
+            "MIDI format must be 0 or 1, got " + std::to_string(options.format)
+        );
+    }
+    return options.num_threads != 1 && options.format == 1 && score.tracks->size() > 1;
+}
+
+}   // namespace
+
+template<TType T>
+vec<u8> dumps_midi(const Score<T>& score, const DumpOptions& options) {
+    const TickClock<T> clock(score);
+    if (use_parallel(score, options)) {
+        return dumps_midi_parallel(score, clock, options);
+    }
+    vec<u8> buffer;
+    buffer.reserve(estimate_size(score));
+    write_midi(score, clock, options, buffer, [] {});
+    return buffer;
+}
+
+template<TType T>
+void dump_midi(const Score<T>& score, std::FILE* file, const DumpOptions& options) {
+    const auto write = [file](const vec<u8>& buffer) {
+        if (std::fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size()) {
+            throw std::runtime_error("Failed to write MIDI data");
+        }
+    };
+    const TickClock<T> clock(score);
+    if (use_parallel(score, options)) {
+        write(dumps_midi_parallel(score, clock, options));
+        return;
+    }
+    vec<u8> buffer;
+    write_midi(score, clock, options, buffer, [&] {
+        write(buffer);
+        buffer.clear();
+    });
+}
+
+}   // namespace details
+
+template<TType T>
+void dump_midi(const Score<T>& score, std::FILE* file, const DumpOptions& options) {
+    details::dump_midi(score, file, options);
+}
+
+template<>
+template<>
+vec<u8> Score<Tick>::dumps<DataFormat::MIDI>() const {
+    return details::dumps_midi(*this, {});
+}
+
+template<>
+template<>
+vec<u8> Score<Quarter>::dumps<DataFormat::MIDI>() const {
+    return details::dumps_midi(*this, {});
+}
+
+template<>
+template<>
+vec<u8> Score<Second>::dumps<DataFormat::MIDI>() const {
+    return details::dumps_midi(*this, {});
+}
+
+#define INSTANTIATE_MIDI_WRITER(__COUNT, T)                                                    \
+    template void dump_midi<T>(const Score<T>&, std::FILE*, const DumpOptions&);               \
+    template<>                                                                                 \
+    vec<u8> dumps<DataFormat::MIDI, Score<T>>(const Score<T>& data) {                          \
+        return data.dumps<DataFormat::MIDI>();                                                 \
+    }                                                                                          \
+    template<>                                                                                 \
+    vec<u8> dumps<DataFormat::MIDI, Score<T>>(const Score<T>& data, const DumpOptions& options) { \
+        return details::dumps_midi(data, options);                                             \
+    }
+
+REPEAT_ON(INSTANTIATE_MIDI_WRITER, Tick, Quarter, Second)
+#undef INSTANTIATE_MIDI_WRITER
+
+}   // namespace symusic
@@ -0,0 +1,383 @@
+//
+// Score map files: event arrays stored as in-memory structs, used in place through a memory map.
+//
+// Layout (host byte order), every array aligned to 64 bytes:
+//
+//   FileHeader | TrackRecord[num_tracks] | event and text record arrays | text bytes
+//
+// Every array is described by a Section (absolute offset, element count). Text events are
+// TextRecords pointing at their bytes in the text section, which also holds the track names.
+//
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#include "fmt/format.h"
+#include "MetaMacro.h"
+
+#include "symusic/io/score_map.h"
+
+namespace symusic {
+
+namespace {
+
+constexpr std::array<u8, 4> kScoreMapMagic{'S', 'Y', 'M', 'M'};
+constexpr u8                kScoreMapVersion = 1;
+constexpr size_t            kAlignment       = 64;
+
+struct Section {
+    u64 offset = 0;
+    u64 count  = 0;
+};
+
+template<TType T>
+struct TextRecord {
+    u64              offset;
+    u32              size;
+    typename T::unit time;
+};
+
+struct TrackRecord {
+    Section name;   // bytes in the text section
+    u8      program;
+    u8      is_drum;
+    u8      reserved[6];
+    Section notes;
+    Section controls;
+    Section pitch_bends;
+    Section pedals;
+    Section lyrics;
+};
+
+struct FileHeader {
+    std::array<u8, 4> magic;
+    u8                version;
+    u8                unit;
+    u8                little_endian;
+    u8                reserved;
+    i32               tpq;
+    u32               num_tracks;
+    std::array<u8, 8> event_sizes;
+    u64               file_size;
+    Section           tracks;
+    Section           time_signatures;
+    Section           key_signatures;
+    Section           tempos;
+    Section           markers;
+    Section           text;
+};
+
+template<TType T>
+constexpr u8 unit_code() {
+    if constexpr (std::is_same_v<T, Tick>) return 0;
+    else if constexpr (std::is_same_v<T, Quarter>) return 1;
+    else return 2;
+}
+
+constexpr std::array<const char*, 3> kUnitNames{"Tick", "Quarter", "Second"};
+
+// Sizes of the stored structs, so a file written with another layout is rejected.
+template<TType T>
+constexpr std::array<u8, 8> event_sizes() {
+    return {
+        sizeof(Note<T>),         sizeof(Pedal<T>),        sizeof(ControlChange<T>),
+        sizeof(TimeSignature<T>), sizeof(KeySignature<T>), sizeof(Tempo<T>),
+        sizeof(PitchBend<T>),    sizeof(TextRecord<T>),
+    };
+}
+
+[[noreturn]] void invalid_score_map(const std::string_view what) {
+    throw std::runtime_error(fmt::format("Invalid score map: {}", what));
+}
+
+class MapWriter {
+public:
+    vec<u8> out;
+
+    void align() { out.resize((out.size() + kAlignment - 1) / kAlignment * kAlignment); }
+
+    template<typename Event>
+    Section array(const pyvec<Event>& events) {
+        align();
+        const Section section{out.size(), events.size()};
+        out.resize(out.size() + events.size() * sizeof(Event));
+        u8* dst = out.data() + section.offset;
+        for (const auto& event : events) {
+            std::memcpy(dst, &event, sizeof(Event));
+            dst += sizeof(Event);
+        }
+        return section;
+    }
+
+    // Text records point at bytes appended to ``text`` and fixed up once its offset is known
+    template<TType T>
+    Section texts(const pyvec<TextMeta<T>>& events) {
+        align();
+        const Section section{out.size(), events.size()};
+        out.resize(out.size() + events.size() * sizeof(TextRecord<T>));
+        u8* dst = out.data() + section.offset;
+        for (const auto& event : events) {
+            const TextRecord<T> record{
+                text_offset(event.text), static_cast<u32>(event.text.size()), event.time
+            };
+            const auto at = static_cast<size_t>(dst - out.data());
+            pending.push_back(at + offsetof(TextRecord<T>, offset));
+            std::memcpy(dst, &record, sizeof(record));
+            dst += sizeof(record);
+        }
+        return section;
+    }
+
+    Section name(const std::string& name) { return {text_offset(name), name.size()}; }
+
+    // Append the text section and turn the relative text offsets into absolute ones
+    Section finish_text(vec<size_t> name_fields) {
+        const Section section{out.size(), text.size()};
+        out.insert(out.end(), text.begin(), text.end());
+        for (const size_t at : pending) add_offset(at, section.offset);
+        for (const size_t at : name_fields) add_offset(at, section.offset);
+        return section;
+    }
+
+private:
+    std::string text;
+    vec<size_t> pending;   // positions of TextRecord::offset fields
+
+    u64 text_offset(const std::string& value) {
+        if (value.size() > std::numeric_limits<u32>::max()) {
+            throw std::invalid_argument("ScoreMap texts are limited to 4 GiB each");
+        }
+        const u64 offset = text.size();
+        text += value;
+        return offset;
+    }
+
+    void add_offset(const size_t at, const u64 base) {
+        u64 value;
+        std::memcpy(&value, out.data() + at, sizeof(value));
+        value += base;
+        std::memcpy(out.data() + at, &value, sizeof(value));
+    }
+};
+
+// Checked access to the sections of a mapped file
+class MapReader {
+public:
+    explicit MapReader(const std::span<const u8> bytes) : bytes(bytes) {}
+
+    template<typename Event>
+    std::span<const Event> array(const Section& section, const std::string_view what) const {
+        if (section.offset % alignof(Event) != 0 || section.offset > bytes.size()
+            || section.count > (bytes.size() - section.offset) / sizeof(Event)) {
+            invalid_score_map(fmt::format("{} section out of bounds", what));
+        }
+        return {
+            reinterpret_cast<const Event*>(bytes.data() + section.offset),
+            static_cast<size_t>(section.count)
+        };
+    }
+
+    std::string_view text(const u64 offset, const u64 size) const {
+        if (offset < text_section.offset || offset > text_end || size > text_end - offset) {
+            invalid_score_map("text out of bounds");
+        }
+        return {reinterpret_cast<const char*>(bytes.data() + offset), static_cast<size_t>(size)};
+    }
+
+    template<TType T>
+    vec<TextView<T>> texts(const Section& section, const std::string_view what) const {
+        const auto       records = array<TextRecord<T>>(section, what);
+        vec<TextView<T>> views;
+        views.reserve(records.size());
+        for (const auto& record : records) {
+            views.push_back({record.time, text(record.offset, record.size)});
+        }
+        return views;
+    }
+
+    void set_text(const Section& section) {
+        if (section.offset > bytes.size() || section.count > bytes.size() - section.offset) {
+            invalid_score_map("text section out of bounds");
+        }
+        text_section = section;
+        text_end     = section.offset + section.count;
+    }
+
+private:
+    std::span<const u8> bytes;
+    Section             text_section;
+    u64                 text_end = 0;
+};
+
+template<typename Event>
+pyvec<Event> to_pyvec(const std::span<const Event> events) {
+    return pyvec<Event>(vec<Event>(events.begin(), events.end()));
+}
+
+template<TType T>
+pyvec<TextMeta<T>> to_pyvec(const vec<TextView<T>>& views) {
+    vec<TextMeta<T>> events;
+    events.reserve(views.size());
+    for (const auto& view : views) events.emplace_back(view.time, std::string(view.text));
+    return pyvec<TextMeta<T>>(std::move(events));
+}
+
+}   // namespace
+
+template<TType T>
+Track<T> TrackMap<T>::to_track() const {
+    return {
+        std::string(name),
+        program,
+        is_drum,
+        to_pyvec(notes),
+        to_pyvec(controls),
+        to_pyvec(pitch_bends),
+        to_pyvec(pedals),
+        to_pyvec(lyrics)
+    };
+}
+
+template<TType T>
+ScoreMap<T>::ScoreMap(const std::filesystem::path& path) : file(path) {
+    const auto bytes = file.bytes();
+    if (bytes.size() < sizeof(FileHeader)) invalid_score_map("file too short");
+    FileHeader header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (header.magic != kScoreMapMagic) invalid_score_map("missing SYMM header");
+    if (header.version != kScoreMapVersion) {
+        throw std::runtime_error(fmt::format(
+            "Unsupported score map version {} (this build reads version {})", header.version,
+            kScoreMapVersion
+        ));
+    }
+    if (header.little_endian != (std::endian::native == std::endian::little)
+        || header.event_sizes != event_sizes<T>()) {
+        throw std::runtime_error("Score map was written on a platform with another memory layout");
+    }
+    if (header.unit != unit_code<T>()) {
+        throw std::runtime_error(fmt::format(
+            "Score map stores {} times but {} was requested",
+            header.unit < kUnitNames.size() ? kUnitNames[header.unit] : "unknown",
+            kUnitNames[unit_code<T>()]
+        ));
+    }
+    if (header.file_size != bytes.size()) invalid_score_map("file size mismatch");
+
+    MapReader reader(bytes);
+    reader.set_text(header.text);
+    tpq          = header.tpq;
+    time_sigs    = reader.array<TimeSignature<T>>(header.time_signatures, "time signature");
+    key_sigs     = reader.array<KeySignature<T>>(header.key_signatures, "key signature");
+    tempo_events = reader.array<Tempo<T>>(header.tempos, "tempo");
+    marker_views = reader.texts<T>(header.markers, "marker");
+
+    const auto records = reader.array<TrackRecord>(header.tracks, "track");
+    track_maps.reserve(records.size());
+    for (const auto& record : records) {
+        TrackMap<T> track;
+        track.name        = reader.text(record.name.offset, record.name.count);
+        track.program     = record.program;
+        track.is_drum     = record.is_drum != 0;
+        track.notes       = reader.array<Note<T>>(record.notes, "note");
+        track.controls    = reader.array<ControlChange<T>>(record.controls, "control");
+        track.pitch_bends = reader.array<PitchBend<T>>(record.pitch_bends, "pitch bend");
+        track.pedals      = reader.array<Pedal<T>>(record.pedals, "pedal");
+        track.lyrics      = reader.texts<T>(record.lyrics, "lyric");
+        track_maps.push_back(std::move(track));
+    }
+}
+
+template<TType T>
+const TrackMap<T>& ScoreMap<T>::track(const size_t index) const {
+    if (index >= track_maps.size()) {
+        throw std::out_of_range(
+            fmt::format("Track index {} out of range for {} tracks", index, track_maps.size())
+        );
+    }
+    return track_maps[index];
+}
+
+template<TType T>
+Score<T> ScoreMap<T>::to_score() const {
+    auto tracks = std::make_shared<vec<shared<Track<T>>>>();
+    tracks->reserve(track_maps.size());
+    for (const auto& track : track_maps) {
+        tracks->push_back(std::make_shared<Track<T>>(track.to_track()));
+    }
+    return {
+        tpq,
+        std::move(tracks),
+        to_pyvec(time_sigs),
+        to_pyvec(key_sigs),
+        to_pyvec(tempo_events),
+        to_pyvec(marker_views)
+    };
+}
+
+template<TType T>
+vec<u8> dumps_score_map(const Score<T>& score) {
+    MapWriter  writer;
+    FileHeader header{};
+    header.magic         = kScoreMapMagic;
+    header.version       = kScoreMapVersion;
+    header.unit          = unit_code<T>();
+    header.little_endian = std::endian::native == std::endian::little;
+    header.tpq           = score.ticks_per_quarter;
+    header.num_tracks    = static_cast<u32>(score.tracks->size());
+    header.event_sizes   = event_sizes<T>();
+    writer.out.resize(sizeof(FileHeader));
+
+    // The track table comes first and is filled in once the arrays are placed
+    writer.align();
+    header.tracks = {writer.out.size(), score.tracks->size()};
+    writer.out.resize(writer.out.size() + score.tracks->size() * sizeof(TrackRecord));
+
+    header.time_signatures = writer.array(*score.time_signatures);
+    header.key_signatures  = writer.array(*score.key_signatures);
+    header.tempos          = writer.array(*score.tempos);
+    header.markers         = writer.texts(*score.markers);
+
+    vec<size_t> name_fields;
+    for (size_t i = 0; i < score.tracks->size(); ++i) {
+        const auto& track = *(*score.tracks)[i];
+        TrackRecord record{};
+        record.name        = writer.name(track.name);
+        record.program     = track.program;
+        record.is_drum     = track.is_drum ? 1 : 0;
+        record.notes       = writer.array(*track.notes);
+        record.controls    = writer.array(*track.controls);
+        record.pitch_bends = writer.array(*track.pitch_bends);
+        record.pedals      = writer.array(*track.pedals);
+        record.lyrics      = writer.texts(*track.lyrics);
+
+        const size_t at = header.tracks.offset + i * sizeof(TrackRecord);
+        std::memcpy(writer.out.data() + at, &record, sizeof(record));
+        name_fields.push_back(at + offsetof(TrackRecord, name));
+    }
+
+    header.text      = writer.finish_text(std::move(name_fields));
+    header.file_size = writer.out.size();
+    std::memcpy(writer.out.data(), &header, sizeof(header));
+    return std::move(writer.out);
+}
+
+template<TType T>
+void dump_score_map(const Score<T>& score, const std::filesystem::path& path) {
+    write_file(path, dumps_score_map(score));
+}
+
+#define INSTANTIATE_SCORE_MAP(__COUNT, T)                                                 \
+    template struct TrackMap<T>;                                                          \
+    template class ScoreMap<T>;                                                           \
+    template vec<u8> dumps_score_map<T>(const Score<T>& score);                           \
+    template void    dump_score_map<T>(const Score<T>& score, const std::filesystem::path&);
+
+REPEAT_ON(INSTANTIATE_SCORE_MAP, Tick, Quarter, Second)
+#undef INSTANTIATE_SCORE_MAP
+
+}   // namespace symusic
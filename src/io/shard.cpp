@@ -0,0 +1,470 @@
+//
+// Shard files of many ZPP-encoded scores behind a footer index.
+//
+// Layout, all multi-byte integers little endian:
+//
+//   header   "SYMS" | u8 version | u8 time unit (0 Tick, 1 Quarter, 2 Second) | u16 reserved
+//   scores   the ZPP encoding of every score, back to back
+//   index    per score: u32 key length | key | u64 offset | u64 length | u64 note count
+//            | f64 duration
+//   trailer  u64 index offset | u64 score count | "SYMS"
+//
+// The index sits behind the scores so a writer can stream them without knowing their number,
+// and a reader finds it through the fixed-size trailer.
+//
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdio>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "fmt/format.h"
+#include "MetaMacro.h"
+#include "symusic/io/shard.h"
+#include "symusic/conversion.h"
+#include "symusic/detail/parallel.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace symusic {
+
+namespace details {
+
+namespace {
+
+constexpr std::array<u8, 4> kShardMagic{'S', 'Y', 'M', 'S'};
+constexpr u8                kShardVersion = 1;
+constexpr size_t            kHeaderSize   = 8;
+constexpr size_t            kTrailerSize  = 20;
+
+[[noreturn]] void invalid_shard(const std::string_view what) {
+    throw std::runtime_error(fmt::format("Invalid score shard: {}", what));
+}
+
+template<TType T>
+constexpr u8 unit_code() {
+    if constexpr (std::is_same_v<T, Tick>) return 0;
+    else if constexpr (std::is_same_v<T, Quarter>) return 1;
+    else return 2;
+}
+
+void put_u32(vec<u8>& out, const u32 value) {
+    for (size_t i = 0; i < 4; ++i) out.push_back(static_cast<u8>(value >> (8 * i)));
+}
+
+void put_u64(vec<u8>& out, const u64 value) {
+    for (size_t i = 0; i < 8; ++i) out.push_back(static_cast<u8>(value >> (8 * i)));
+}
+
+u64 get_u64(const u8* data) {
+    u64 value = 0;
+    for (size_t i = 0; i < 8; ++i) value |= static_cast<u64>(data[i]) << (8 * i);
+    return value;
+}
+
+u32 get_u32(const u8* data) {
+    u32 value = 0;
+    for (size_t i = 0; i < 4; ++i) value |= static_cast<u32>(data[i]) << (8 * i);
+    return value;
+}
+
+// Bounds-checked cursor over the index bytes.
+class IndexReader {
+public:
+    explicit IndexReader(const std::span<const u8> bytes) : bytes(bytes) {}
+
+    const u8* take(const size_t size) {
+        if (size > bytes.size() - pos) invalid_shard("truncated index");
+        const u8* data = bytes.data() + pos;
+        pos += size;
+        return data;
+    }
+
+    u32 u32_() { return get_u32(take(4)); }
+    u64 u64_() { return get_u64(take(8)); }
+
+    [[nodiscard]] bool done() const { return pos == bytes.size(); }
+
+private:
+    std::span<const u8> bytes;
+    size_t              pos = 0;
+};
+
+template<TType To, TType From>
+Score<To> parse_as(const std::span<const u8> bytes) {
+    auto score = Score<From>::template parse<DataFormat::ZPP>(bytes);
+    if constexpr (std::is_same_v<To, From>) return score;
+    else return convert<To>(score);
+}
+
+template<TType T>
+Score<T> parse_entry(const u8 unit, const std::span<const u8> bytes) {
+    switch (unit) {
+    case unit_code<Tick>(): return parse_as<T, Tick>(bytes);
+    case unit_code<Quarter>(): return parse_as<T, Quarter>(bytes);
+    default: return parse_as<T, Second>(bytes);
+    }
+}
+
+#ifdef _WIN32
+using native_file = HANDLE;
+const native_file kNoFile = INVALID_HANDLE_VALUE;
+
+native_file open_for_read(const std::filesystem::path& path) {
+    return CreateFileW(
+        path.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS,
+        nullptr
+    );
+}
+
+u64 file_size(const native_file file) {
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file, &size)) throw std::runtime_error("Failed to get the shard size");
+    return static_cast<u64>(size.QuadPart);
+}
+
+// Positioned reads through an OVERLAPPED offset, so concurrent readers never share a file pointer.
+void read_at(const native_file file, u8* data, size_t size, u64 offset) {
+    while (size > 0) {
+        OVERLAPPED at{};
+        at.Offset     = static_cast<DWORD>(offset);
+        at.OffsetHigh = static_cast<DWORD>(offset >> 32);
+        const auto chunk = static_cast<DWORD>(std::min<size_t>(size, 1u << 30));
+        DWORD      done  = 0;
+        if (!ReadFile(file, data, chunk, &done, &at) || done == 0) {
+            throw std::runtime_error("Failed to read the score shard");
+        }
+        data += done;
+        size -= done;
+        offset += done;
+    }
+}
+
+void close_file(const native_file file) { CloseHandle(file); }
+#else
+using native_file              = int;
+constexpr native_file kNoFile = -1;
+
+native_file open_for_read(const std::filesystem::path& path) {
+    return open(path.c_str(), O_RDONLY | O_CLOEXEC);
+}
+
+u64 file_size(const native_file file) {
+    struct stat info{};
+    if (fstat(file, &info) != 0) throw std::runtime_error("Failed to get the shard size");
+    return static_cast<u64>(info.st_size);
+}
+
+// pread does not move the file offset, so one descriptor serves every thread.
+void read_at(const native_file file, u8* data, size_t size, u64 offset) {
+    while (size > 0) {
+        const auto done = pread(file, data, size, static_cast<off_t>(offset));
+        if (done <= 0) throw std::runtime_error("Failed to read the score shard");
+        data += done;
+        size -= static_cast<size_t>(done);
+        offset += static_cast<u64>(done);
+    }
+}
+
+void close_file(const native_file file) { close(file); }
+#endif
+
+FILE* open_for_write(const std::filesystem::path& path) {
+#ifdef _WIN32
+    return _wfopen(path.c_str(), L"wb");
+#else
+    return fopen(path.c_str(), "wb");
+#endif
+}
+
+}   // namespace
+
+}   // namespace details
+
+template<TType T>
+struct ShardWriter<T>::Impl {
+    FILE*                                   file = nullptr;
+    std::filesystem::path                   path;
+    u64                                     offset = 0;
+    vec<ShardEntry>                         entries;
+    std::unordered_map<std::string, size_t> keys;
+
+    void write(const std::span<const u8> bytes) {
+        if (std::fwrite(bytes.data(), 1, bytes.size(), file) != bytes.size()) {
+            throw std::runtime_error(fmt::format("Failed to write file: {}", path.string()));
+        }
+        offset += bytes.size();
+    }
+
+    void close() {
+        if (file == nullptr) return;
+        vec<u8> index;
+        for (const auto& entry : entries) {
+            details::put_u32(index, static_cast<u32>(entry.key.size()));
+            index.insert(index.end(), entry.key.begin(), entry.key.end());
+            details::put_u64(index, entry.offset);
+            details::put_u64(index, entry.length);
+            details::put_u64(index, entry.note_count);
+            details::put_u64(index, std::bit_cast<u64>(entry.duration));
+        }
+        details::put_u64(index, offset);
+        details::put_u64(index, entries.size());
+        index.insert(index.end(), details::kShardMagic.begin(), details::kShardMagic.end());
+
+        FILE*      done    = std::exchange(file, nullptr);
+        const bool written = std::fwrite(index.data(), 1, index.size(), done) == index.size();
+        const bool closed  = std::fclose(done) == 0;
+        if (!written || !closed) {
+            throw std::runtime_error(fmt::format("Failed to write file: {}", path.string()));
+        }
+    }
+
+    ~Impl() {
+        try {
+            close();
+        } catch (...) {}
+    }
+};
+
+template<TType T>
+ShardWriter<T>::ShardWriter(const std::filesystem::path& path) : impl(std::make_unique<Impl>()) {
+    impl->path = path;
+    impl->file = details::open_for_write(path);
+    if (impl->file == nullptr) {
+        throw std::runtime_error(fmt::format("Failed to open file for writing: {}", path.string()));
+    }
+    vec<u8> header(details::kShardMagic.begin(), details::kShardMagic.end());
+    header.push_back(details::kShardVersion);
+    header.push_back(details::unit_code<T>());
+    header.resize(details::kHeaderSize, 0);
+    impl->write(header);
+}
+
+template<TType T>
+ShardWriter<T>::ShardWriter(ShardWriter&&) noexcept = default;
+
+template<TType T>
+ShardWriter<T>& ShardWriter<T>::operator=(ShardWriter&&) noexcept = default;
+
+template<TType T>
+ShardWriter<T>::~ShardWriter() = default;
+
+template<TType T>
+size_t ShardWriter<T>::add(std::string key, const Score<T>& score) {
+    if (impl->file == nullptr) throw std::runtime_error("Cannot add a score to a closed shard");
+    if (key.size() > std::numeric_limits<u32>::max()) {
+        throw std::invalid_argument("Shard keys must be shorter than 4 GiB");
+    }
+    if (impl->keys.contains(key)) {
+        throw std::invalid_argument(fmt::format("Duplicate shard key: {}", key));
+    }
+    const auto bytes = score.template dumps<DataFormat::ZPP>();
+    const u64  start = impl->offset;
+    impl->write(bytes);
+
+    const size_t index = impl->entries.size();
+    impl->keys.emplace(key, index);
+    impl->entries.push_back(ShardEntry{
+        .key        = std::move(key),
+        .offset     = start,
+        .length     = bytes.size(),
+        .note_count = score.note_num(),
+        .duration   = static_cast<f64>(score.end()),
+    });
+    return index;
+}
+
+template<TType T>
+void ShardWriter<T>::close() {
+    impl->close();
+}
+
+template<TType T>
+size_t ShardWriter<T>::size() const {
+    return impl->entries.size();
+}
+
+template<TType T>
+struct ShardReader<T>::Impl {
+    details::native_file                         file = details::kNoFile;
+    u8                                           unit = 0;
+    vec<ShardEntry>                              entries;
+    std::unordered_map<std::string_view, size_t> keys;
+
+    [[nodiscard]] vec<u8> read(const size_t index) const {
+        const auto& entry = entries.at(index);
+        vec<u8>     bytes(entry.length);
+        details::read_at(file, bytes.data(), bytes.size(), entry.offset);
+        return bytes;
+    }
+
+    ~Impl() {
+        if (file != details::kNoFile) details::close_file(file);
+    }
+};
+
+template<TType T>
+ShardReader<T>::ShardReader(const std::filesystem::path& path) : impl(std::make_unique<Impl>()) {
+    using details::invalid_shard;
+
+    impl->file = details::open_for_read(path);
+    if (impl->file == details::kNoFile) {
+        throw std::runtime_error(fmt::format("File not found file: {}", path.string()));
+    }
+    const u64 size = details::file_size(impl->file);
+    if (size < details::kHeaderSize + details::kTrailerSize) invalid_shard("file too short");
+
+    std::array<u8, details::kHeaderSize> header{};
+    details::read_at(impl->file, header.data(), header.size(), 0);
+    if (!std::equal(details::kShardMagic.begin(), details::kShardMagic.end(), header.begin())) {
+        invalid_shard("missing SYMS header");
+    }
+    if (header[4] != details::kShardVersion) {
+        throw std::runtime_error(fmt::format(
+            "Unsupported score shard version {} (this build reads version {})", header[4],
+            details::kShardVersion
+        ));
+    }
+    impl->unit = header[5];
+    if (impl->unit > details::unit_code<Second>()) invalid_shard("unknown time unit");
+
+    std::array<u8, details::kTrailerSize> trailer{};
+    details::read_at(impl->file, trailer.data(), trailer.size(), size - trailer.size());
+    if (!std::equal(details::kShardMagic.begin(), details::kShardMagic.end(), trailer.end() - 4)) {
+        invalid_shard("missing index trailer, the shard may not have been closed");
+    }
+    const u64 index_offset = details::get_u64(trailer.data());
+    const u64 count        = details::get_u64(trailer.data() + 8);
+    const u64 index_end    = size - trailer.size();
+    if (index_offset < details::kHeaderSize || index_offset > index_end) {
+        invalid_shard("index offset out of range");
+    }
+
+    vec<u8> index(index_end - index_offset);
+    details::read_at(impl->file, index.data(), index.size(), index_offset);
+    details::IndexReader in(index);
+    // every entry takes at least 36 bytes, which bounds the reservation for a damaged count
+    if (count > index.size() / 36) invalid_shard("score count out of range");
+    impl->entries.reserve(count);
+    for (u64 i = 0; i < count; ++i) {
+        ShardEntry entry;
+        const u32  key_size = in.u32_();
+        const u8*  key      = in.take(key_size);
+        entry.key.assign(reinterpret_cast<const char*>(key), key_size);
+        entry.offset     = in.u64_();
+        entry.length     = in.u64_();
+        entry.note_count = in.u64_();
+        entry.duration   = std::bit_cast<f64>(in.u64_());
+        if (entry.offset < details::kHeaderSize || entry.length > index_offset - entry.offset
+            || entry.offset > index_offset) {
+            invalid_shard("score out of range");
+        }
+        impl->entries.push_back(std::move(entry));
+    }
+    if (!in.done()) invalid_shard("trailing bytes after the index");
+
+    // the entries are not resized any more, so the views of their keys stay valid
+    for (size_t i = 0; i < impl->entries.size(); ++i) {
+        if (!impl->keys.emplace(impl->entries[i].key, i).second) invalid_shard("duplicate key");
+    }
+}
+
+template<TType T>
+ShardReader<T>::ShardReader(ShardReader&&) noexcept = default;
+
+template<TType T>
+ShardReader<T>& ShardReader<T>::operator=(ShardReader&&) noexcept = default;
+
+template<TType T>
+ShardReader<T>::~ShardReader() = default;
+
+template<TType T>
+size_t ShardReader<T>::size() const {
+    return impl->entries.size();
+}
+
+template<TType T>
+const vec<ShardEntry>& ShardReader<T>::entries() const {
+    return impl->entries;
+}
+
+template<TType T>
+const ShardEntry& ShardReader<T>::entry(const size_t index) const {
+    if (index >= impl->entries.size()) throw std::out_of_range("Shard index out of range");
+    return impl->entries[index];
+}
+
+template<TType T>
+std::optional<size_t> ShardReader<T>::find(const std::string_view key) const {
+    if (const auto it = impl->keys.find(key); it != impl->keys.end()) return it->second;
+    return std::nullopt;
+}
+
+template<TType T>
+vec<u8> ShardReader<T>::read_bytes(const size_t index) const {
+    if (index >= impl->entries.size()) throw std::out_of_range("Shard index out of range");
+    return impl->read(index);
+}
+
+template<TType T>
+Score<T> ShardReader<T>::get(const size_t index) const {
+    return details::parse_entry<T>(impl->unit, read_bytes(index));
+}
+
+template<TType T>
+Score<T> ShardReader<T>::get(const std::string_view key) const {
+    const auto index = find(key);
+    if (!index) throw std::out_of_range(fmt::format("Unknown shard key: {}", key));
+    return get(*index);
+}
+
+template<TType T>
+vec<LoadResult<Score<T>>> ShardReader<T>::get_many(
+    const std::span<const size_t> indices, const size_t num_threads
+) const {
+    vec<LoadResult<Score<T>>> results(indices.size());
+    // Every item writes to its own slot, so no synchronisation is needed beyond the join.
+    const auto load = [&](const size_t i) {
+        auto& result = results[i];
+        try {
+            result.value.emplace(get(indices[i]));
+        } catch (const std::exception& e) {
+            result.error = e.what();
+        } catch (...) {
+            result.error = fmt::format("Unknown error while loading shard index {}", indices[i]);
+        }
+    };
+    details::parallel_for(indices.size(), num_threads, load);
+    return results;
+}
+
+#define INSTANTIATE_SHARD(__COUNT, T) \
+    template class ShardWriter<T>;    \
+    template class ShardReader<T>;
+
+REPEAT_ON(INSTANTIATE_SHARD, Tick, Quarter, Second)
+
+#undef INSTANTIATE_SHARD
+
+}   // namespace symusic
@@ -0,0 +1,313 @@
+//
+// Non-throwing MIDI parsing. The regular decoder runs first; only when it rejects a file does a
+// diagnostics pass walk the raw bytes to find out where and why.
+//
+
+#include <algorithm>
+#include <exception>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+#ifdef _MSC_VER
+#pragma warning(disable : 4996)
+#endif
+
+#include "fmt/core.h"
+#include "minimidi/MiniMidi.hpp"
+#include "MetaMacro.h"
+
+#include "symusic/io/common.h"
+#include "symusic/io/midi.h"
+#include "symusic/io/try_parse.h"
+
+namespace symusic {
+
+const char* to_string(const ParseErrorCode code) {
+    switch (code) {
+    case ParseErrorCode::None: return "none";
+    case ParseErrorCode::IoError: return "io_error";
+    case ParseErrorCode::InvalidHeader: return "invalid_header";
+    case ParseErrorCode::TruncatedChunk: return "truncated_chunk";
+    case ParseErrorCode::InvalidMessage: return "invalid_message";
+    case ParseErrorCode::InvalidDataByte: return "invalid_data_byte";
+    case ParseErrorCode::Other: return "other";
+    }
+    return "unknown";
+}
+
+namespace details {
+
+namespace {
+
+/**
+ * The first error of a rejected file. When it lies inside an MTrk chunk, the file truncated to
+ * ``valid_end`` with the chunk count and the failing chunk length patched still decodes.
+ */
+struct Diagnosis {
+    ParseError error;
+    bool       has_prefix  = false;
+    size_t     chunk_begin = 0;   // offset of the failing chunk header
+    size_t     num_chunks  = 0;   // chunks up to and including the failing one
+    size_t     valid_end   = 0;   // start of the first message that does not decode
+};
+
+size_t read_be(const std::span<const u8> bytes, const size_t offset, const size_t num) {
+    size_t value = 0;
+    for (size_t i = 0; i < num; ++i) value = value << 8 | bytes[offset + i];
+    return value;
+}
+
+void write_be(vec<u8>& bytes, const size_t offset, const size_t num, size_t value) {
+    for (size_t i = num; i-- > 0;) {
+        bytes[offset + i] = static_cast<u8>(value & 0xFF);
+        value >>= 8;
+    }
+}
+
+enum class Walk : u8 { Complete, CutOff, Invalid };
+
+/**
+ * Walk the messages of one MTrk chunk with the validation rules of parse_track: data bytes are
+ * only checked for the event classes that ``options`` decodes, and not at all when sanitizing.
+ * Fills ``error`` on the first problem; ``valid_end`` is then the start of the offending message,
+ * or ``end`` if the chunk is fine. ``CutOff`` means that the last message runs past ``end``.
+ */
+Walk walk_chunk(
+    const std::span<const u8> bytes,
+    const size_t              begin,
+    const size_t              end,
+    const i32                 track,
+    const ParseOptions&       options,
+    ParseError&               error,
+    size_t&                   valid_end
+) {
+    const auto fail = [&](const ParseErrorCode code, const size_t offset, std::string message) {
+        error = ParseError{code, offset, track, std::move(message)};
+        return Walk::Invalid;
+    };
+    const auto cut_off = [&] {
+        error = ParseError{
+            ParseErrorCode::InvalidMessage,
+            valid_end,
+            track,
+            "message cut off by the end of its chunk",
+        };
+        return Walk::CutOff;
+    };
+    const auto check = [&](const char* field, const size_t offset) {
+        if (options.sanitize_data || bytes[offset] <= 0x7F) return true;
+        fail(
+            ParseErrorCode::InvalidDataByte,
+            offset,
+            "Get " + std::string(field) + "=" + std::to_string(bytes[offset])
+        );
+        return false;
+    };
+    // variable-length quantity of at most 4 bytes, starting at ``pos``
+    const auto read_vlq = [&](size_t& pos, size_t& value) {
+        value = 0;
+        for (size_t i = 0; i < 4; ++i) {
+            if (pos >= end) return false;
+            const u8 byte = bytes[pos++];
+            value         = value << 7 | (byte & 0x7F);
+            if (!(byte & 0x80)) return true;
+        }
+        return false;
+    };
+
+    u8     running = 0;
+    size_t pos     = begin;
+    while (pos < end) {
+        valid_end = pos;
+        size_t delta;
+        if (!read_vlq(pos, delta)) {
+            if (pos >= end) return cut_off();
+            return fail(ParseErrorCode::InvalidMessage, valid_end, "invalid delta time");
+        }
+        if (pos >= end) return cut_off();
+
+        u8 status = bytes[pos];
+        if (status >= 0x80) {
+            ++pos;
+        } else if (running != 0) {
+            status = running;
+        } else {
+            return fail(ParseErrorCode::InvalidMessage, pos, "data byte without running status");
+        }
+
+        if (status == 0xFF || status == 0xF0 || status == 0xF7) {
+            if (status == 0xFF && pos++ >= end) return cut_off();
+            size_t length;
+            if (!read_vlq(pos, length) || length > end - pos) return cut_off();
+            pos += length;
+            continue;
+        }
+        if (status == 0xF4 || status == 0xF5 || status == 0xF9 || status == 0xFD) {
+            return fail(
+                ParseErrorCode::InvalidMessage,
+                pos - 1,
+                fmt::format("Unknown or unsupported status byte: {:#04x}", status)
+            );
+        }
+        if (status >= 0xF0) {
+            // system common and real-time messages carry at most two data bytes
+            pos += status == 0xF2 ? 2 : (status == 0xF1 || status == 0xF3) ? 1 : 0;
+            if (pos > end) return cut_off();
+            continue;
+        }
+
+        running            = status;
+        const u8     type  = status & 0xF0;
+        const size_t width = (type == 0xC0 || type == 0xD0) ? 1 : 2;
+        if (width > end - pos) return cut_off();
+        bool valid = true;
+        switch (type) {
+        case 0x80:
+        case 0x90:
+            if (options.keep_notes) valid = check("pitch", pos) && check("velocity", pos + 1);
+            break;
+        case 0xB0:
+            if (options.keep_controls || (bytes[pos] == 64 && options.keep_pedals)) {
+                valid = check("control_number", pos) && check("control_value", pos + 1);
+            }
+            break;
+        case 0xC0: valid = check("program", pos); break;
+        case 0xE0:
+            if (options.keep_pitch_bends) {
+                valid = check("pitch_bend", pos) && check("pitch_bend", pos + 1);
+            }
+            break;
+        default: break;
+        }
+        if (!valid) return Walk::Invalid;
+        pos += width;
+    }
+    valid_end = end;
+    return Walk::Complete;
+}
+
+Diagnosis diagnose(const std::span<const u8> bytes, const ParseOptions& options) {
+    Diagnosis diagnosis;
+    auto&     error = diagnosis.error;
+
+    const size_t size = bytes.size();
+    if (size < 14 || !std::equal(bytes.begin(), bytes.begin() + 4, "MThd")) {
+        error = {ParseErrorCode::InvalidHeader, 0, -1, "missing MThd header"};
+        return diagnosis;
+    }
+    const size_t header_length = read_be(bytes, 4, 4);
+    if (header_length < 6) {
+        error = {ParseErrorCode::InvalidHeader, 4, -1, "MThd chunk shorter than 6 bytes"};
+        return diagnosis;
+    }
+
+    const size_t num_chunks = read_be(bytes, 10, 2);
+    size_t       pos        = 8 + header_length;
+    i32          track      = 0;
+    for (size_t i = 0; i < num_chunks && pos + 8 <= size; ++i) {
+        const size_t length = read_be(bytes, pos + 4, 4);
+        if (!std::equal(bytes.begin() + pos, bytes.begin() + pos + 4, "MTrk")) {
+            if (length > size - pos - 8) {
+                // usually garbage where a chunk header should be; keep the chunks before it
+                error = {ParseErrorCode::TruncatedChunk, pos, -1, "chunk exceeds the data"};
+                diagnosis.has_prefix  = true;
+                diagnosis.chunk_begin = pos;
+                diagnosis.num_chunks  = i;
+                diagnosis.valid_end   = pos;
+                return diagnosis;
+            }
+            pos += 8 + length;
+            continue;
+        }
+        const size_t begin     = pos + 8;
+        const bool   truncated = length > size - begin;
+        const size_t end       = truncated ? size : begin + length;
+
+        diagnosis.chunk_begin = pos;
+        diagnosis.num_chunks  = i + 1;
+        diagnosis.has_prefix  = true;
+        const auto walk = walk_chunk(bytes, begin, end, track, options, error, diagnosis.valid_end);
+        if (walk == Walk::Invalid || (walk == Walk::CutOff && !truncated)) return diagnosis;
+        if (truncated) {
+            error = {ParseErrorCode::TruncatedChunk, pos, track, "MTrk chunk exceeds the data"};
+            return diagnosis;
+        }
+        pos = end;
+        ++track;
+    }
+    diagnosis.has_prefix = false;
+    return diagnosis;
+}
+
+/// The file cut right before the failing message, with its header and chunk length patched.
+vec<u8> valid_prefix(const std::span<const u8> bytes, const Diagnosis& diagnosis) {
+    vec<u8> prefix(bytes.begin(), bytes.begin() + diagnosis.valid_end);
+    write_be(prefix, 10, 2, diagnosis.num_chunks);
+    if (diagnosis.valid_end >= diagnosis.chunk_begin + 8) {
+        write_be(
+            prefix, diagnosis.chunk_begin + 4, 4, diagnosis.valid_end - diagnosis.chunk_begin - 8
+        );
+    }
+    return prefix;
+}
+
+}   // namespace
+
+}   // namespace details
+
+template<TType T>
+ParseResult<Score<T>> try_parse_midi(
+    const std::span<const u8> bytes, const ParseOptions& options, const bool want_partial
+) {
+    ParseResult<Score<T>> result;
+    std::string           reason;
+    try {
+        result.value = parse<DataFormat::MIDI, Score<T>>(bytes, options);
+        return result;
+    } catch (const std::exception& e) { reason = e.what(); }
+
+    const auto diagnosis = details::diagnose(bytes, options);
+    result.error         = diagnosis.error;
+    if (result.error.code == ParseErrorCode::None) {
+        result.error = ParseError{ParseErrorCode::Other, 0, -1, std::move(reason)};
+    }
+    if (want_partial && diagnosis.has_prefix) {
+        try {
+            result.partial = parse<DataFormat::MIDI, Score<T>>(
+                details::valid_prefix(bytes, diagnosis), options
+            );
+        } catch (const std::exception&) {
+            // the decoder disagrees with the diagnostics pass, so there is no partial score
+        }
+    }
+    return result;
+}
+
+template<TType T>
+ParseResult<Score<T>> try_parse_midi(
+    const std::filesystem::path& path, const ParseOptions& options, const bool want_partial
+) {
+    std::optional<MappedFile> file;
+    try {
+        file.emplace(path);
+    } catch (const std::exception& e) {
+        ParseResult<Score<T>> result;
+        result.error = ParseError{ParseErrorCode::IoError, 0, -1, e.what()};
+        return result;
+    }
+    return try_parse_midi<T>(file->bytes(), options, want_partial);
+}
+
+#define INSTANTIATE_TRY_PARSE(__COUNT, T)                                                      \
+    template ParseResult<Score<T>> try_parse_midi<T>(                                          \
+        std::span<const u8>, const ParseOptions&, bool                                         \
+    );                                                                                         \
+    template ParseResult<Score<T>> try_parse_midi<T>(                                          \
+        const std::filesystem::path&, const ParseOptions&, bool                                \
+    );
+
+REPEAT_ON(INSTANTIATE_TRY_PARSE, Tick, Quarter, Second)
+#undef INSTANTIATE_TRY_PARSE
+
+}   // namespace symusic
@@ -1,7 +1,11 @@
 //
 // Created by lyk on 23-12-25.
 //
+#include <algorithm>
+#include <cstring>
+#include <limits>
 #include <span>
+#include <stdexcept>
 
 #include "zpp_bits.h"
 #include "MetaMacro.h"
@@ -132,17 +136,170 @@ REPEAT_ON(
 
 #undef INSTANTIATE_ZPP_INNER
 
+namespace details {
+
+/*
+ *  Score and Track are written and read in the layout zpp_bits gives ScoreNative and
+ *  TrackNative (u32 size prefixes, events as their raw struct bytes), but straight from and into
+ *  the pyvecs, without the deep copy of to_native / to_shared in between. Dumping first measures
+ *  the output, so the buffer is allocated once and every event is a single fixed-size memcpy.
+ */
+
+struct ByteCounter {
+    size_t size = 0;
+
+    void put(const void*, const size_t n) { size += n; }
+
+    template<typename Event>
+    void put_events(const pyvec<Event>& events) {
+        size += events.size() * sizeof(Event);
+    }
+};
+
+struct ByteWriter {
+    u8* cursor;
+
+    void put(const void* data, const size_t n) {
+        std::memcpy(cursor, data, n);
+        cursor += n;
+    }
+
+    template<typename Event>
+    void put_events(const pyvec<Event>& events) {
+        for (const Event& event : events) {
+            std::memcpy(cursor, &event, sizeof(Event));
+            cursor += sizeof(Event);
+        }
+    }
+};
+
+template<typename Sink>
+void put_size(Sink& sink, const size_t size) {
+    if (size > std::numeric_limits<u32>::max()) {
+        throw std::runtime_error("ZPP serialization supports at most 2^32 - 1 items per list");
+    }
+    const auto n = static_cast<u32>(size);
+    sink.put(&n, sizeof(n));
+}
+
+template<typename Sink>
+void put_string(Sink& sink, const std::string& text) {
+    put_size(sink, text.size());
+    sink.put(text.data(), text.size());
+}
+
+template<typename Sink, typename Event>
+void put_events(Sink& sink, const pyvec<Event>& events) {
+    put_size(sink, events.size());
+    sink.put_events(events);
+}
+
+template<typename Sink, TType T>
+void put_texts(Sink& sink, const pyvec<TextMeta<T>>& texts) {
+    put_size(sink, texts.size());
+    for (const auto& text : texts) {
+        sink.put(&text.time, sizeof(text.time));
+        put_string(sink, text.text);
+    }
+}
+
+template<typename Sink, TType T>
+void put_track(Sink& sink, const Track<T>& track) {
+    put_string(sink, track.name);
+    sink.put(&track.program, sizeof(track.program));
+    sink.put(&track.is_drum, sizeof(track.is_drum));
+    put_events(sink, *track.notes);
+    put_events(sink, *track.controls);
+    put_events(sink, *track.pitch_bends);
+    put_events(sink, *track.pedals);
+    put_texts(sink, *track.lyrics);
+}
+
+template<typename Sink, TType T>
+void put_score(Sink& sink, const Score<T>& score) {
+    sink.put(&score.ticks_per_quarter, sizeof(score.ticks_per_quarter));
+    put_size(sink, score.tracks->size());
+    for (const auto& track : *score.tracks) { put_track(sink, *track); }
+    put_events(sink, *score.time_signatures);
+    put_events(sink, *score.key_signatures);
+    put_events(sink, *score.tempos);
+    put_texts(sink, *score.markers);
+}
+
+template<typename Data>
+vec<u8> dumps_direct(const Data& data) {
+    constexpr bool is_score = std::is_same_v<Data, Score<typename Data::ttype>>;
+    ByteCounter    counter;
+    if constexpr (is_score) put_score(counter, data);
+    else put_track(counter, data);
+
+    vec<u8>    buffer(counter.size);
+    ByteWriter writer{buffer.data()};
+    if constexpr (is_score) put_score(writer, data);
+    else put_track(writer, data);
+    return buffer;
+}
+
+// zpp_bits still reads every list, each one straight into the buffer its pyvec takes over.
+template<typename Event>
+shared<pyvec<Event>> take_events(auto& in) {
+    vec<Event> events;
+    in(events).or_throw();
+    return std::make_shared<pyvec<Event>>(std::move(events));
+}
+
+template<TType T>
+Track<T> take_track(auto& in) {
+    Track<T> track;
+    in(track.name, track.program, track.is_drum).or_throw();
+    track.notes       = take_events<Note<T>>(in);
+    track.controls    = take_events<ControlChange<T>>(in);
+    track.pitch_bends = take_events<PitchBend<T>>(in);
+    track.pedals      = take_events<Pedal<T>>(in);
+    track.lyrics      = take_events<TextMeta<T>>(in);
+    return track;
+}
+
+template<TType T>
+Score<T> take_score(auto& in, const size_t max_tracks) {
+    Score<T> score;
+    u32      num_tracks = 0;
+    in(score.ticks_per_quarter, num_tracks).or_throw();
+    // every track takes more than one byte, which bounds the reservation for damaged input
+    score.tracks->reserve(std::min<size_t>(num_tracks, max_tracks));
+    for (u32 i = 0; i < num_tracks; ++i) {
+        score.tracks->push_back(std::make_shared<Track<T>>(take_track<T>(in)));
+    }
+    score.time_signatures = take_events<TimeSignature<T>>(in);
+    score.key_signatures  = take_events<KeySignature<T>>(in);
+    score.tempos          = take_events<Tempo<T>>(in);
+    score.markers         = take_events<TextMeta<T>>(in);
+    return score;
+}
+
+template<typename Data>
+Data parse_direct(const std::span<const u8> buffer) {
+    auto in = zpp::bits::in(buffer);
+    if constexpr (std::is_same_v<Data, Score<typename Data::ttype>>) {
+        return take_score<typename Data::ttype>(in, buffer.size());
+    } else {
+        return take_track<typename Data::ttype>(in);
+    }
+}
+
+}   // namespace details
+
 // for Score and Track
 #define INSTANTIATE_ZPP_INNER(NAME, T)                                                 \
     template<>                                                                         \
     template<>                                                                         \
     vec<u8> NAME<T>::dumps<DataFormat::ZPP>() const {                                  \
-        return details::serailize_zpp(to_native(*this));                               \
+        return details::dumps_direct(*this);                                           \
     }                                                                                  \
     template<>                                                                         \
     template<>                                                                         \
     NAME<T> NAME<T>::parse<DataFormat::ZPP>(std::span<const u8> bytes) {               \
-        return to_shared(std::move(details::deserailize_zpp<NAME##Native<T>>(bytes))); \
+        return details::parse_direct<NAME<T>>(bytes);                                 \
     }                                                                                  \
     template<>                                                                         \
     vec<u8> dumps<DataFormat::ZPP>(const NAME<T>& data) {                              \
@@ -0,0 +1,125 @@
+#pragma once
+#ifndef SYMUSIC_TEST_COLUMNAR_HPP
+#define SYMUSIC_TEST_COLUMNAR_HPP
+
+#include <filesystem>
+#include <stdexcept>
+#include <vector>
+#include "symusic.h"
+#include "catch2/catch_test_macros.hpp"
+using namespace symusic;
+namespace fs = std::filesystem;
+
+/**
+ * Test suite for the columnar cache format: exact round trips in every time unit, decoding into a
+ * different time unit, and rejection of damaged input.
+ */
+TEST_CASE("Test Columnar Serialization", "[symusic][io][columnar]") {
+    std::vector<Score<Tick>> fixtures;
+    for (const auto* dir : {"Multitrack_MIDIs", "One_track_MIDIs"}) {
+        for (const auto& entry : fs::directory_iterator(fs::path("testcases") / dir)) {
+            fixtures.push_back(Score<Tick>::parse<DataFormat::MIDI>(read_file(entry.path())));
+        }
+    }
+    REQUIRE(!fixtures.empty());
+
+    SECTION("Fixtures Round Trip In Every Unit") {
+        size_t columnar_size = 0;
+        size_t zpp_size      = 0;
+        for (const auto& score : fixtures) {
+            const auto bytes = score.dumps<DataFormat::COLUMNAR>();
+            REQUIRE(Score<Tick>::parse<DataFormat::COLUMNAR>(bytes) == score);
+            columnar_size += bytes.size();
+            zpp_size += score.dumps<DataFormat::ZPP>().size();
+
+            const auto quarter = convert<Quarter>(score);
+            REQUIRE(
+                Score<Quarter>::parse<DataFormat::COLUMNAR>(quarter.dumps<DataFormat::COLUMNAR>())
+                == quarter
+            );
+            const auto second = convert<Second>(score);
+            REQUIRE(
+                Score<Second>::parse<DataFormat::COLUMNAR>(second.dumps<DataFormat::COLUMNAR>())
+                == second
+            );
+        }
+        // Delta coding and bit packing should beat the padded struct arrays of ZPP by far
+        REQUIRE(columnar_size * 3 < zpp_size);
+    }
+
+    SECTION("Decoding Into Another Unit Converts") {
+        const auto& score = fixtures.front();
+        const auto  bytes = score.dumps<DataFormat::COLUMNAR>();
+        REQUIRE(Score<Quarter>::parse<DataFormat::COLUMNAR>(bytes) == convert<Quarter>(score));
+        REQUIRE(parse<DataFormat::COLUMNAR, Score<Second>>(bytes) == convert<Second>(score));
+    }
+
+    SECTION("Unsorted, Negative And Extreme Values") {
+        Score<Tick> score(960);
+        score.tempos->push_back(Tempo<Tick>(0, 500000));
+        score.key_signatures->push_back(KeySignature<Tick>(10, -7, 1));
+        score.markers->push_back(TextMeta<Tick>(5, "Ünïcödé marker"));
+        score.markers->push_back(TextMeta<Tick>(2, ""));
+
+        auto track = std::make_shared<Track<Tick>>("Lead", 81, false);
+        for (i32 i = 0; i < 1000; ++i) {
+            // Non-monotone times, a few far apart, so blocks of different widths are produced
+            const i32 time = (i % 7) * 100 - 300 + (i == 500 ? 2'000'000'000 : 0);
+            track->notes->push_back(Note<Tick>(
+                time, i % 3 == 0 ? -5 : i, static_cast<i8>(i % 128), static_cast<i8>(127 - i % 128)
+            ));
+        }
+        track->pitch_bends->push_back(PitchBend<Tick>(0, -8192));
+        track->pitch_bends->push_back(PitchBend<Tick>(-1, 8191));
+        track->controls->push_back(ControlChange<Tick>(3, 64, 127));
+        track->pedals->push_back(Pedal<Tick>(3, 960));
+        track->lyrics->push_back(TextMeta<Tick>(3, "la"));
+        score.tracks->push_back(track);
+        score.tracks->push_back(std::make_shared<Track<Tick>>("", 0, true));
+
+        const auto bytes = score.dumps<DataFormat::COLUMNAR>();
+        REQUIRE(Score<Tick>::parse<DataFormat::COLUMNAR>(bytes) == score);
+
+        Score<Second> seconds(480);
+        seconds.tempos->push_back(Tempo<Second>(-0.5f, 400000));
+        auto drums = std::make_shared<Track<Second>>("Drums", 0, true);
+        drums->notes->push_back(Note<Second>(1.25f, 0.f, 36, 100));
+        drums->notes->push_back(Note<Second>(0.5f, -0.25f, 38, 90));
+        seconds.tracks->push_back(drums);
+        REQUIRE(
+            Score<Second>::parse<DataFormat::COLUMNAR>(seconds.dumps<DataFormat::COLUMNAR>())
+            == seconds
+        );
+    }
+
+    SECTION("Damaged Input Is Rejected") {
+        const auto bytes = fixtures.front().dumps<DataFormat::COLUMNAR>();
+        for (size_t size = 0; size < bytes.size(); size += 1 + size / 16) {
+            const auto truncated = std::span<const u8>(bytes).first(size);
+            REQUIRE_THROWS_AS(
+                Score<Tick>::parse<DataFormat::COLUMNAR>(truncated), std::runtime_error
+            );
+        }
+
+        auto trailing = bytes;
+        trailing.push_back(0);
+        REQUIRE_THROWS_AS(Score<Tick>::parse<DataFormat::COLUMNAR>(trailing), std::runtime_error);
+
+        auto bad_magic = bytes;
+        bad_magic[0]   = 'X';
+        REQUIRE_THROWS_AS(Score<Tick>::parse<DataFormat::COLUMNAR>(bad_magic), std::runtime_error);
+
+        auto newer = bytes;
+        newer[4]   = 2;
+        REQUIRE_THROWS_WITH(
+            Score<Tick>::parse<DataFormat::COLUMNAR>(newer),
+            "Unsupported columnar format version 2 (this build reads version 1)"
+        );
+
+        auto bad_unit = bytes;
+        bad_unit[5]   = 9;
+        REQUIRE_THROWS_AS(Score<Tick>::parse<DataFormat::COLUMNAR>(bad_unit), std::runtime_error);
+    }
+}
+
+#endif   // SYMUSIC_TEST_COLUMNAR_HPP
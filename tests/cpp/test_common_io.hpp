@@ -2,12 +2,15 @@
 #ifndef SYMUSIC_TEST_COMMON_IO_HPP
 #define SYMUSIC_TEST_COMMON_IO_HPP
 
+#include <algorithm>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <string>
 #include <vector>
 #include "symusic.h"
 #include "symusic/io/common.h"
+#include "symusic/detail/inflate.h"
 #include "catch2/catch_test_macros.hpp"
 using namespace symusic;
 namespace fs = std::filesystem;
@@ -99,4 +102,427 @@ TEST_CASE("Test Common File I/O Functions", "[symusic][io][common]") {
     fs::remove_all(temp_dir);
 }
 
+TEST_CASE("Test Memory-Mapped File Input", "[symusic][io][common][mmap]") {
+    const fs::path midi_path = fs::path("testcases") / "Multitrack_MIDIs" / "Aicha.mid";
+    REQUIRE(fs::exists(midi_path));
+
+    SECTION("Mapped Bytes Match the Copied Bytes") {
+        const auto expected = read_file(midi_path);
+        MappedFile file(midi_path);
+        REQUIRE(file.mapped());
+        REQUIRE(file.size() == expected.size());
+        REQUIRE(std::equal(file.bytes().begin(), file.bytes().end(), expected.begin()));
+        REQUIRE(
+            Score<Tick>::parse<DataFormat::MIDI>(file.bytes())
+            == Score<Tick>::parse<DataFormat::MIDI>(std::span<const uint8_t>(expected))
+        );
+
+        // moving keeps the view valid and empties the source
+        MappedFile moved(std::move(file));
+        REQUIRE(moved.size() == expected.size());
+        REQUIRE(std::equal(moved.bytes().begin(), moved.bytes().end(), expected.begin()));
+        REQUIRE(file.bytes().empty());
+    }
+
+    SECTION("Empty and Missing Files") {
+        const fs::path empty_path = fs::temp_directory_path() / "symusic_test_empty.bin";
+        { std::ofstream(empty_path, std::ios::binary); }
+        const MappedFile empty(empty_path);
+        REQUIRE(empty.bytes().empty());
+        REQUIRE_FALSE(empty.mapped());
+        fs::remove(empty_path);
+
+        const auto open_missing = [] { return MappedFile(fs::path("testcases") / "missing.mid"); };
+        REQUIRE_THROWS_AS(open_missing(), std::runtime_error);
+    }
+}
+
+TEST_CASE("Test Batch MIDI Loading", "[symusic][io][batch]") {
+    const fs::path fixture_dir = fs::path("testcases") / "Multitrack_MIDIs";
+    REQUIRE(fs::exists(fixture_dir));
+
+    std::vector<fs::path> paths;
+    for (const auto& entry : fs::directory_iterator(fixture_dir)) {
+        if (entry.path().extension() == ".mid") paths.push_back(entry.path());
+    }
+    std::sort(paths.begin(), paths.end());
+    REQUIRE_FALSE(paths.empty());
+    // A missing file in the middle of the batch must not abort the other items
+    const size_t missing_index = paths.size() / 2;
+    paths.insert(paths.begin() + static_cast<ptrdiff_t>(missing_index), fixture_dir / "missing.mid");
+
+    SECTION("Results Follow Input Order and Match Single-File Parsing") {
+        const auto results = parse_many<DataFormat::MIDI, Score<Tick>>(
+            std::span<const fs::path>(paths), ParseOptions{.num_threads = 4}
+        );
+        REQUIRE(results.size() == paths.size());
+        for (size_t i = 0; i < paths.size(); ++i) {
+            if (i == missing_index) {
+                REQUIRE_FALSE(results[i].ok());
+                REQUIRE_FALSE(results[i].error.empty());
+                continue;
+            }
+            REQUIRE(results[i].ok());
+            REQUIRE(results[i].error.empty());
+            const auto data     = read_file(paths[i]);
+            const auto expected = Score<Tick>::parse<DataFormat::MIDI>(std::span<const uint8_t>(data));
+            REQUIRE(*results[i].value == expected);
+        }
+    }
+
+    SECTION("Every Time Unit Is Supported") {
+        const std::span<const fs::path> span(paths);
+        const auto quarter = parse_many<DataFormat::MIDI, Score<Quarter>>(span, ParseOptions{});
+        const auto second  = parse_many<DataFormat::MIDI, Score<Second>>(span, ParseOptions{});
+        REQUIRE(quarter.size() == paths.size());
+        REQUIRE(second.size() == paths.size());
+        REQUIRE_FALSE(quarter[missing_index].ok());
+        REQUIRE(second[0].ok());
+        REQUIRE(second[0].value->note_num() == quarter[0].value->note_num());
+    }
+}
+
+TEST_CASE("Test Batch MIDI Writing", "[symusic][io][batch]") {
+    const fs::path fixture_dir = fs::path("testcases") / "Multitrack_MIDIs";
+    REQUIRE(fs::exists(fixture_dir));
+
+    std::vector<Score<Quarter>> scores;
+    for (const auto& entry : fs::directory_iterator(fixture_dir)) {
+        if (entry.path().extension() != ".mid") continue;
+        const auto data = read_file(entry.path());
+        scores.push_back(Score<Quarter>::parse<DataFormat::MIDI>(std::span<const uint8_t>(data)));
+    }
+    REQUIRE_FALSE(scores.empty());
+    std::vector<const Score<Quarter>*> items;
+    for (const auto& score : scores) items.push_back(&score);
+
+    const fs::path temp_dir = fs::temp_directory_path() / "symusic_test_dump_many";
+    fs::remove_all(temp_dir);
+    fs::create_directories(temp_dir);
+    std::vector<fs::path> paths;
+    for (size_t i = 0; i < scores.size(); ++i) {
+        paths.push_back(temp_dir / ("out_" + std::to_string(i) + ".mid"));
+    }
+    // A path in a missing directory must not abort the other items
+    const size_t missing_index = paths.size() / 2;
+    paths[missing_index]       = temp_dir / "missing" / "out.mid";
+
+    const auto bytes = dumps_many<DataFormat::MIDI, Score<Quarter>>(
+        std::span<const Score<Quarter>* const>(items), DumpOptions{.num_threads = 4}
+    );
+    const auto errors = dump_many<DataFormat::MIDI, Score<Quarter>>(
+        std::span<const Score<Quarter>* const>(items),
+        std::span<const fs::path>(paths),
+        DumpOptions{.num_threads = 4}
+    );
+    REQUIRE(bytes.size() == scores.size());
+    REQUIRE(errors.size() == scores.size());
+    for (size_t i = 0; i < scores.size(); ++i) {
+        REQUIRE(bytes[i].ok());
+        REQUIRE(*bytes[i].value == scores[i].dumps<DataFormat::MIDI>());
+        if (i == missing_index) {
+            REQUIRE_FALSE(errors[i].empty());
+            continue;
+        }
+        REQUIRE(errors[i].empty());
+        const auto written = read_file(paths[i]);
+        REQUIRE(vec<u8>(written.begin(), written.end()) == *bytes[i].value);
+    }
+
+    // An item that fails to encode reports its error without throwing away the batch
+    const auto invalid = dumps_many<DataFormat::MIDI, Score<Quarter>>(
+        std::span<const Score<Quarter>* const>(items), DumpOptions{.num_threads = 4, .format = 2}
+    );
+    REQUIRE(invalid.size() == scores.size());
+    for (const auto& result : invalid) {
+        REQUIRE_FALSE(result.ok());
+        REQUIRE_FALSE(result.error.empty());
+    }
+
+    const auto mismatched = [&] {
+        return dump_many<DataFormat::MIDI, Score<Quarter>>(
+            std::span<const Score<Quarter>* const>(items),
+            std::span<const fs::path>(paths).first(1),
+            DumpOptions{}
+        );
+    };
+    REQUIRE_THROWS_AS(mismatched(), std::invalid_argument);
+
+    fs::remove_all(temp_dir);
+}
+
+TEST_CASE("Test Read-Ahead Corpus Reader", "[symusic][io][corpus]") {
+    const fs::path fixture_dir = fs::path("testcases") / "Multitrack_MIDIs";
+    REQUIRE(fs::exists(fixture_dir));
+
+    std::vector<fs::path> paths;
+    for (const auto& entry : fs::directory_iterator(fixture_dir)) {
+        if (entry.path().extension() == ".mid") paths.push_back(entry.path());
+    }
+    std::sort(paths.begin(), paths.end());
+    REQUIRE_FALSE(paths.empty());
+    // A missing file in the middle of the corpus must not abort the other items
+    const size_t missing_index = paths.size() / 2;
+    paths.insert(paths.begin() + static_cast<ptrdiff_t>(missing_index), fixture_dir / "missing.mid");
+
+    SECTION("Items Follow Input Order and Match parse_many") {
+        const auto expected = parse_many<DataFormat::MIDI, Score<Tick>>(
+            std::span<const fs::path>(paths), ParseOptions{.num_threads = 1}
+        );
+        // a window smaller than the worker count keeps the backpressure path busy
+        CorpusReader<Tick> reader(
+            paths, CorpusOptions{.parse = {.num_threads = 4}, .io_threads = 2, .prefetch = 3}
+        );
+        REQUIRE(reader.size() == paths.size());
+        for (size_t i = 0; i < paths.size(); ++i) {
+            auto item = reader.next();
+            REQUIRE(item.has_value());
+            REQUIRE(item->index == i);
+            REQUIRE(item->path == paths[i]);
+            REQUIRE(item->result.ok() == expected[i].ok());
+            if (i == missing_index) {
+                REQUIRE_FALSE(item->result.error.empty());
+                continue;
+            }
+            REQUIRE(*item->result.value == *expected[i].value);
+        }
+        REQUIRE_FALSE(reader.next().has_value());
+        REQUIRE(reader.num_consumed() == paths.size());
+    }
+
+    SECTION("Abandoning a Corpus Stops the Pipeline") {
+        CorpusReader<Second> reader(paths, CorpusOptions{.parse = {.num_threads = 2}});
+        const auto first = reader.next();
+        REQUIRE(first.has_value());
+        REQUIRE(first->result.ok());
+        // the destructor joins the threads still waiting for the window to move
+    }
+
+    SECTION("An Empty Corpus Yields Nothing") {
+        CorpusReader<Quarter> reader({});
+        REQUIRE(reader.size() == 0);
+        REQUIRE_FALSE(reader.next().has_value());
+    }
+}
+
+TEST_CASE("Test Archive Reader", "[symusic][io][archive]") {
+    const fs::path archive_dir = fs::path("testcases") / "Archives";
+    const fs::path midi_dir    = fs::path("testcases") / "One_track_MIDIs";
+    REQUIRE(fs::exists(archive_dir));
+
+    const std::string long_dir = "midis/" + [] {
+        std::string name;
+        for (int i = 0; i < 6; ++i) name += "long_directory_name_";
+        return name;
+    }();
+    const std::vector<std::pair<std::string, fs::path>> expected{
+        {"midis/6338816_Etude No. 4.mid", midi_dir / "6338816_Etude No. 4.mid"},
+        {long_dir + "/Maestro_1.mid", midi_dir / "Maestro_1.mid"},
+    };
+
+    // the zip mixes stored and deflate members, the tar.gz needs a pax header for the long name
+    for (const auto* archive : {"midis.tar.gz", "midis.zip"}) {
+        DYNAMIC_SECTION("MIDI Members Match Their Files in " << archive) {
+            ArchiveReader<Tick> reader(
+                archive_dir / archive, ArchiveOptions{.parse = {.num_threads = 2}, .prefetch = 1}
+            );
+            for (size_t i = 0; i < expected.size(); ++i) {
+                auto item = reader.next();
+                REQUIRE(item.has_value());
+                REQUIRE(item->index == i);
+                REQUIRE(item->name == expected[i].first);
+                REQUIRE(item->result.ok());
+                const auto data = read_file(expected[i].second);
+                REQUIRE(*item->result.value == Score<Tick>::parse<DataFormat::MIDI>(data));
+            }
+            REQUIRE_FALSE(reader.next().has_value());
+            REQUIRE(reader.num_consumed() == expected.size());
+        }
+    }
+
+    SECTION("An Empty Suffix List Selects Every Member") {
+        ArchiveReader<Quarter> reader(archive_dir / "midis.zip", ArchiveOptions{.suffixes = {}});
+        std::vector<std::string> names;
+        while (auto item = reader.next()) {
+            names.push_back(item->name);
+            REQUIRE(item->result.ok() == (item->name != "README.txt"));
+        }
+        REQUIRE(names.size() == 3);
+        REQUIRE(names[1] == "README.txt");
+    }
+
+    SECTION("A Damaged Archive Throws After Its Intact Members") {
+        const auto   bytes = read_file(archive_dir / "midis.tar.gz");
+        const fs::path cut = fs::temp_directory_path() / "symusic_test_truncated.tar.gz";
+        write_file(cut, std::span<const u8>(bytes).first(bytes.size() / 2));
+        ArchiveReader<Tick> reader(cut);
+        const auto drain = [&] {
+            while (reader.next()) {}
+        };
+        REQUIRE_THROWS_AS(drain(), std::runtime_error);
+        fs::remove(cut);
+    }
+
+    SECTION("Inflating Stops at the Declared Size") {
+        // a final stored block holding five bytes
+        const std::vector<u8> stored{0x01, 0x05, 0x00, 0xFA, 0xFF, 1, 2, 3, 4, 5};
+        REQUIRE(details::inflate(stored, 5) == vec<u8>{1, 2, 3, 4, 5});
+        REQUIRE_THROWS_AS(details::inflate(stored, 4), std::runtime_error);
+        // an absurd declared size must not be reserved up front
+        REQUIRE(details::inflate(stored, size_t{1} << 63).size() == 5);
+    }
+
+    REQUIRE_THROWS_AS(ArchiveReader<Tick>(archive_dir / "missing.zip"), std::runtime_error);
+}
+
+TEST_CASE("Test Memory-Mapped Score Map", "[symusic][io][score_map]") {
+    const fs::path temp_dir = fs::temp_directory_path() / "symusic_test_score_map";
+    fs::create_directories(temp_dir);
+    const auto midi = read_file(fs::path("testcases") / "Multitrack_MIDIs" / "Aicha.mid");
+
+    SECTION("Views Point Into The Mapping And Copy Back Exactly") {
+        auto score = Score<Tick>::parse<DataFormat::MIDI>(midi);
+        score.markers->push_back(TextMeta<Tick>(10, "marker"));
+        (*score.tracks)[0]->lyrics->push_back(TextMeta<Tick>(20, "la"));
+        const fs::path path = temp_dir / "aicha.symm";
+        dump_score_map(score, path);
+
+        const ScoreMap<Tick> map(path);
+        REQUIRE(map.ticks_per_quarter() == score.ticks_per_quarter);
+        REQUIRE(map.num_tracks() == score.tracks->size());
+        REQUIRE(map.tempos().size() == score.tempos->size());
+        REQUIRE(map.markers().back().text == "marker");
+        for (size_t i = 0; i < map.num_tracks(); ++i) {
+            const auto& view  = map.track(i);
+            const auto& track = *(*score.tracks)[i];
+            REQUIRE(view.name == track.name);
+            REQUIRE(view.notes.size() == track.notes->size());
+            for (size_t j = 0; j < view.notes.size(); ++j) {
+                REQUIRE(view.notes[j] == (*track.notes)[j]);
+            }
+            REQUIRE(view.to_track() == track);
+        }
+        REQUIRE(map.track(0).lyrics.back().text == "la");
+        REQUIRE(map.to_score() == score);
+        REQUIRE_THROWS_AS(map.track(map.num_tracks()), std::out_of_range);
+        if (map.mapped()) {
+            const auto* begin = reinterpret_cast<const u8*>(map.track(0).notes.data());
+            REQUIRE(reinterpret_cast<uintptr_t>(begin) % 64 == 0);
+        }
+    }
+
+    SECTION("Seconds And Empty Scores") {
+        const auto     seconds = Score<Second>::parse<DataFormat::MIDI>(midi);
+        const fs::path path    = temp_dir / "seconds.symm";
+        dump_score_map(seconds, path);
+        REQUIRE(ScoreMap<Second>(path).to_score() == seconds);
+        REQUIRE_THROWS_WITH(
+            ScoreMap<Tick>(path), "Score map stores Second times but Tick was requested"
+        );
+
+        const fs::path empty = temp_dir / "empty.symm";
+        dump_score_map(Score<Quarter>(480), empty);
+        REQUIRE(ScoreMap<Quarter>(empty).to_score() == Score<Quarter>(480));
+    }
+
+    SECTION("Damaged Files Are Rejected") {
+        const auto bytes = dumps_score_map(Score<Tick>::parse<DataFormat::MIDI>(midi));
+        const fs::path path  = temp_dir / "damaged.symm";
+        const auto     check = [&](const vec<u8>& data) {
+            write_file(path, data);
+            REQUIRE_THROWS_AS(ScoreMap<Tick>(path), std::runtime_error);
+        };
+        check(vec<u8>(bytes.begin(), bytes.begin() + bytes.size() / 2));
+        auto bad_magic = bytes;
+        bad_magic[0]   = 'X';
+        check(bad_magic);
+        auto bad_version = bytes;
+        bad_version[4]   = 9;
+        check(bad_version);
+        // point the track table past the end of the file, keeping the recorded file size
+        auto bad_section = bytes;
+        const u64 far    = bytes.size();
+        std::memcpy(bad_section.data() + 32, &far, sizeof(far));
+        check(bad_section);
+    }
+
+    fs::remove_all(temp_dir);
+}
+
+TEST_CASE("Test Score Shards", "[symusic][io][shard]") {
+    const fs::path temp_dir = fs::temp_directory_path() / "symusic_test_shard";
+    fs::create_directories(temp_dir);
+    std::vector<std::pair<std::string, Score<Tick>>> scores;
+    for (const auto& entry : fs::directory_iterator(fs::path("testcases") / "One_track_MIDIs")) {
+        scores.emplace_back(
+            entry.path().filename().string(),
+            Score<Tick>::parse<DataFormat::MIDI>(read_file(entry.path()))
+        );
+    }
+    REQUIRE(!scores.empty());
+    const fs::path path = temp_dir / "scores.syms";
+    {
+        ShardWriter<Tick> writer(path);
+        for (size_t i = 0; i < scores.size(); ++i) {
+            REQUIRE(writer.add(scores[i].first, scores[i].second) == i);
+        }
+        REQUIRE_THROWS_AS(writer.add(scores[0].first, scores[0].second), std::invalid_argument);
+        writer.close();
+        REQUIRE_THROWS_AS(writer.add("late", scores[0].second), std::runtime_error);
+    }
+
+    SECTION("Random Access By Index And Key") {
+        const ShardReader<Tick> reader(path);
+        REQUIRE(reader.size() == scores.size());
+        for (size_t i = scores.size(); i-- > 0;) {
+            const auto& [key, score] = scores[i];
+            const auto& entry        = reader.entry(i);
+            REQUIRE(entry.key == key);
+            REQUIRE(entry.note_count == score.note_num());
+            REQUIRE(entry.duration == static_cast<f64>(score.end()));
+            REQUIRE(reader.find(key) == i);
+            REQUIRE(reader.get(i) == score);
+            REQUIRE(reader.get(std::string_view(key)) == score);
+        }
+        REQUIRE_FALSE(reader.find("missing").has_value());
+        REQUIRE_THROWS_AS(reader.get(scores.size()), std::out_of_range);
+        REQUIRE_THROWS_AS(reader.get(std::string_view("missing")), std::out_of_range);
+        REQUIRE(ShardReader<Quarter>(path).get(0) == convert<Quarter>(scores[0].second));
+    }
+
+    SECTION("Parallel Loading Keeps Input Order") {
+        const ShardReader<Tick> reader(path);
+        std::vector<size_t>     indices;
+        for (size_t i = scores.size(); i-- > 0;) indices.push_back(i);
+        indices.push_back(scores.size());
+        const auto results = reader.get_many(indices, 4);
+        REQUIRE(results.size() == indices.size());
+        for (size_t i = 0; i < scores.size(); ++i) {
+            REQUIRE(results[i].ok());
+            REQUIRE(*results[i].value == scores[indices[i]].second);
+        }
+        REQUIRE_FALSE(results.back().ok());
+    }
+
+    SECTION("Damaged Shards Are Rejected") {
+        const auto     bytes   = read_file(path);
+        const fs::path damaged = temp_dir / "damaged.syms";
+        const auto     check   = [&](const vec<u8>& data) {
+            write_file(damaged, data);
+            REQUIRE_THROWS_AS(ShardReader<Tick>(damaged), std::runtime_error);
+        };
+        // an unclosed shard has no index
+        check(vec<u8>(bytes.begin(), bytes.end() - 1));
+        check(vec<u8>(bytes.begin(), bytes.begin() + 8));
+        auto bad_magic = bytes;
+        bad_magic[0]   = 'X';
+        check(bad_magic);
+        auto bad_offset = bytes;
+        bad_offset[bytes.size() - 13] = 0x7f;
+        check(bad_offset);
+    }
+
+    fs::remove_all(temp_dir);
+}
+
 #endif // SYMUSIC_TEST_COMMON_IO_HPP
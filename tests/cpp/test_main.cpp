@@ -20,6 +20,7 @@
 #include "test_synth.hpp"
 #include "test_repr.hpp"
 #include "test_zpp.hpp"
+#include "test_columnar.hpp"
 
 // Include new detailed test files
 #include "test_score.hpp"
@@ -2,11 +2,15 @@
 #ifndef SYMUSIC_TEST_MIDI_IO_HPP
 #define SYMUSIC_TEST_MIDI_IO_HPP
 
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstdio>
 #include <filesystem>
 #include <fstream>
 #include <string>
 #include "symusic.h"
+#include "symusic/detail/inflate.h"
 #include "catch2/catch_test_macros.hpp"
 using namespace symusic;
 namespace fs = std::filesystem;
@@ -253,4 +257,1137 @@ TEST_CASE("Test Advanced MIDI File I/O", "[symusic][io][midi][advanced]") {
     fs::remove_all(temp_dir);
 }
 
+TEST_CASE("Test Parallel MIDI Track Decoding", "[symusic][io][midi][parallel]") {
+    SECTION("Parallel Parse Matches Sequential Parse on Multitrack Fixtures") {
+        const fs::path fixture_dir = fs::path("testcases") / "Multitrack_MIDIs";
+        REQUIRE(fs::exists(fixture_dir));
+
+        for (const auto& entry : fs::directory_iterator(fixture_dir)) {
+            if (entry.path().extension() != ".mid") continue;
+            const auto data = read_file(entry.path());
+            const std::span<const uint8_t> span(data);
+
+            const auto sequential = parse<DataFormat::MIDI, Score<Tick>>(span, ParseOptions{});
+            for (const size_t num_threads : {size_t{0}, size_t{2}, size_t{4}}) {
+                const auto parallel = parse<DataFormat::MIDI, Score<Tick>>(
+                    span, ParseOptions{.num_threads = num_threads}
+                );
+                REQUIRE(parallel == sequential);
+            }
+
+            const auto quarter_seq = parse<DataFormat::MIDI, Score<Quarter>>(span, ParseOptions{});
+            const auto quarter_par
+                = parse<DataFormat::MIDI, Score<Quarter>>(span, ParseOptions{.num_threads = 3});
+            REQUIRE(quarter_par == quarter_seq);
+
+            const auto second_seq = parse<DataFormat::MIDI, Score<Second>>(span, ParseOptions{});
+            const auto second_par
+                = parse<DataFormat::MIDI, Score<Second>>(span, ParseOptions{.num_threads = 3});
+            REQUIRE(second_par == second_seq);
+        }
+    }
+
+    SECTION("Parallel Parse Reports the First Failing Track") {
+        // Two MTrk chunks; the second one contains an out-of-range velocity byte.
+        const std::vector<uint8_t> midi_data = {
+            'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 1, 0, 2, 0, 96,
+            'M', 'T', 'r', 'k', 0, 0, 0, 12,
+            0x00, 0x90, 60, 64, 0x60, 0x80, 60, 0, 0x00, 0xFF, 0x2F, 0x00,
+            'M', 'T', 'r', 'k', 0, 0, 0, 12,
+            0x00, 0x90, 62, 0xFF, 0x60, 0x80, 62, 0, 0x00, 0xFF, 0x2F, 0x00,
+        };
+        const std::span<const uint8_t> span(midi_data);
+        REQUIRE_THROWS_AS(
+            (parse<DataFormat::MIDI, Score<Tick>>(span, ParseOptions{.num_threads = 2})),
+            std::runtime_error
+        );
+
+        const auto sanitized = parse<DataFormat::MIDI, Score<Tick>>(
+            span, ParseOptions{.sanitize_data = true, .num_threads = 2}
+        );
+        REQUIRE(sanitized.tracks->size() == 2);
+        REQUIRE(sanitized.tracks->at(0)->notes->at(0).pitch == 60);
+        REQUIRE(sanitized.tracks->at(1)->notes->at(0).pitch == 62);
+    }
+}
+
+TEST_CASE("Test Direct MIDI Parsing into Seconds", "[symusic][io][midi][second]") {
+    SECTION("Direct Parse Matches Converting a Tick Score") {
+        for (const auto* dir : {"One_track_MIDIs", "Multitrack_MIDIs"}) {
+            const fs::path fixture_dir = fs::path("testcases") / dir;
+            REQUIRE(fs::exists(fixture_dir));
+            for (const auto& entry : fs::directory_iterator(fixture_dir)) {
+                if (entry.path().extension() != ".mid") continue;
+                const auto data = read_file(entry.path());
+                const std::span<const uint8_t> span(data);
+
+                const auto expected = convert<Second>(Score<Tick>::parse<DataFormat::MIDI>(span));
+                REQUIRE(Score<Second>::parse<DataFormat::MIDI>(span) == expected);
+                REQUIRE(
+                    parse<DataFormat::MIDI, Score<Second>>(span, ParseOptions{.num_threads = 2})
+                    == expected
+                );
+            }
+        }
+    }
+
+    SECTION("Tempo Changes Outside the Conductor Track Are Honoured") {
+        // Track 0 holds the initial tempo, track 1 doubles the speed at tick 96 and plays a note.
+        const std::vector<uint8_t> midi_data = {
+            'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 1, 0, 2, 0, 96,
+            'M', 'T', 'r', 'k', 0, 0, 0, 11,
+            0x00, 0xFF, 0x51, 0x03, 0x07, 0xA1, 0x20, 0x00, 0xFF, 0x2F, 0x00,
+            'M', 'T', 'r', 'k', 0, 0, 0, 19,
+            0x60, 0xFF, 0x51, 0x03, 0x03, 0xD0, 0x90,
+            0x00, 0x90, 60, 64, 0x60, 0x80, 60, 0, 0x00, 0xFF, 0x2F, 0x00,
+        };
+        const std::span<const uint8_t> span(midi_data);
+        const auto seconds = Score<Second>::parse<DataFormat::MIDI>(span);
+        REQUIRE(seconds == convert<Second>(Score<Tick>::parse<DataFormat::MIDI>(span)));
+        REQUIRE(seconds.tempos->size() == 2);
+        const auto& note = seconds.tracks->at(0)->notes->at(0);
+        REQUIRE(std::abs(note.time - 0.5f) < 1e-6f);
+        REQUIRE(std::abs(note.duration - 0.25f) < 1e-6f);
+    }
+}
+
+TEST_CASE("Test Projected MIDI Parsing", "[symusic][io][midi][projection]") {
+    const fs::path fixture_dir = fs::path("testcases") / "Multitrack_MIDIs";
+    REQUIRE(fs::exists(fixture_dir));
+
+    ParseOptions notes_only{};
+    notes_only.keep_controls = notes_only.keep_pitch_bends = notes_only.keep_pedals = false;
+    notes_only.keep_lyrics = notes_only.keep_time_signatures = notes_only.keep_key_signatures
+        = notes_only.keep_markers = false;
+
+    SECTION("Notes-Only Parse Keeps Exactly the Notes") {
+        for (const auto& entry : fs::directory_iterator(fixture_dir)) {
+            if (entry.path().extension() != ".mid") continue;
+            const auto data = read_file(entry.path());
+            const std::span<const uint8_t> span(data);
+
+            const auto full      = parse<DataFormat::MIDI, Score<Tick>>(span, ParseOptions{});
+            const auto projected = parse<DataFormat::MIDI, Score<Tick>>(span, notes_only);
+
+            REQUIRE(*projected.tempos == *full.tempos);
+            REQUIRE(projected.time_signatures->empty());
+            REQUIRE(projected.key_signatures->empty());
+            REQUIRE(projected.markers->empty());
+
+            size_t i = 0;
+            for (const auto& track : *full.tracks) {
+                if (track->notes->empty()) continue;
+                REQUIRE(i < projected.tracks->size());
+                const auto& kept = projected.tracks->at(i++);
+                REQUIRE(*kept->notes == *track->notes);
+                REQUIRE(kept->program == track->program);
+                REQUIRE(kept->controls->empty());
+                REQUIRE(kept->pitch_bends->empty());
+                REQUIRE(kept->pedals->empty());
+            }
+            REQUIRE(i == projected.tracks->size());
+
+            // the tempo map is still honoured when tempos are not requested
+            ParseOptions no_tempos = notes_only;
+            no_tempos.keep_tempos  = false;
+            const auto full_second = parse<DataFormat::MIDI, Score<Second>>(span, ParseOptions{});
+            const auto second_notes = parse<DataFormat::MIDI, Score<Second>>(span, no_tempos);
+            REQUIRE(second_notes.tempos->empty());
+            REQUIRE(second_notes.tracks->size() == projected.tracks->size());
+            size_t j = 0;
+            for (const auto& track : *full_second.tracks) {
+                if (track->notes->empty()) continue;
+                REQUIRE(*second_notes.tracks->at(j++)->notes == *track->notes);
+            }
+        }
+    }
+
+    SECTION("Pedals Are Decoded Without Keeping Controls") {
+        ParseOptions pedals_only = notes_only;
+        pedals_only.keep_notes   = false;
+        pedals_only.keep_pedals  = true;
+        for (const auto& entry : fs::directory_iterator(fixture_dir)) {
+            if (entry.path().extension() != ".mid") continue;
+            const auto data = read_file(entry.path());
+            const std::span<const uint8_t> span(data);
+
+            const auto full      = parse<DataFormat::MIDI, Score<Tick>>(span, ParseOptions{});
+            const auto projected = parse<DataFormat::MIDI, Score<Tick>>(span, pedals_only);
+
+            size_t i = 0;
+            for (const auto& track : *full.tracks) {
+                if (track->pedals->empty()) continue;
+                REQUIRE(i < projected.tracks->size());
+                const auto& kept = projected.tracks->at(i++);
+                REQUIRE(*kept->pedals == *track->pedals);
+                REQUIRE(kept->notes->empty());
+                REQUIRE(kept->controls->empty());
+            }
+            REQUIRE(i == projected.tracks->size());
+        }
+    }
+
+    SECTION("Skipped Event Classes Are Not Validated") {
+        // The only note carries an out-of-range velocity, which fails a full parse.
+        const std::vector<uint8_t> midi_data = {
+            'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 0, 0, 1, 0, 96,
+            'M', 'T', 'r', 'k', 0, 0, 0, 19,
+            0x00, 0xFF, 0x51, 0x03, 0x07, 0xA1, 0x20,
+            0x00, 0x90, 60, 0xFF, 0x60, 0x80, 60, 0, 0x00, 0xFF, 0x2F, 0x00,
+        };
+        const std::span<const uint8_t> span(midi_data);
+        REQUIRE_THROWS_AS((parse<DataFormat::MIDI, Score<Tick>>(span)), std::runtime_error);
+
+        ParseOptions tempos_only = notes_only;
+        tempos_only.keep_notes   = false;
+        const auto score = parse<DataFormat::MIDI, Score<Tick>>(span, tempos_only);
+        REQUIRE(score.tracks->empty());
+        REQUIRE(score.tempos->size() == 1);
+    }
+}
+
+TEST_CASE("Test Metadata-Only MIDI Scan", "[symusic][io][midi][scan]") {
+    SECTION("Scan Agrees With a Full Parse") {
+        for (const auto* dir : {"One_track_MIDIs", "Multitrack_MIDIs"}) {
+            const fs::path fixture_dir = fs::path("testcases") / dir;
+            REQUIRE(fs::exists(fixture_dir));
+            for (const auto& entry : fs::directory_iterator(fixture_dir)) {
+                if (entry.path().extension() != ".mid") continue;
+                const auto data = read_file(entry.path());
+                const std::span<const uint8_t> span(data);
+
+                const auto info  = scan_midi(span);
+                const auto score = Score<Tick>::parse<DataFormat::MIDI>(span);
+
+                REQUIRE(info.ticks_per_quarter == score.ticks_per_quarter);
+                REQUIRE(info.num_tracks == score.tracks->size());
+                REQUIRE(info.note_num == score.note_num());
+                REQUIRE(info.end_tick == score.end());
+                REQUIRE(info.tempo_num == score.tempos->size());
+                REQUIRE(info.time_signature_num == score.time_signatures->size());
+                REQUIRE(info.key_signature_num == score.key_signatures->size());
+
+                std::array<u64, 128> per_program{};
+                u64                  drum_notes = 0;
+                for (const auto& track : *score.tracks) {
+                    if (track->is_drum) {
+                        drum_notes += track->note_num();
+                    } else {
+                        per_program[track->program] += track->note_num();
+                    }
+                }
+                REQUIRE(info.notes_per_program == per_program);
+                REQUIRE(info.drum_note_num == drum_notes);
+
+                if (!score.tempos->empty()) {
+                    f64 min_qpm = score.tempos->front()->qpm(), max_qpm = min_qpm;
+                    for (const auto& tempo : *score.tempos) {
+                        min_qpm = std::min(min_qpm, tempo->qpm());
+                        max_qpm = std::max(max_qpm, tempo->qpm());
+                    }
+                    REQUIRE(info.min_qpm == min_qpm);
+                    REQUIRE(info.max_qpm == max_qpm);
+                }
+                if (!score.time_signatures->empty()) {
+                    REQUIRE(info.numerator == score.time_signatures->front()->numerator);
+                    REQUIRE(info.denominator == score.time_signatures->front()->denominator);
+                }
+
+                const details::Tick2SecondConverter converter(score);
+                REQUIRE(info.end_second == converter.time_value(info.end_tick));
+            }
+        }
+    }
+
+    SECTION("Scan Validates Payload Bytes Like the Parser") {
+        const std::vector<uint8_t> midi_data = {
+            'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 0, 0, 1, 0, 96,
+            'M', 'T', 'r', 'k', 0, 0, 0, 12,
+            0x00, 0x99, 36, 0xFF, 0x60, 0x89, 36, 0, 0x00, 0xFF, 0x2F, 0x00,
+        };
+        const std::span<const uint8_t> span(midi_data);
+        REQUIRE_THROWS_AS(scan_midi(span), std::runtime_error);
+
+        const auto info = scan_midi(span, true);
+        REQUIRE(info.note_num == 1);
+        REQUIRE(info.has_drums());
+        REQUIRE(info.end_tick == 96);
+        REQUIRE(info.end_second == 0.5f);
+    }
+
+    SECTION("Scan Treats Text Like the Parser") {
+        // a marker and a lyric made only of invalid UTF-8 after the last note, and overlapping
+        // notes of the same pitch in the second chunk; the parser keeps such text as replacement
+        // characters, so the lyric still sets the end time
+        const std::vector<uint8_t> midi_data = {
+            'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 1, 0, 2, 0, 96,
+            'M', 'T', 'r', 'k', 0, 0, 0, 10,
+            0x83, 0x74, 0xFF, 0x06, 0x01, 0xFE, 0x00, 0xFF, 0x2F, 0x00,
+            'M', 'T', 'r', 'k', 0, 0, 0, 26,
+            0x00, 0x90, 60, 64, 0x10, 0x90, 60, 64, 0x10, 0x80, 60, 0, 0x10, 0x80, 60, 0,
+            0x85, 0x00, 0xFF, 0x05, 0x01, 0xFE, 0x00, 0xFF, 0x2F, 0x00,
+        };
+        const std::span<const uint8_t> span(midi_data);
+        const auto info  = scan_midi(span);
+        const auto score = Score<Tick>::parse<DataFormat::MIDI>(span);
+        REQUIRE(info.note_num == 2);
+        REQUIRE(info.note_num == score.note_num());
+        REQUIRE(info.num_tracks == score.tracks->size());
+        REQUIRE(info.end_tick == score.end());
+        REQUIRE(info.end_tick == 688);
+    }
+}
+
+TEST_CASE("Test Lazy MIDI Score", "[symusic][io][midi][lazy]") {
+    const fs::path fixture_dir = fs::path("testcases") / "Multitrack_MIDIs";
+    REQUIRE(fs::exists(fixture_dir));
+
+    SECTION("Chunks Are Decoded on First Access") {
+        for (const auto& entry : fs::directory_iterator(fixture_dir)) {
+            if (entry.path().extension() != ".mid") continue;
+            auto lazy = LazyScore<Tick>::from_file(entry.path());
+            const auto full = Score<Tick>::parse<DataFormat::MIDI>(read_file(entry.path()));
+
+            REQUIRE(lazy.ticks_per_quarter() == full.ticks_per_quarter);
+            REQUIRE(lazy.num_midi_tracks() > 1);
+            REQUIRE(lazy.is_decoded(0));
+            const size_t last = lazy.num_midi_tracks() - 1;
+            for (size_t i = 1; i < lazy.num_midi_tracks(); ++i) REQUIRE_FALSE(lazy.is_decoded(i));
+
+            const auto& tracks = lazy.midi_track(last);
+            REQUIRE(lazy.is_decoded(last));
+            REQUIRE(&lazy.midi_track(last) == &tracks);
+            if (last > 1) REQUIRE_FALSE(lazy.is_decoded(1));
+            for (const auto& track : tracks) {
+                REQUIRE(std::any_of(full.tracks->begin(), full.tracks->end(), [&](const auto& t) {
+                    return *t == *track;
+                }));
+            }
+            REQUIRE(lazy.to_score() == full);
+        }
+    }
+
+    SECTION("Lazy Scores Match a Full Parse in Every Time Unit") {
+        for (const auto& entry : fs::directory_iterator(fixture_dir)) {
+            if (entry.path().extension() != ".mid") continue;
+            const auto data = read_file(entry.path());
+            const std::span<const uint8_t> span(data);
+
+            const ParseOptions options{.num_threads = 2};
+            REQUIRE(
+                LazyScore<Tick>(data, options).to_score()
+                == parse<DataFormat::MIDI, Score<Tick>>(span, options)
+            );
+            REQUIRE(
+                LazyScore<Quarter>(data, options).to_score()
+                == parse<DataFormat::MIDI, Score<Quarter>>(span, options)
+            );
+            REQUIRE(
+                LazyScore<Second>(data, options).to_score()
+                == parse<DataFormat::MIDI, Score<Second>>(span, options)
+            );
+        }
+    }
+
+    SECTION("Tempo Changes Outside the Conductor Track Are Honoured") {
+        const std::vector<uint8_t> midi_data = {
+            'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 1, 0, 2, 0, 96,
+            'M', 'T', 'r', 'k', 0, 0, 0, 11,
+            0x00, 0xFF, 0x51, 0x03, 0x07, 0xA1, 0x20, 0x00, 0xFF, 0x2F, 0x00,
+            'M', 'T', 'r', 'k', 0, 0, 0, 19,
+            0x60, 0xFF, 0x51, 0x03, 0x03, 0xD0, 0x90,
+            0x00, 0x90, 60, 64, 0x60, 0x80, 60, 0, 0x00, 0xFF, 0x2F, 0x00,
+        };
+        LazyScore<Second> lazy(midi_data);
+        REQUIRE(lazy.conductor().tempos->size() == 1);
+        const auto& note = lazy.midi_track(1).at(0)->notes->at(0);
+        REQUIRE(std::abs(note.time - 0.5f) < 1e-6f);
+        REQUIRE(std::abs(note.duration - 0.25f) < 1e-6f);
+        REQUIRE(lazy.to_score() == Score<Second>::parse<DataFormat::MIDI>(midi_data));
+    }
+}
+
+TEST_CASE("Test Reusable MIDI Parser", "[symusic][io][midi][parser]") {
+    vec<vec<u8>> files;
+    for (const auto* dir : {"One_track_MIDIs", "Multitrack_MIDIs"}) {
+        const fs::path fixture_dir = fs::path("testcases") / dir;
+        REQUIRE(fs::exists(fixture_dir));
+        for (const auto& entry : fs::directory_iterator(fixture_dir)) {
+            if (entry.path().extension() == ".mid") files.push_back(read_file(entry.path()));
+        }
+    }
+
+    SECTION("Reused Parser Matches One-Shot Parsing") {
+        MidiParser parser;
+        for (const ParseOptions options :
+             {ParseOptions{}, ParseOptions{.sanitize_data = true}, ParseOptions{.num_threads = 3}}) {
+            for (const auto& data : files) {
+                const std::span<const uint8_t> span(data);
+                REQUIRE(
+                    parser.parse<Tick>(span, options)
+                    == parse<DataFormat::MIDI, Score<Tick>>(span, options)
+                );
+                REQUIRE(
+                    parser.parse<Quarter>(span, options)
+                    == parse<DataFormat::MIDI, Score<Quarter>>(span, options)
+                );
+                REQUIRE(
+                    parser.parse<Second>(span, options)
+                    == parse<DataFormat::MIDI, Score<Second>>(span, options)
+                );
+            }
+        }
+    }
+
+    SECTION("Parser Recovers After a Failed File") {
+        const std::vector<uint8_t> bad = {
+            'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 0, 0, 1, 0, 96,
+            'M', 'T', 'r', 'k', 0, 0, 0, 12,
+            0x00, 0x90, 60, 64, 0x00, 0x90, 62, 0xFF, 0x00, 0xFF, 0x2F, 0x00,
+        };
+        MidiParser parser;
+        for (const auto& data : files) {
+            REQUIRE_THROWS_AS(parser.parse<Tick>(bad), std::runtime_error);
+            const std::span<const uint8_t> span(data);
+            REQUIRE(parser.parse<Tick>(span) == Score<Tick>::parse<DataFormat::MIDI>(span));
+        }
+    }
+}
+
+template<TType T>
+Score<T> parse_streamed(
+    const vec<u8>& data, const size_t piece, const ParseOptions& options,
+    vec<shared<Track<T>>>& emitted
+) {
+    MidiStreamParser<T> parser(options, [&](const size_t index, const auto& tracks) {
+        REQUIRE(index == parser.num_decoded());
+        emitted.insert(emitted.end(), tracks.begin(), tracks.end());
+    });
+    for (size_t begin = 0; begin < data.size(); begin += piece) {
+        const size_t end = std::min(data.size(), begin + piece);
+        parser.feed(std::span<const u8>(data.data() + begin, end - begin));
+    }
+    return parser.finish();
+}
+
+TEST_CASE("Test Streamed MIDI Parsing", "[symusic][io][midi][stream]") {
+    vec<vec<u8>> files;
+    for (const auto* dir : {"One_track_MIDIs", "Multitrack_MIDIs"}) {
+        const fs::path fixture_dir = fs::path("testcases") / dir;
+        REQUIRE(fs::exists(fixture_dir));
+        for (const auto& entry : fs::directory_iterator(fixture_dir)) {
+            if (entry.path().extension() == ".mid") files.push_back(read_file(entry.path()));
+        }
+    }
+
+    SECTION("Streamed Parsing Matches Parsing the Whole Buffer") {
+        for (const ParseOptions options :
+             {ParseOptions{}, ParseOptions{.sanitize_data = true}, ParseOptions{.keep_tempos = false}}) {
+            for (const auto& data : files) {
+                const std::span<const uint8_t> span(data);
+                for (const size_t piece : {size_t{1}, size_t{37}, data.size()}) {
+                    vec<shared<Track<Tick>>> tick_tracks;
+                    const auto tick = parse_streamed<Tick>(data, piece, options, tick_tracks);
+                    REQUIRE(tick == parse<DataFormat::MIDI, Score<Tick>>(span, options));
+                    REQUIRE(tick_tracks == *tick.tracks);
+
+                    vec<shared<Track<Quarter>>> quarter_tracks;
+                    REQUIRE(
+                        parse_streamed<Quarter>(data, piece, options, quarter_tracks)
+                        == parse<DataFormat::MIDI, Score<Quarter>>(span, options)
+                    );
+                    vec<shared<Track<Second>>> second_tracks;
+                    REQUIRE(
+                        parse_streamed<Second>(data, piece, options, second_tracks)
+                        == parse<DataFormat::MIDI, Score<Second>>(span, options)
+                    );
+                }
+            }
+        }
+    }
+
+    SECTION("Pull Interface Hands Out Each Chunk Once") {
+        const auto& data = files.front();
+        MidiStreamParser<Tick> parser;
+        vec<shared<Track<Tick>>> pulled;
+        for (const auto byte : data) {
+            parser.feed(std::span<const u8>(&byte, 1));
+            const auto ready = parser.take_ready();
+            pulled.insert(pulled.end(), ready.begin(), ready.end());
+        }
+        REQUIRE(parser.take_ready().empty());
+        const auto score = parser.finish();
+        REQUIRE(pulled == *score.tracks);
+        REQUIRE_THROWS_AS(parser.feed(std::span<const u8>(data)), std::runtime_error);
+    }
+
+    SECTION("Tempo Outside the Conductor Chunk Falls Back to a Full Parse") {
+        const std::vector<uint8_t> data = {
+            'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 1, 0, 2, 0, 96,
+            'M', 'T', 'r', 'k', 0, 0, 0, 4,
+            0x00, 0xFF, 0x2F, 0x00,
+            'M', 'T', 'r', 'k', 0, 0, 0, 19,
+            0x00, 0xFF, 0x51, 0x03, 0x07, 0xA1, 0x20,
+            0x00, 0x90, 60, 64, 0x60, 0x80, 60, 0x00, 0x00, 0xFF, 0x2F, 0x00,
+        };
+        const std::span<const uint8_t> span(data);
+        vec<shared<Track<Second>>> emitted;
+        const auto score = parse_streamed<Second>(data, 5, {}, emitted);
+        REQUIRE(score == parse<DataFormat::MIDI, Score<Second>>(span));
+        REQUIRE(score.tempos->size() == 1);
+    }
+
+    SECTION("Truncated Input Is Rejected") {
+        const auto& data = files.front();
+        MidiStreamParser<Tick> parser;
+        parser.feed(std::span<const u8>(data.data(), data.size() - 1));
+        REQUIRE_THROWS_AS(parser.finish(), std::runtime_error);
+
+        // a missing last chunk, cut at the chunk boundary or inside its 8-byte header
+        const std::vector<uint8_t> two_chunks = {
+            'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 1, 0, 2, 0, 96,
+            'M', 'T', 'r', 'k', 0, 0, 0, 4,
+            0x00, 0xFF, 0x2F, 0x00,
+            'M', 'T', 'r', 'k', 0, 0, 0, 4,
+            0x00, 0xFF, 0x2F, 0x00,
+        };
+        for (const size_t size : {size_t{26}, size_t{27}, size_t{33}}) {
+            MidiStreamParser<Second> truncated;
+            truncated.feed(std::span<const u8>(two_chunks.data(), size));
+            REQUIRE(truncated.num_decoded() == 1);
+            REQUIRE_THROWS_AS(truncated.finish(), std::runtime_error);
+        }
+
+        MidiStreamParser<Tick> not_midi;
+        const std::vector<uint8_t> garbage = {'R', 'I', 'F', 'F', 0, 0, 0, 0};
+        REQUIRE_THROWS_AS(not_midi.feed(garbage), std::runtime_error);
+    }
+}
+
+TEST_CASE("Test Non-Throwing MIDI Parsing", "[symusic][io][midi][try_parse]") {
+    const auto single_track = [](const std::vector<uint8_t>& events) {
+        std::vector<uint8_t> data = {'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 0, 0, 1, 0, 96};
+        const auto           size = static_cast<uint32_t>(events.size());
+        data.insert(data.end(), {'M', 'T', 'r', 'k'});
+        for (const int shift : {24, 16, 8, 0}) data.push_back(static_cast<uint8_t>(size >> shift));
+        data.insert(data.end(), events.begin(), events.end());
+        return data;
+    };
+
+    SECTION("Valid Files Parse Like parse") {
+        for (const auto* dir : {"One_track_MIDIs", "Multitrack_MIDIs"}) {
+            for (const auto& entry : fs::directory_iterator(fs::path("testcases") / dir)) {
+                if (entry.path().extension() != ".mid") continue;
+                const auto result = try_parse_midi<Quarter>(entry.path());
+                REQUIRE(result.ok());
+                REQUIRE(result.error.code == ParseErrorCode::None);
+                const auto data = read_file(entry.path());
+                REQUIRE(*result.value == Score<Quarter>::parse<DataFormat::MIDI>(data));
+            }
+        }
+    }
+
+    SECTION("Corrupted Files Are Diagnosed") {
+        for (const auto& entry : fs::directory_iterator(fs::path("testcases") / "MIDIs_corrupted")) {
+            const auto data   = read_file(entry.path());
+            const auto result = try_parse_midi<Tick>(std::span<const u8>(data), {}, true);
+            bool       throws = false;
+            try {
+                (void)Score<Tick>::parse<DataFormat::MIDI>(data);
+            } catch (const std::exception&) { throws = true; }
+            REQUIRE(result.ok() == !throws);
+            if (throws) {
+                REQUIRE(result.error.code != ParseErrorCode::None);
+                REQUIRE_FALSE(result.error.message.empty());
+            }
+        }
+        const auto missing = try_parse_midi<Tick>(fs::path("testcases") / "missing.mid");
+        REQUIRE(missing.error.code == ParseErrorCode::IoError);
+    }
+
+    SECTION("Invalid Data Byte Reports Offset, Track and Partial Score") {
+        const auto data = single_track({
+            0x00, 0x90, 60, 64, 0x10, 0x80, 60, 0,
+            0x00, 0x90, 200, 64, 0x10, 0x80, 62, 0, 0x00, 0xFF, 0x2F, 0x00,
+        });
+        const std::span<const u8> span(data);
+        REQUIRE_THROWS_AS(Score<Tick>::parse<DataFormat::MIDI>(span), std::runtime_error);
+
+        const auto result = try_parse_midi<Tick>(span, {}, true);
+        REQUIRE_FALSE(result.ok());
+        REQUIRE(result.error.code == ParseErrorCode::InvalidDataByte);
+        REQUIRE(result.error.offset == 22 + 10);
+        REQUIRE(result.error.track == 0);
+        REQUIRE(result.error.message == "Get pitch=200");
+        REQUIRE(result.partial.has_value());
+        REQUIRE(result.partial->note_num() == 1);
+
+        REQUIRE_FALSE(try_parse_midi<Tick>(span).partial.has_value());
+        REQUIRE(try_parse_midi<Tick>(span, ParseOptions{.sanitize_data = true}).ok());
+        REQUIRE(try_parse_midi<Tick>(span, ParseOptions{.keep_notes = false}).ok());
+    }
+
+    SECTION("Structural Errors") {
+        auto truncated = single_track({0x00, 0x90, 60, 64, 0x10, 0x80, 60, 0, 0x00, 0xFF, 0x2F, 0x00});
+        truncated.resize(truncated.size() - 4);
+        const auto cut = try_parse_midi<Tick>(std::span<const u8>(truncated), {}, true);
+        REQUIRE(cut.error.code == ParseErrorCode::TruncatedChunk);
+        REQUIRE(cut.error.offset == 14);
+        REQUIRE(cut.partial.has_value());
+        REQUIRE(cut.partial->note_num() == 1);
+
+        const auto unknown = single_track({0x00, 0xF4, 0x00, 0xFF, 0x2F, 0x00});
+        const auto status  = try_parse_midi<Second>(std::span<const u8>(unknown));
+        REQUIRE(status.error.code == ParseErrorCode::InvalidMessage);
+        REQUIRE(status.error.offset == 23);
+
+        const std::vector<uint8_t> garbage = {'R', 'I', 'F', 'F', 0, 0, 0, 4, 'W', 'A', 'V', 'E'};
+        const auto header = try_parse_midi<Tick>(std::span<const u8>(garbage), {}, true);
+        REQUIRE(header.error.code == ParseErrorCode::InvalidHeader);
+        REQUIRE(header.error.track == -1);
+        REQUIRE_FALSE(header.partial.has_value());
+    }
+}
+
+TEST_CASE("Test Inline MIDI Sanitization", "[symusic][io][midi][sanitize]") {
+    // out-of-range program, pitch, controller value and pitch bend bytes; the LSB of the second
+    // pitch bend would carry into its MSB and land in range if the bytes were combined first
+    const std::vector<uint8_t> dirty = {
+        'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 0, 0, 1, 0, 96,
+        'M', 'T', 'r', 'k', 0, 0, 0, 31,
+        0x00, 0xC0, 0xC8, 0x00, 0xB0, 7, 0xA8, 0x00, 0xE0, 0xFF, 0xFF, 0x00, 0xE0, 0x80, 0x00,
+        0x00, 0x90, 0xC8, 64, 0x60, 0x80, 0xC8, 0,
+        0x00, 0x90, 60, 0x90, 0x00, 0xFF, 0x2F, 0x00,
+    };
+    // the same file with every channel data byte clamped by hand
+    std::vector<uint8_t> clamped = dirty;
+    for (const size_t i : {24, 28, 31, 32, 35, 39, 43, 48}) {
+        clamped[i] = std::min<uint8_t>(clamped[i], 0x7F);
+    }
+    const std::span<const uint8_t> dirty_span(dirty);
+    const std::span<const uint8_t> clamped_span(clamped);
+    const ParseOptions             sanitize{.sanitize_data = true};
+
+    REQUIRE_THROWS_AS(Score<Tick>::parse<DataFormat::MIDI>(dirty_span), std::runtime_error);
+    const auto score = parse<DataFormat::MIDI, Score<Tick>>(dirty_span, sanitize);
+    REQUIRE(score == Score<Tick>::parse<DataFormat::MIDI>(clamped_span));
+    REQUIRE(score.tracks->size() == 1);
+    const auto& track = *score.tracks->front();
+    REQUIRE(track.program == 127);
+    REQUIRE(track.notes->front().pitch == 127);
+    REQUIRE(track.controls->front().value == 127);
+    REQUIRE(track.pitch_bends->front().value == 8191);
+    REQUIRE(track.pitch_bends->at(1).value == -8065);
+
+    const std::vector<uint8_t> carry = {
+        'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 0, 0, 1, 0, 96,
+        'M', 'T', 'r', 'k', 0, 0, 0, 8,
+        0x00, 0xE0, 0x80, 0x00, 0x00, 0xFF, 0x2F, 0x00,
+    };
+    const std::span<const uint8_t> carry_span(carry);
+    REQUIRE_THROWS_AS(Score<Tick>::parse<DataFormat::MIDI>(carry_span), std::runtime_error);
+    REQUIRE_THROWS_AS(scan_midi(carry_span), std::runtime_error);
+    const auto carried = try_parse_midi<Tick>(carry_span);
+    REQUIRE(carried.error.code == ParseErrorCode::InvalidDataByte);
+    REQUIRE(carried.error.offset == 24);
+
+    REQUIRE(scan_midi(dirty_span, true) == scan_midi(clamped_span));
+    REQUIRE(
+        LazyScore<Second>(vec<u8>(dirty), sanitize).to_score()
+        == parse<DataFormat::MIDI, Score<Second>>(clamped_span)
+    );
+    MidiStreamParser<Quarter> stream(sanitize);
+    stream.feed(dirty_span);
+    REQUIRE(stream.finish() == parse<DataFormat::MIDI, Score<Quarter>>(clamped_span));
+}
+
+TEST_CASE("Test Note Content Fingerprint", "[symusic][io][midi][fingerprint]") {
+    SECTION("Fingerprint Ignores Unit, Resolution and Scan Path") {
+        for (const auto* dir : {"One_track_MIDIs", "Multitrack_MIDIs"}) {
+            const fs::path fixture_dir = fs::path("testcases") / dir;
+            REQUIRE(fs::exists(fixture_dir));
+            for (const auto& entry : fs::directory_iterator(fixture_dir)) {
+                if (entry.path().extension() != ".mid") continue;
+                const auto data = read_file(entry.path());
+                const std::span<const uint8_t> span(data);
+
+                const auto score = Score<Tick>::parse<DataFormat::MIDI>(span);
+                const auto hash  = fingerprint(score);
+                REQUIRE(scan_midi(span).fingerprint == hash);
+                REQUIRE(fingerprint(Score<Quarter>::parse<DataFormat::MIDI>(span)) == hash);
+                REQUIRE(fingerprint(Score<Second>::parse<DataFormat::MIDI>(span)) == hash);
+                REQUIRE(fingerprint(resample(score, score.ticks_per_quarter * 2)) == hash);
+            }
+        }
+    }
+
+    SECTION("Fingerprint Only Depends on Notes") {
+        const std::vector<uint8_t> midi_data = {
+            'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 0, 0, 1, 0, 96,
+            'M', 'T', 'r', 'k', 0, 0, 0, 20,
+            0x00, 0x90, 60, 100, 0x60, 0x80, 60, 0,
+            0x00, 0x90, 64, 90, 0x30, 0x80, 64, 0,
+            0x00, 0xFF, 0x2F, 0x00,
+        };
+        const auto score = Score<Tick>::parse<DataFormat::MIDI>(std::span<const uint8_t>(midi_data));
+        const auto hash  = fingerprint(score);
+        REQUIRE(hash.hex().size() == 32);
+
+        auto renamed = score.deepcopy();
+        renamed.tracks->front()->name = "renamed";
+        renamed.tempos->push_back(Tempo<Tick>::from_qpm(0, 90));
+        REQUIRE(fingerprint(renamed) == hash);
+
+        auto reordered = score.deepcopy();
+        reordered.tracks->front()->notes->sort([](const auto& note) { return note.pitch; }, true);
+        REQUIRE(fingerprint(reordered) == hash);
+
+        // the same notes split over two tracks of the same program
+        auto split = Score<Tick>(score.ticks_per_quarter);
+        for (const auto& note : *score.tracks->front()->notes) {
+            auto track = std::make_shared<Track<Tick>>("part", 0, false);
+            track->notes->push_back(note);
+            split.tracks->push_back(std::move(track));
+        }
+        REQUIRE(fingerprint(split) == hash);
+
+        auto transposed = score.deepcopy();
+        transposed.tracks->front()->notes->front()->pitch += 1;
+        REQUIRE(fingerprint(transposed) != hash);
+
+        auto shifted = score.deepcopy();
+        shifted.tracks->front()->notes->back()->time += 1;
+        REQUIRE(fingerprint(shifted) != hash);
+    }
+}
+
+TEST_CASE("Test Windowed MIDI Parsing", "[symusic][io][midi][window]") {
+    // a full parse trimmed like the window, without the tracks the trim emptied
+    const auto trimmed = []<TType T>(const Score<T>& score, const ParseWindow& window) {
+        auto ans = score.trim(
+            static_cast<typename T::unit>(window.start),
+            static_cast<typename T::unit>(window.end),
+            static_cast<typename T::unit>(window.min_overlap),
+            window.start_mode,
+            window.end_mode
+        );
+        ops::filter_inplace(*ans.tracks, [](const auto& track) { return !track->empty(); });
+        return ans;
+    };
+    // tracks without notes in the window may be missing from a windowed parse, see ParseWindow
+    const auto with_notes = []<TType T>(Score<T> score) {
+        ops::filter_inplace(*score.tracks, [](const auto& track) { return !track->notes->empty(); });
+        return score;
+    };
+
+    SECTION("Window Matches a Trimmed Full Parse") {
+        for (const auto* dir : {"One_track_MIDIs", "Multitrack_MIDIs"}) {
+            const fs::path fixture_dir = fs::path("testcases") / dir;
+            REQUIRE(fs::exists(fixture_dir));
+            for (const auto& entry : fs::directory_iterator(fixture_dir)) {
+                if (entry.path().extension() != ".mid") continue;
+                const auto data = read_file(entry.path());
+                const std::span<const uint8_t> span(data);
+                const auto tpq = Score<Tick>::parse<DataFormat::MIDI>(span).ticks_per_quarter;
+
+                for (const auto* start_mode : {"remove", "truncate"}) {
+                    ParseWindow window{.start_mode = start_mode};
+                    ParseOptions options{.window = window};
+
+                    options.window->start = 2 * tpq;
+                    options.window->end   = 10 * tpq;
+                    REQUIRE(
+                        with_notes(parse<DataFormat::MIDI, Score<Tick>>(span, options))
+                        == with_notes(trimmed(
+                            Score<Tick>::parse<DataFormat::MIDI>(span), *options.window
+                        ))
+                    );
+                    options.window->start = 2;
+                    options.window->end   = 10;
+                    REQUIRE(
+                        with_notes(parse<DataFormat::MIDI, Score<Quarter>>(span, options))
+                        == with_notes(trimmed(
+                            Score<Quarter>::parse<DataFormat::MIDI>(span), *options.window
+                        ))
+                    );
+                    options.window->start = 1;
+                    options.window->end   = 5;
+                    REQUIRE(
+                        with_notes(parse<DataFormat::MIDI, Score<Second>>(span, options))
+                        == with_notes(trimmed(
+                            Score<Second>::parse<DataFormat::MIDI>(span), *options.window
+                        ))
+                    );
+                }
+            }
+        }
+    }
+
+    SECTION("Notes Crossing the Window Follow the Trim Modes") {
+        // notes at [0, 192), [96, 288) and [192, 384) with 96 ticks per quarter
+        const std::vector<uint8_t> midi_data = {
+            'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 0, 0, 1, 0, 96,
+            'M', 'T', 'r', 'k', 0, 0, 0, 28,
+            0x00, 0x90, 60, 100, 0x60, 0x90, 62, 100, 0x60, 0x80, 60, 0,
+            0x00, 0x90, 64, 100, 0x60, 0x80, 62, 0, 0x60, 0x80, 64, 0,
+            0x00, 0xFF, 0x2F, 0x00,
+        };
+        const std::span<const uint8_t> span(midi_data);
+        const auto full = Score<Tick>::parse<DataFormat::MIDI>(span);
+
+        ParseOptions options{.window = ParseWindow{.start = 96, .end = 240}};
+        auto         score = parse<DataFormat::MIDI, Score<Tick>>(span, options);
+        REQUIRE(score.note_num() == 0);
+        REQUIRE(score.tracks->empty());
+
+        options.window->start_mode = "truncate";
+        options.window->end_mode   = "truncate";
+        score                      = parse<DataFormat::MIDI, Score<Tick>>(span, options);
+        REQUIRE(score == trimmed(full, *options.window));
+        const auto& notes = *score.tracks->front()->notes;
+        REQUIRE(notes.size() == 3);
+        REQUIRE(notes[0].time == 96);
+        REQUIRE(notes[0].duration == 96);
+        REQUIRE(notes[1].duration == 144);
+        REQUIRE(notes[2].duration == 48);
+
+        options.window->start = 300;
+        options.window->end   = 200;
+        const auto parse_tick = [&] { return parse<DataFormat::MIDI, Score<Tick>>(span, options); };
+        REQUIRE_THROWS_AS(parse_tick(), std::invalid_argument);
+        options.window = ParseWindow{.end_mode = "clip"};
+        REQUIRE_THROWS_AS(parse_tick(), std::invalid_argument);
+    }
+}
+
+TEST_CASE("Test Direct MIDI Encoding", "[symusic][io][midi][writer]") {
+    SECTION("Default Output Matches the Baseline Writer") {
+        // size and crc32 of the bytes the minimidi based writer produced for every fixture
+        std::ifstream golden(fs::path("testcases") / "golden_dump_midi.tsv");
+        REQUIRE(golden.is_open());
+        size_t      checked = 0;
+        std::string path, size, crc;
+        while (std::getline(golden, path, '\t') && std::getline(golden, size, '\t')
+               && std::getline(golden, crc)) {
+            INFO(path);
+            const auto data = read_file(fs::path("testcases") / path);
+            const auto bytes
+                = Score<Tick>::parse<DataFormat::MIDI>(std::span<const uint8_t>(data))
+                      .dumps<DataFormat::MIDI>();
+            REQUIRE(bytes.size() == std::stoul(size));
+            REQUIRE(details::crc32(bytes) == std::stoul(crc, nullptr, 16));
+            ++checked;
+        }
+        REQUIRE(checked == 27);
+
+        // ties, zero-length notes, unnamed tracks and a track without events
+        Score<Tick> score(480);
+        score.time_signatures->emplace_back(0, 3, 4);
+        score.tempos->emplace_back(960, 400000);
+        score.tempos->emplace_back(0, 500000);
+        score.markers->emplace_back(480, "B");
+        auto lead = std::make_shared<Track<Tick>>("lead", 5, false);
+        lead->notes->emplace_back(0, 480, 60, 90);
+        lead->notes->emplace_back(0, 0, 62, 80);
+        lead->notes->emplace_back(240, 240, 65, 70);
+        lead->notes->emplace_back(480, 0, 64, 60);
+        lead->notes->emplace_back(480, 480, 60, 50);
+        lead->controls->emplace_back(480, 64, 127);
+        lead->controls->emplace_back(0, 7, 100);
+        lead->pitch_bends->emplace_back(480, -200);
+        lead->lyrics->emplace_back(480, "la");
+        score.tracks->push_back(lead);
+        auto drums = std::make_shared<Track<Tick>>("", 0, true);
+        drums->notes->emplace_back(0, 120, 36, 100);
+        drums->notes->emplace_back(0, 0, 42, 100);
+        score.tracks->push_back(drums);
+        score.tracks->push_back(std::make_shared<Track<Tick>>("", 33, false));
+        const vec<uint8_t> expected{
+            0x4D, 0x54, 0x68, 0x64, 0x00, 0x00, 0x00, 0x06, 0x00, 0x01, 0x00, 0x03, 0x01, 0xE0,
+            0x4D, 0x54, 0x72, 0x6B, 0x00, 0x00, 0x00, 0x67, 0x00, 0xFF, 0x58, 0x04, 0x03, 0x02,
+            0x18, 0x08, 0x00, 0xFF, 0x51, 0x03, 0x07, 0xA1, 0x20, 0x00, 0xFF, 0x03, 0x04, 0x6C,
+            0x65, 0x61, 0x64, 0x00, 0xC0, 0x05, 0x00, 0xB0, 0x07, 0x64, 0x00, 0x90, 0x3E, 0x50,
+            0x00, 0x90, 0x3C, 0x5A, 0x00, 0x80, 0x3E, 0x50, 0x81, 0x70, 0x90, 0x41, 0x46, 0x81,
+            0x70, 0xFF, 0x06, 0x01, 0x42, 0x00, 0xB0, 0x40, 0x7F, 0x00, 0xE0, 0x38, 0x3E, 0x00,
+            0xFF, 0x05, 0x02, 0x6C, 0x61, 0x00, 0x80, 0x3C, 0x5A, 0x00, 0x80, 0x41, 0x46, 0x00,
+            0x90, 0x40, 0x3C, 0x00, 0x80, 0x40, 0x3C, 0x00, 0x90, 0x3C, 0x32, 0x83, 0x60, 0xFF,
+            0x51, 0x03, 0x06, 0x1A, 0x80, 0x00, 0x80, 0x3C, 0x32, 0x00, 0xFF, 0x2F, 0x00, 0x4D,
+            0x54, 0x72, 0x6B, 0x00, 0x00, 0x00, 0x17, 0x00, 0xC9, 0x00, 0x00, 0x99, 0x2A, 0x64,
+            0x00, 0x99, 0x24, 0x64, 0x00, 0x89, 0x2A, 0x64, 0x78, 0x89, 0x24, 0x64, 0x00, 0xFF,
+            0x2F, 0x00, 0x4D, 0x54, 0x72, 0x6B, 0x00, 0x00, 0x00, 0x07, 0x00, 0xC2, 0x21, 0x00,
+            0xFF, 0x2F, 0x00
+        };
+        REQUIRE(score.dumps<DataFormat::MIDI>() == expected);
+    }
+
+    SECTION("Running Status Shrinks Output Without Changing the Score") {
+        for (const auto* dir : {"One_track_MIDIs", "Multitrack_MIDIs"}) {
+            const fs::path fixture_dir = fs::path("testcases") / dir;
+            REQUIRE(fs::exists(fixture_dir));
+            for (const auto& entry : fs::directory_iterator(fixture_dir)) {
+                if (entry.path().extension() != ".mid") continue;
+                const auto data  = read_file(entry.path());
+                const auto score
+                    = Score<Tick>::parse<DataFormat::MIDI>(std::span<const uint8_t>(data));
+
+                const auto packed
+                    = dumps<DataFormat::MIDI>(score, DumpOptions{.running_status = true});
+                const auto plain = score.dumps<DataFormat::MIDI>();
+                REQUIRE(plain == dumps<DataFormat::MIDI>(score, DumpOptions{}));
+                REQUIRE(packed.size() <= plain.size());
+                const auto from_packed = Score<Tick>::parse<DataFormat::MIDI>(packed);
+                REQUIRE(from_packed == Score<Tick>::parse<DataFormat::MIDI>(plain));
+                REQUIRE(from_packed.note_num() == score.note_num());
+            }
+        }
+    }
+
+    SECTION("Parallel Encoding Matches Sequential Encoding") {
+        const fs::path fixture_dir = fs::path("testcases") / "Multitrack_MIDIs";
+        REQUIRE(fs::exists(fixture_dir));
+        for (const auto& entry : fs::directory_iterator(fixture_dir)) {
+            if (entry.path().extension() != ".mid") continue;
+            const auto data = read_file(entry.path());
+            const auto score
+                = Score<Tick>::parse<DataFormat::MIDI>(std::span<const uint8_t>(data));
+            const auto expected = score.dumps<DataFormat::MIDI>();
+            for (const size_t num_threads : {size_t{0}, size_t{2}, size_t{4}}) {
+                REQUIRE(
+                    dumps<DataFormat::MIDI>(score, DumpOptions{.num_threads = num_threads})
+                    == expected
+                );
+            }
+        }
+    }
+
+    SECTION("Quarter and Second Scores Encode Like Their Tick Conversion") {
+        for (const auto* dir : {"One_track_MIDIs", "Multitrack_MIDIs"}) {
+            const fs::path fixture_dir = fs::path("testcases") / dir;
+            REQUIRE(fs::exists(fixture_dir));
+            for (const auto& entry : fs::directory_iterator(fixture_dir)) {
+                if (entry.path().extension() != ".mid") continue;
+                const auto data = read_file(entry.path());
+                const std::span<const uint8_t> span(data);
+
+                const auto quarter = Score<Quarter>::parse<DataFormat::MIDI>(span);
+                REQUIRE(
+                    quarter.dumps<DataFormat::MIDI>()
+                    == convert<Tick>(quarter).dumps<DataFormat::MIDI>()
+                );
+                const auto second = Score<Second>::parse<DataFormat::MIDI>(span);
+                REQUIRE(
+                    second.dumps<DataFormat::MIDI>()
+                    == convert<Tick>(second).dumps<DataFormat::MIDI>()
+                );
+            }
+        }
+
+        // unsorted events, rounding ties and notes that collapse to zero ticks
+        Score<Second> score(480);
+        score.tempos->emplace_back(1.0f, 250000);
+        score.tempos->emplace_back(0.0f, 600000);
+        auto track = std::make_shared<Track<Second>>("piano", 0, false);
+        track->notes->emplace_back(1.5f, 0.25f, 60, 90);
+        track->notes->emplace_back(0.5f, 0.0001f, 62, 90);
+        track->notes->emplace_back(0.0f, 1.0f, 64, 90);
+        track->notes->emplace_back(0.50001f, 0.5f, 65, 90);
+        track->notes->emplace_back(1.2f, -0.1f, 67, 90);
+        track->controls->emplace_back(0.7f, 7, 100);
+        track->controls->emplace_back(0.2f, 10, 64);
+        track->pitch_bends->emplace_back(0.3f, -200);
+        score.tracks->push_back(track);
+        REQUIRE(
+            score.dumps<DataFormat::MIDI>() == convert<Tick>(score).dumps<DataFormat::MIDI>()
+        );
+
+        const auto quarter = convert<Quarter>(score);
+        quarter.tracks->front()->notes->emplace_back(0.3333f, 0.0004f, 70, 90);
+        REQUIRE(
+            quarter.dumps<DataFormat::MIDI>() == convert<Tick>(quarter).dumps<DataFormat::MIDI>()
+        );
+    }
+
+    SECTION("Compact and Format 0 Output Keep the Notes") {
+        for (const auto* dir : {"One_track_MIDIs", "Multitrack_MIDIs"}) {
+            const fs::path fixture_dir = fs::path("testcases") / dir;
+            REQUIRE(fs::exists(fixture_dir));
+            for (const auto& entry : fs::directory_iterator(fixture_dir)) {
+                if (entry.path().extension() != ".mid") continue;
+                const auto data  = read_file(entry.path());
+                const auto score
+                    = Score<Tick>::parse<DataFormat::MIDI>(std::span<const uint8_t>(data));
+                const auto hash = fingerprint(score);
+
+                const auto compact
+                    = dumps<DataFormat::MIDI>(score, DumpOptions{.compact = true});
+                REQUIRE(compact.size() <= score.dumps<DataFormat::MIDI>().size());
+                const auto from_compact = Score<Tick>::parse<DataFormat::MIDI>(compact);
+                REQUIRE(from_compact.tracks->size() == score.tracks->size());
+                for (size_t i = 0; i < score.tracks->size(); ++i) {
+                    REQUIRE(*(*from_compact.tracks)[i]->notes == *(*score.tracks)[i]->notes);
+                }
+
+                // format 0 only keeps tracks apart if every track has a channel of its own
+                const auto drums = std::count_if(
+                    score.tracks->begin(), score.tracks->end(), [](const auto& t) { return t->is_drum; }
+                );
+                if (score.tracks->size() > 15 || drums > 1) continue;
+                for (const bool compact_flag : {false, true}) {
+                    const auto single = dumps<DataFormat::MIDI>(
+                        score, DumpOptions{.compact = compact_flag, .format = 0}
+                    );
+                    REQUIRE(single[9] == 0);    // format
+                    REQUIRE(single[11] == 1);   // number of tracks
+                    const auto from_single = Score<Tick>::parse<DataFormat::MIDI>(single);
+                    REQUIRE(from_single.note_num() == score.note_num());
+                    REQUIRE(fingerprint(from_single) == hash);
+                }
+            }
+        }
+    }
+
+    SECTION("Compact Output Drops Repeated Values") {
+        Score<Tick> score(96);
+        score.tempos->emplace_back(0, 500000);
+        score.tempos->emplace_back(96, 500000);
+        score.tempos->emplace_back(192, 400000);
+        auto track = std::make_shared<Track<Tick>>("", 0, false);
+        track->notes->emplace_back(0, 384, 60, 80);
+        track->controls->emplace_back(0, 7, 100);
+        track->controls->emplace_back(48, 7, 100);
+        track->controls->emplace_back(96, 10, 100);
+        track->controls->emplace_back(144, 7, 90);
+        track->pitch_bends->emplace_back(0, 0);
+        track->pitch_bends->emplace_back(96, 0);
+        score.tracks->push_back(track);
+
+        const auto parsed = Score<Tick>::parse<DataFormat::MIDI>(
+            dumps<DataFormat::MIDI>(score, DumpOptions{.compact = true})
+        );
+        REQUIRE(parsed.tempos->size() == 2);
+        const auto& controls = *parsed.tracks->front()->controls;
+        REQUIRE(controls.size() == 3);
+        REQUIRE(controls[1].number == 10);
+        REQUIRE(controls[2].value == 90);
+        REQUIRE(parsed.tracks->front()->pitch_bends->size() == 1);
+        REQUIRE(*parsed.tracks->front()->notes == *track->notes);
+
+        // data entry after a new RPN select, repeated channel mode messages and values set again
+        // after Reset All Controllers all change the playback
+        Score<Tick> actions(96);
+        auto        rpn = std::make_shared<Track<Tick>>("", 0, false);
+        rpn->notes->emplace_back(0, 96, 60, 80);
+        for (const auto& [time, number, value] : std::vector<std::array<u8, 3>>{
+                 {0, 101, 0}, {1, 100, 0}, {2, 6, 2}, {3, 101, 0}, {4, 100, 1}, {5, 6, 2},
+                 {6, 96, 1}, {7, 96, 1}, {8, 7, 100}, {9, 123, 0}, {10, 123, 0}, {11, 121, 0},
+                 {12, 7, 100},
+             }) {
+            rpn->controls->emplace_back(time, number, value);
+        }
+        rpn->pitch_bends->emplace_back(0, 512);
+        rpn->pitch_bends->emplace_back(12, 512);
+        actions.tracks->push_back(rpn);
+        const auto replayed = Score<Tick>::parse<DataFormat::MIDI>(
+            dumps<DataFormat::MIDI>(actions, DumpOptions{.compact = true})
+        );
+        REQUIRE(*replayed.tracks->front()->controls == *rpn->controls);
+        REQUIRE(*replayed.tracks->front()->pitch_bends == *rpn->pitch_bends);
+
+        // two drum tracks share channel 10, and the 1st and 16th other tracks share channel 1
+        Score<Tick> shared(96);
+        for (size_t i = 0; i < 18; ++i) {
+            const bool drum  = i >= 16;
+            auto       other = std::make_shared<Track<Tick>>("", drum ? 0 : i % 15, drum);
+            other->notes->emplace_back(0, 96, 60, 80);
+            if (drum || i % 15 == 0) {
+                other->controls->emplace_back(0, 7, 100);
+                other->controls->emplace_back(96, 7, 100);
+                other->pitch_bends->emplace_back(0, 0);
+                other->pitch_bends->emplace_back(96, 0);
+            }
+            shared.tracks->push_back(other);
+        }
+        (*shared.tracks)[15]->program = 3;
+        (*shared.tracks)[15]->controls->front().value    = 50;
+        (*shared.tracks)[15]->pitch_bends->front().value = 100;
+        (*shared.tracks)[17]->program                    = 8;
+        (*shared.tracks)[17]->controls->front().time     = 48;
+        for (const u8 format : {0, 1}) {
+            const auto plain = Score<Tick>::parse<DataFormat::MIDI>(
+                dumps<DataFormat::MIDI>(shared, DumpOptions{.format = format})
+            );
+            const auto packed = Score<Tick>::parse<DataFormat::MIDI>(
+                dumps<DataFormat::MIDI>(shared, DumpOptions{.compact = true, .format = format})
+            );
+            REQUIRE(packed.tracks->size() == plain.tracks->size());
+            for (size_t i = 0; i < plain.tracks->size(); ++i) {
+                const auto& expected = *(*plain.tracks)[i];
+                const auto& actual   = *(*packed.tracks)[i];
+                REQUIRE(actual.program == expected.program);
+                REQUIRE(*actual.notes == *expected.notes);
+                REQUIRE(*actual.controls == *expected.controls);
+                REQUIRE(*actual.pitch_bends == *expected.pitch_bends);
+            }
+        }
+
+        const auto bad_format = [&] {
+            return dumps<DataFormat::MIDI>(score, DumpOptions{.format = 2});
+        };
+        REQUIRE_THROWS_AS(bad_format(), std::invalid_argument);
+    }
+
+    SECTION("File Output Matches the Byte Buffer") {
+        const auto data  = read_file(fs::path("testcases") / "Multitrack_MIDIs" / "Aicha.mid");
+        const auto score = Score<Quarter>::parse<DataFormat::MIDI>(std::span<const uint8_t>(data));
+        const auto expected = dumps<DataFormat::MIDI>(score);
+
+        std::FILE* file = std::tmpfile();
+        REQUIRE(file != nullptr);
+        dump_midi(score, file);
+        std::vector<uint8_t> written(expected.size() + 1);
+        std::rewind(file);
+        written.resize(std::fread(written.data(), 1, written.size(), file));
+        std::fclose(file);
+        REQUIRE(written == std::vector<uint8_t>(expected.begin(), expected.end()));
+    }
+
+    SECTION("Events Are Merged in Time Order") {
+        Score<Tick> score(96);
+        score.tempos->emplace_back(0, 500000);
+        auto track = std::make_shared<Track<Tick>>("", 0, false);
+        // notes out of order and a zero-length note, which sounds before it is released
+        track->notes->emplace_back(96, 96, 62, 80);
+        track->notes->emplace_back(0, 96, 60, 80);
+        track->notes->emplace_back(192, 0, 64, 80);
+        track->notes->emplace_back(0, 96, 65, 80);
+        track->controls->emplace_back(96, 64, 127);
+        score.tracks->push_back(track);
+
+        const std::vector<uint8_t> expected = {
+            'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 1, 0, 1, 0, 96,
+            'M', 'T', 'r', 'k', 0, 0, 0, 50,
+            0x00, 0xFF, 0x51, 0x03, 0x07, 0xA1, 0x20,
+            0x00, 0xC0, 0,
+            0x00, 0x90, 60, 80,
+            0x00, 0x90, 65, 80,
+            0x60, 0xB0, 64, 127,
+            0x00, 0x80, 60, 80,
+            0x00, 0x80, 65, 80,
+            0x00, 0x90, 62, 80,
+            0x60, 0x80, 62, 80,
+            0x00, 0x90, 64, 80,
+            0x00, 0x80, 64, 80,
+            0x00, 0xFF, 0x2F, 0x00,
+        };
+        REQUIRE(score.dumps<DataFormat::MIDI>() == vec<u8>(expected.begin(), expected.end()));
+        // with running status, the second of two consecutive 0x90 and 0x80 bytes is left out
+        const auto packed = dumps<DataFormat::MIDI>(score, DumpOptions{.running_status = true});
+        REQUIRE(packed.size() == expected.size() - 2);
+        REQUIRE(
+            Score<Tick>::parse<DataFormat::MIDI>(packed)
+            == Score<Tick>::parse<DataFormat::MIDI>(std::span<const uint8_t>(expected))
+        );
+    }
+}
+
 #endif // SYMUSIC_TEST_MIDI_IO_HPP
@@ -2,6 +2,7 @@
 #ifndef SYMUSIC_TEST_ZPP_HPP
 #define SYMUSIC_TEST_ZPP_HPP
 
+#include <filesystem>
 #include <span>
 #include <string>
 #include "symusic.h"
@@ -154,6 +155,32 @@ TEST_CASE("Test ZPP Serialization", "[symusic][io][zpp]") {
         REQUIRE(deserialized.time_signatures->size() == score.time_signatures->size());
         REQUIRE(deserialized.time_signatures->at(0).time == score.time_signatures->at(0).time);
     }
+
+    SECTION("Shared Scores Keep The Native Layout") {
+        // Score and Track are encoded from their pyvecs directly, the bytes must stay those of
+        // ScoreNative / TrackNative so previously pickled data still loads
+        const std::filesystem::path dir("testcases/Multitrack_MIDIs");
+        for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+            const auto score = Score<Tick>::parse<DataFormat::MIDI>(read_file(entry.path()));
+            const auto bytes = score.dumps<DataFormat::ZPP>();
+            REQUIRE(bytes == dumps<DataFormat::ZPP>(to_native(score)));
+            REQUIRE(Score<Tick>::parse<DataFormat::ZPP>(bytes) == score);
+
+            const auto second = convert<Second>(score);
+            REQUIRE(second.dumps<DataFormat::ZPP>() == dumps<DataFormat::ZPP>(to_native(second)));
+            REQUIRE(
+                Score<Second>::parse<DataFormat::ZPP>(second.dumps<DataFormat::ZPP>()) == second
+            );
+
+            for (const auto& track : *score.tracks) {
+                const auto track_bytes = track->dumps<DataFormat::ZPP>();
+                REQUIRE(track_bytes == dumps<DataFormat::ZPP>(to_native(*track)));
+                REQUIRE(Track<Tick>::parse<DataFormat::ZPP>(track_bytes) == *track);
+            }
+        }
+        const auto truncated = Score<Tick>(480).dumps<DataFormat::ZPP>();
+        REQUIRE_THROWS(Score<Tick>::parse<DataFormat::ZPP>(std::span(truncated).first(6)));
+    }
 }
 
 #endif // SYMUSIC_TEST_ZPP_HPP
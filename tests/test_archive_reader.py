@@ -0,0 +1,132 @@
+"""Tests for reading MIDI members straight out of archives with ``symusic.archive_reader``."""
+
+from __future__ import annotations
+
+import io
+import tarfile
+import zipfile
+from typing import TYPE_CHECKING
+
+import pytest
+from symusic import Score, archive_reader
+
+from tests.utils import MIDI_PATHS_ALL, MIDI_PATHS_CORRUPTED
+
+if TYPE_CHECKING:
+    from pathlib import Path
+
+MEMBERS = [
+    *((f"midis/{i}/{path.name}", path) for i, path in enumerate(MIDI_PATHS_ALL[:4])),
+    (f"midis/{'x' * 120}/{MIDI_PATHS_ALL[4].name}", MIDI_PATHS_ALL[4]),
+    ("README.txt", None),
+]
+
+
+def _payload(path: Path | None) -> bytes:
+    return b"not a midi file" if path is None else path.read_bytes()
+
+
+def _write_tar(path: Path, mode: str, fmt: int) -> None:
+    with tarfile.open(path, mode, format=fmt) as tar:
+        for name, source in MEMBERS:
+            data = _payload(source)
+            info = tarfile.TarInfo(name)
+            info.size = len(data)
+            tar.addfile(info, io.BytesIO(data))
+
+
+def _write_zip(path: Path, compression: int) -> None:
+    with zipfile.ZipFile(path, "w", compression) as archive:
+        archive.writestr("midis/", "")
+        for name, source in MEMBERS:
+            archive.writestr(name, _payload(source))
+
+
+@pytest.fixture(
+    params=["tar-gnu", "tar-pax", "tar.gz", "zip-stored", "zip-deflate"],
+)
+def archive(request, tmp_path: Path) -> Path:
+    kind = request.param
+    path = tmp_path / f"corpus.{kind}"
+    if kind == "tar-gnu":
+        _write_tar(path, "w", tarfile.GNU_FORMAT)
+    elif kind == "tar-pax":
+        _write_tar(path, "w", tarfile.PAX_FORMAT)
+    elif kind == "tar.gz":
+        _write_tar(path, "w:gz", tarfile.PAX_FORMAT)
+    elif kind == "zip-stored":
+        _write_zip(path, zipfile.ZIP_STORED)
+    else:
+        _write_zip(path, zipfile.ZIP_DEFLATED)
+    return path
+
+
+@pytest.mark.parametrize("ttype", ["tick", "second"])
+def test_archive_reader_matches_file_loading(archive: Path, ttype: str):
+    reader = archive_reader(archive, ttype, num_threads=2, prefetch=2)
+    items = list(reader)
+    expected = [(name, path) for name, path in MEMBERS if path is not None]
+    assert [name for name, _, _ in items] == [name for name, _ in expected]
+    for (_, score, error), (_, path) in zip(items, expected):
+        assert error is None
+        assert score == Score(path, ttype)
+    assert reader.num_consumed == len(expected)
+
+
+def test_archive_reader_reports_member_errors(tmp_path: Path):
+    path = tmp_path / "mixed.zip"
+    with zipfile.ZipFile(path, "w") as archive:
+        archive.writestr("good.mid", MIDI_PATHS_ALL[0].read_bytes())
+        archive.writestr("notes.txt", b"skipped")
+        archive.writestr("bad.MID", b"MThd broken")
+        archive.writestr("corrupted.mid", MIDI_PATHS_CORRUPTED[0].read_bytes())
+
+    items = list(archive_reader(path))
+    assert [name for name, _, _ in items] == ["good.mid", "bad.MID", "corrupted.mid"]
+    assert items[0][1] == Score(MIDI_PATHS_ALL[0])
+    assert items[1][1] is None
+    assert isinstance(items[1][2], str)
+
+    everything = list(archive_reader(path, suffixes=()))
+    assert [name for name, _, _ in everything][1] == "notes.txt"
+    assert everything[1][1] is None
+
+
+def test_archive_reader_bounds_inflated_members(tmp_path: Path):
+    """A deflated member is never inflated past the size its headers declare."""
+    path = tmp_path / "bomb.zip"
+    with zipfile.ZipFile(path, "w", zipfile.ZIP_DEFLATED) as archive:
+        archive.writestr("bomb.mid", bytes(1 << 22))
+    data = bytearray(path.read_bytes())
+    # shrink the uncompressed size in the local header and the central directory
+    for signature, offset in ((b"PK\x03\x04", 22), (b"PK\x01\x02", 24)):
+        pos = data.index(signature) + offset
+        data[pos : pos + 4] = (1000).to_bytes(4, "little")
+    path.write_bytes(bytes(data))
+
+    [(name, score, error)] = list(archive_reader(path))
+    assert name == "bomb.mid"
+    assert score is None
+    assert "larger than declared" in error
+
+
+def test_archive_reader_raises_on_damaged_archive(tmp_path: Path):
+    path = tmp_path / "corpus.tar"
+    _write_tar(path, "w", tarfile.GNU_FORMAT)
+    damaged = tmp_path / "damaged.tar"
+    data = bytearray(path.read_bytes())
+    first_size = len(_payload(MEMBERS[0][1]))
+    data[512 + (first_size + 511) // 512 * 512 + 10] ^= 0xFF  # name of the second header
+    damaged.write_bytes(bytes(data))
+    with pytest.raises(RuntimeError):
+        list(archive_reader(damaged))
+    with pytest.raises(RuntimeError):
+        archive_reader(tmp_path / "missing.zip")
+
+
+def test_archive_reader_can_be_abandoned(archive: Path):
+    reader = archive_reader(archive, num_threads=2, prefetch=1)
+    name, score, _ = next(reader)
+    assert name == MEMBERS[0][0]
+    assert score is not None
+    del reader
@@ -0,0 +1,87 @@
+"""Tests for the native batch I/O helpers in ``symusic.io``."""
+
+from __future__ import annotations
+
+from typing import TYPE_CHECKING
+
+import pytest
+from symusic import Score, dump_many, load_many
+
+from tests.utils import MIDI_PATHS_ALL, MIDI_PATHS_CORRUPTED
+
+if TYPE_CHECKING:
+    from pathlib import Path
+
+
+@pytest.mark.parametrize("ttype", ["tick", "quarter", "second"])
+def test_load_many_matches_single_file_loading(ttype: str):
+    scores, errors = load_many(MIDI_PATHS_ALL, ttype, num_threads=4)
+    assert len(scores) == len(errors) == len(MIDI_PATHS_ALL)
+    for path, score, error in zip(MIDI_PATHS_ALL, scores, errors):
+        assert error is None
+        assert score == Score(path, ttype)
+
+
+def test_load_many_reports_errors_per_file(tmp_path: Path):
+    missing = tmp_path / "missing.mid"
+    paths = [MIDI_PATHS_ALL[0], missing, *MIDI_PATHS_CORRUPTED, MIDI_PATHS_ALL[1]]
+    scores, errors = load_many(paths, num_threads=2)
+
+    assert scores[0] == Score(MIDI_PATHS_ALL[0])
+    assert scores[-1] == Score(MIDI_PATHS_ALL[1])
+    assert scores[1] is None
+    assert isinstance(errors[1], str)
+    for score, error in zip(scores, errors):
+        assert (score is None) == (error is not None)
+
+
+def test_load_many_accepts_strings_and_empty_input():
+    scores, errors = load_many([str(MIDI_PATHS_ALL[0])], "tick", num_threads=0)
+    assert scores[0] == Score(MIDI_PATHS_ALL[0])
+    assert errors == [None]
+    assert load_many([]) == ([], [])
+
+
+def test_load_many_rejects_negative_thread_count():
+    with pytest.raises(ValueError, match="num_threads"):
+        load_many(MIDI_PATHS_ALL[:1], num_threads=-1)
+
+
+@pytest.mark.parametrize("ttype", ["tick", "quarter", "second"])
+def test_dump_many_matches_single_file_dumping(ttype: str, tmp_path: Path):
+    scores = [Score(path, ttype) for path in MIDI_PATHS_ALL]
+    paths = [tmp_path / f"{i}.mid" for i in range(len(scores))]
+    assert dump_many(scores, paths, num_threads=4) == [None] * len(scores)
+    for score, path in zip(scores, paths):
+        assert path.read_bytes() == score.dumps_midi()
+
+
+def test_dump_many_forwards_dump_options(tmp_path: Path):
+    scores = [Score(path) for path in MIDI_PATHS_ALL[:4]]
+    paths = [tmp_path / f"{i}.mid" for i in range(len(scores))]
+    assert dump_many(scores, paths, running_status=True, compact=True, format=0) == [None] * 4
+    for score, path in zip(scores, paths):
+        assert path.read_bytes() == score.dumps_midi(running_status=True, compact=True, format=0)
+
+
+def test_dump_many_reports_errors_per_file(tmp_path: Path):
+    scores = [Score(path) for path in MIDI_PATHS_ALL[:3]]
+    paths = [tmp_path / "a.mid", tmp_path / "missing" / "b.mid", str(tmp_path / "c.mid")]
+    errors = dump_many(scores, paths, num_threads=2)
+    assert errors[0] is None
+    assert isinstance(errors[1], str)
+    assert errors[2] is None
+    assert Score(tmp_path / "c.mid") == Score.from_midi(scores[2].dumps_midi())
+
+
+def test_dump_many_rejects_invalid_arguments(tmp_path: Path):
+    score = Score(MIDI_PATHS_ALL[0])
+    with pytest.raises(ValueError, match="paths"):
+        dump_many([score], [])
+    with pytest.raises(ValueError, match="midi"):
+        dump_many([score], [tmp_path / "a.abc"], format="abc")
+    with pytest.raises(ValueError, match="midi"):
+        dump_many([score], [tmp_path / "a.mid"], format=2)
+    with pytest.raises(ValueError, match="num_threads"):
+        dump_many([score], [tmp_path / "a.mid"], num_threads=-1)
+    assert dump_many([], []) == []
@@ -0,0 +1,49 @@
+"""Tests for the columnar score cache format (``Score.dumps_columnar`` / ``from_columnar``)."""
+
+from __future__ import annotations
+
+from typing import TYPE_CHECKING
+
+import pytest
+from symusic import Score
+
+from tests.utils import MIDI_PATHS_ALL
+
+if TYPE_CHECKING:
+    from pathlib import Path
+
+
+@pytest.mark.parametrize("ttype", ["tick", "quarter", "second"])
+@pytest.mark.parametrize("midi_path", MIDI_PATHS_ALL, ids=lambda p: p.name)
+def test_columnar_round_trip(midi_path: Path, ttype: str) -> None:
+    score = Score(midi_path, ttype=ttype)
+    data = score.dumps_columnar()
+    assert data[:4] == b"SYMC"
+    assert Score.from_columnar(data, ttype=ttype) == score
+
+
+def test_columnar_is_smaller_than_pickle() -> None:
+    score = Score(MIDI_PATHS_ALL[0])
+    assert len(score.dumps_columnar()) < len(score.__getstate__())
+
+
+def test_columnar_converts_time_unit() -> None:
+    score = Score(MIDI_PATHS_ALL[0])
+    data = score.dumps_columnar()
+    assert Score.from_columnar(data, ttype="quarter") == score.to("quarter")
+
+
+def test_columnar_file(tmp_path: Path) -> None:
+    score = Score(MIDI_PATHS_ALL[0], ttype="second")
+    path = tmp_path / "score.symc"
+    score.dump_columnar(path)
+    assert Score.from_file(path, ttype="second") == score
+    assert Score.from_file(path, ttype="second", format="columnar") == score
+
+
+def test_columnar_rejects_damaged_data() -> None:
+    data = Score(MIDI_PATHS_ALL[0]).dumps_columnar()
+    with pytest.raises(RuntimeError, match="Invalid columnar data"):
+        Score.from_columnar(data[: len(data) // 2])
+    with pytest.raises(RuntimeError, match="Unsupported columnar format version"):
+        Score.from_columnar(data[:4] + b"\x09" + data[5:])
@@ -0,0 +1,54 @@
+"""Tests for the read-ahead ``symusic.corpus_reader`` pipeline."""
+
+from __future__ import annotations
+
+from typing import TYPE_CHECKING
+
+import pytest
+from symusic import Score, corpus_reader
+
+from tests.utils import MIDI_PATHS_ALL, MIDI_PATHS_CORRUPTED
+
+if TYPE_CHECKING:
+    from pathlib import Path
+
+
+@pytest.mark.parametrize("ttype", ["tick", "quarter", "second"])
+def test_corpus_reader_matches_single_file_loading(ttype: str):
+    reader = corpus_reader(MIDI_PATHS_ALL, ttype, num_threads=4, io_threads=2, prefetch=3)
+    assert len(reader) == len(MIDI_PATHS_ALL)
+    items = list(reader)
+    assert [path for path, _, _ in items] == list(MIDI_PATHS_ALL)
+    for path, score, error in items:
+        assert error is None
+        assert score == Score(path, ttype)
+    assert reader.num_consumed == len(MIDI_PATHS_ALL)
+
+
+def test_corpus_reader_reports_errors_per_file(tmp_path: Path):
+    missing = tmp_path / "missing.mid"
+    paths = [MIDI_PATHS_ALL[0], missing, *MIDI_PATHS_CORRUPTED, MIDI_PATHS_ALL[1]]
+    items = list(corpus_reader(paths, num_threads=2))
+
+    assert len(items) == len(paths)
+    assert items[0][1] == Score(MIDI_PATHS_ALL[0])
+    assert items[-1][1] == Score(MIDI_PATHS_ALL[1])
+    assert items[1][1] is None
+    assert isinstance(items[1][2], str)
+    for _, score, error in items:
+        assert (score is None) == (error is not None)
+
+
+def test_corpus_reader_can_be_abandoned():
+    reader = corpus_reader(MIDI_PATHS_ALL, num_threads=2, prefetch=2)
+    _, score, _ = next(reader)
+    assert score == Score(MIDI_PATHS_ALL[0])
+    del reader
+    assert list(corpus_reader([])) == []
+
+
+def test_corpus_reader_rejects_negative_arguments():
+    with pytest.raises(ValueError, match="io_threads"):
+        corpus_reader(MIDI_PATHS_ALL[:1], io_threads=-1)
+    with pytest.raises(ValueError, match="prefetch"):
+        corpus_reader(MIDI_PATHS_ALL[:1], prefetch=-1)
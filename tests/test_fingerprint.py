@@ -0,0 +1,46 @@
+"""Tests for the note content fingerprint ``Score.fingerprint()``."""
+
+from __future__ import annotations
+
+from operator import attrgetter
+from typing import TYPE_CHECKING
+
+import pytest
+from symusic import MidiInfo, Note, Score, Track
+
+from tests.utils import MIDI_PATHS_ALL
+
+if TYPE_CHECKING:
+    from pathlib import Path
+
+
+@pytest.mark.parametrize("midi_path", MIDI_PATHS_ALL, ids=attrgetter("name"))
+def test_fingerprint_is_unit_and_resolution_invariant(midi_path: Path):
+    score = Score(midi_path)
+    fingerprint = score.fingerprint()
+
+    assert len(fingerprint) == 32
+    assert MidiInfo.from_file(midi_path).fingerprint == fingerprint
+    assert score.to("quarter").fingerprint() == fingerprint
+    assert Score(midi_path, ttype="second").fingerprint() == fingerprint
+    assert score.resample(score.ticks_per_quarter * 2).fingerprint() == fingerprint
+
+
+def test_fingerprint_only_depends_on_notes():
+    score = Score(480)
+    track = Track("piano", program=0)
+    track.notes.append(Note(0, 480, 60, 100))
+    track.notes.append(Note(480, 240, 64, 90))
+    score.tracks.append(track)
+    fingerprint = score.fingerprint()
+
+    renamed = score.copy()
+    renamed.tracks[0].name = "renamed"
+    assert renamed.fingerprint() == fingerprint
+
+    transposed = score.shift_pitch(1)
+    assert transposed.fingerprint() != fingerprint
+
+    other_program = score.copy()
+    other_program.tracks[0].program = 1
+    assert other_program.fingerprint() != fingerprint
@@ -0,0 +1,41 @@
+"""Tests for lazily decoded scores returned by ``Score.open(path, lazy=True)``."""
+
+from __future__ import annotations
+
+from operator import attrgetter
+from typing import TYPE_CHECKING
+
+import pytest
+from symusic import Score
+
+from tests.utils import MIDI_PATHS_MULTITRACK
+
+if TYPE_CHECKING:
+    from pathlib import Path
+
+
+@pytest.mark.parametrize("midi_path", MIDI_PATHS_MULTITRACK, ids=attrgetter("name"))
+@pytest.mark.parametrize("ttype", ["tick", "quarter", "second"])
+def test_lazy_score_matches_full_parse(midi_path: Path, ttype: str):
+    lazy = Score.open(midi_path, ttype, lazy=True)
+    full = Score.from_file(midi_path, ttype)
+
+    assert lazy.ticks_per_quarter == full.ticks_per_quarter
+    assert lazy.is_decoded(0)
+    assert not any(lazy.is_decoded(i) for i in range(1, len(lazy)))
+
+    last = lazy[-1]
+    assert lazy.is_decoded(len(lazy) - 1)
+    for track in last:
+        assert track in full.tracks
+
+    assert lazy.to_score() == full
+    assert all(lazy.is_decoded(i) for i in range(len(lazy)))
+
+
+def test_lazy_score_index_and_eager_open():
+    path = MIDI_PATHS_MULTITRACK[0]
+    lazy = Score.open(path, lazy=True)
+    with pytest.raises(IndexError):
+        lazy[len(lazy)]
+    assert Score.open(path) == Score.from_file(path)
@@ -6,7 +6,7 @@ import sys
 import pytest
 from symusic import Score
 
-from tests.utils import MIDI_PATHS_ALL, TESTCASES_PATH
+from tests.utils import MIDI_PATHS_ALL, TESTCASES_PATH, build_single_track_midi
 
 ISSUE_104_PATH = (
     TESTCASES_PATH / "MIDIs_corrupted" / "Issue104_Bizarre_Love_Triangle2.mid"
@@ -14,15 +14,6 @@ ISSUE_104_PATH = (
 ABC_FIXTURE_PATH = TESTCASES_PATH / "abc_files" / "a_morning_in_summer.abc"
 
 
-def build_single_track_midi(track_bytes: bytes, tpq: int = 480) -> bytes:
-    header = b"MThd" + (6).to_bytes(4, "big")
-    header += (0).to_bytes(2, "big")
-    header += (1).to_bytes(2, "big")
-    header += tpq.to_bytes(2, "big")
-    track = b"MTrk" + len(track_bytes).to_bytes(4, "big") + track_bytes
-    return header + track
-
-
 def test_malformed_midi_default_load_is_strict():
     with pytest.raises(RuntimeError):
         Score(ISSUE_104_PATH)
@@ -0,0 +1,50 @@
+"""Tests for the metadata-only MIDI scan ``symusic.MidiInfo``."""
+
+from __future__ import annotations
+
+from operator import attrgetter
+from typing import TYPE_CHECKING
+
+import pytest
+from symusic import MidiInfo, Score
+
+from tests.utils import MIDI_PATHS_ALL
+
+if TYPE_CHECKING:
+    from pathlib import Path
+
+
+@pytest.mark.parametrize("midi_path", MIDI_PATHS_ALL, ids=attrgetter("name"))
+def test_scan_matches_full_parse(midi_path: Path):
+    info = MidiInfo.from_file(midi_path)
+    score = Score(midi_path)
+
+    assert info.ticks_per_quarter == score.ticks_per_quarter
+    assert info.num_tracks == len(score.tracks)
+    assert info.note_num == score.note_num()
+    assert info.end_tick == score.end()
+    assert info.tempo_num == len(score.tempos)
+    assert info.time_signature_num == len(score.time_signatures)
+
+    per_program = [0] * 128
+    for track in score.tracks:
+        if not track.is_drum:
+            per_program[track.program] += track.note_num()
+    assert info.notes_per_program == per_program
+    assert info.has_drums == any(t.is_drum and t.note_num() > 0 for t in score.tracks)
+
+    if len(score.tempos) > 0:
+        qpms = [t.qpm for t in score.tempos]
+        assert info.min_qpm == pytest.approx(min(qpms))
+        assert info.max_qpm == pytest.approx(max(qpms))
+    assert info.end_second == pytest.approx(score.to("second").end(), abs=1e-3)
+
+    assert MidiInfo.from_midi(midi_path.read_bytes()) == info
+
+
+def test_scan_rejects_invalid_payload():
+    header = b"MThd\x00\x00\x00\x06\x00\x00\x00\x01\x00\x60"
+    track = b"MTrk\x00\x00\x00\x0c\x00\x90\x3c\xff\x60\x80\x3c\x00\x00\xff\x2f\x00"
+    with pytest.raises(RuntimeError):
+        MidiInfo.from_midi(header + track)
+    assert MidiInfo.from_midi(header + track, sanitize_data=True).note_num == 1
@@ -0,0 +1,77 @@
+"""Tests for the optional MIDI parse settings exposed on ``Score.from_file``/``from_midi``."""
+
+from __future__ import annotations
+
+from operator import attrgetter
+from typing import TYPE_CHECKING
+
+import pytest
+from symusic import Score
+
+from tests.utils import MIDI_PATHS_MULTITRACK
+
+if TYPE_CHECKING:
+    from pathlib import Path
+
+
+@pytest.mark.parametrize("midi_path", MIDI_PATHS_MULTITRACK, ids=attrgetter("name"))
+@pytest.mark.parametrize("ttype", ["tick", "quarter", "second"])
+@pytest.mark.parametrize("num_threads", [0, 2, 8])
+def test_parallel_parse_matches_sequential(midi_path: Path, ttype: str, num_threads: int):
+    """Decoding tracks on several threads must give exactly the sequential result."""
+    sequential = Score.from_file(midi_path, ttype)
+    parallel = Score.from_file(midi_path, ttype, num_threads=num_threads)
+    assert parallel == sequential
+
+    data = midi_path.read_bytes()
+    assert Score.from_midi(data, ttype, num_threads=num_threads) == sequential
+
+
+def test_parallel_parse_raises_on_invalid_data():
+    """Errors raised by a worker thread surface as regular exceptions."""
+    header = b"MThd\x00\x00\x00\x06\x00\x01\x00\x02\x00\x60"
+    good = b"MTrk\x00\x00\x00\x0c\x00\x90\x3c\x40\x60\x80\x3c\x00\x00\xff\x2f\x00"
+    bad = b"MTrk\x00\x00\x00\x0c\x00\x90\x3e\xff\x60\x80\x3e\x00\x00\xff\x2f\x00"
+    with pytest.raises(RuntimeError):
+        Score.from_midi(header + good + bad, num_threads=2)
+
+
+@pytest.mark.parametrize("midi_path", MIDI_PATHS_MULTITRACK, ids=attrgetter("name"))
+@pytest.mark.parametrize("ttype", ["tick", "quarter", "second"])
+def test_keep_notes_matches_full_parse(midi_path: Path, ttype: str):
+    """A notes-only parse yields the non-empty note tracks of a full parse and nothing else."""
+    full = Score.from_file(midi_path, ttype)
+    projected = Score.from_file(midi_path, ttype, keep=["notes"])
+
+    assert len(projected.tempos) == 0
+    assert len(projected.time_signatures) == 0
+    assert len(projected.markers) == 0
+    note_tracks = [t for t in full.tracks if len(t.notes) > 0]
+    assert len(projected.tracks) == len(note_tracks)
+    for kept, track in zip(projected.tracks, note_tracks):
+        assert kept.notes == track.notes
+        assert len(kept.controls) == len(kept.pitch_bends) == len(kept.pedals) == 0
+
+    data = midi_path.read_bytes()
+    assert Score.from_midi(data, ttype, keep=["notes"]) == projected
+
+
+@pytest.mark.parametrize("midi_path", MIDI_PATHS_MULTITRACK[:2], ids=attrgetter("name"))
+def test_keep_all_classes_matches_default(midi_path: Path):
+    keep = [
+        "notes",
+        "controls",
+        "pitch_bends",
+        "pedals",
+        "lyrics",
+        "tempos",
+        "time_signatures",
+        "key_signatures",
+        "markers",
+    ]
+    assert Score.from_file(midi_path, keep=keep) == Score.from_file(midi_path)
+
+
+def test_keep_rejects_unknown_event_class():
+    with pytest.raises(ValueError, match="velocity"):
+        Score.from_file(MIDI_PATHS_MULTITRACK[0], keep=["notes", "velocity"])
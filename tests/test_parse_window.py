@@ -0,0 +1,64 @@
+"""Tests for the time-windowed MIDI parse ``Score.from_file(..., window=(start, end))``."""
+
+from __future__ import annotations
+
+from operator import attrgetter
+from typing import TYPE_CHECKING
+
+import pytest
+from symusic import Score
+
+from tests.utils import MIDI_PATHS_ALL, build_single_track_midi
+
+if TYPE_CHECKING:
+    from pathlib import Path
+
+
+def notes_of(score) -> list[tuple]:
+    return sorted(
+        (track.program, track.is_drum, note.time, note.duration, note.pitch, note.velocity)
+        for track in score.tracks
+        for note in track.notes
+    )
+
+
+@pytest.mark.parametrize("midi_path", MIDI_PATHS_ALL, ids=attrgetter("name"))
+@pytest.mark.parametrize("start_mode", ["remove", "truncate"])
+def test_window_matches_trim(midi_path: Path, start_mode: str):
+    full = Score(midi_path)
+    start, end = 2 * full.ticks_per_quarter, 10 * full.ticks_per_quarter
+    windowed = Score.from_file(midi_path, window=(start, end), start_mode=start_mode)
+    trimmed = full.trim(start, end, start_mode=start_mode)
+
+    assert notes_of(windowed) == notes_of(trimmed)
+    assert windowed.tempos == trimmed.tempos
+    assert windowed.time_signatures == trimmed.time_signatures
+
+
+def test_window_truncates_crossing_notes():
+    # notes at [0, 192), [96, 288) and [192, 384)
+    data = build_single_track_midi(
+        bytes([0x00, 0x90, 60, 100, 0x60, 0x90, 62, 100, 0x60, 0x80, 60, 0])
+        + bytes([0x00, 0x90, 64, 100, 0x60, 0x80, 62, 0, 0x60, 0x80, 64, 0])
+        + bytes([0x00, 0xFF, 0x2F, 0x00]),
+        tpq=96,
+    )
+    assert Score.from_midi(data, window=(96, 240)).note_num() == 0
+
+    score = Score.from_midi(data, window=(96, 240), start_mode="truncate", end_mode="truncate")
+    assert [(n.time, n.duration) for n in score.tracks[0].notes] == [
+        (96, 96),
+        (96, 144),
+        (192, 48),
+    ]
+
+    quarter = Score.from_midi(data, "quarter", window=(1, 2.5), end_mode="truncate")
+    assert [(n.time, n.duration) for n in quarter.tracks[0].notes] == [(1, 1.5), (2, 0.5)]
+
+
+def test_window_rejects_invalid_arguments():
+    data = build_single_track_midi(bytes([0x00, 0xFF, 0x2F, 0x00]))
+    with pytest.raises(ValueError):
+        Score.from_midi(data, window=(10, 5))
+    with pytest.raises(ValueError):
+        Score.from_midi(data, window=(0, 10), end_mode="clip")
@@ -149,3 +149,30 @@ def test_pickle_score_roundtrip(ttype: str):
     assert restored.time_signatures == score.time_signatures
     assert restored.key_signatures == score.key_signatures
     assert restored.markers == score.markers
+
+
+@pytest.mark.parametrize("protocol", range(2, pickle.HIGHEST_PROTOCOL + 1))
+def test_pickle_every_protocol(ttype: str, protocol: int):
+    score = _build_score(ttype)
+    for obj in (score, score.tracks[0], score.tracks[0].notes, score.markers):
+        restored = pickle.loads(pickle.dumps(obj, protocol=protocol))  # noqa: S301
+        assert type(restored) is type(obj)
+        assert restored == obj
+
+
+def test_pickle_out_of_band_buffers(ttype: str):
+    score = _build_score(ttype)
+    for obj in (score, score.tracks[0], score.tracks[0].notes):
+        buffers: list[pickle.PickleBuffer] = []
+        header = pickle.dumps(obj, protocol=5, buffer_callback=buffers.append)
+        # the state travels in the buffer, only the reconstruction recipe is pickled
+        assert len(buffers) == 1
+        assert len(header) < 200
+        assert bytes(buffers[0].raw()) == obj.__getstate__()
+        restored = pickle.loads(header, buffers=buffers)  # noqa: S301
+        assert type(restored) is type(obj)
+        assert restored == obj
+
+        # the receiver may hand the buffers back as any bytes-like object
+        views = [memoryview(bytearray(buffer.raw())) for buffer in buffers]
+        assert pickle.loads(header, buffers=views) == obj  # noqa: S301
@@ -1,11 +1,12 @@
+import zlib
 from operator import attrgetter
 from pathlib import Path
 
 import numpy as np
 import pytest
-from symusic import Score
+from symusic import ControlChange, Note, PitchBend, Score, Track
 
-from tests.utils import MIDI_PATHS_ALL
+from tests.utils import MIDI_PATHS_ALL, MIDI_PATHS_MULTITRACK, TESTCASES_PATH
 
 
 @pytest.mark.parametrize("midi_path", MIDI_PATHS_ALL, ids=attrgetter("name"))
@@ -63,3 +64,81 @@ def test_load_dump(midi_path: Path, tmp_path: Path):
                 print(f"{midi_attr} are not equals")
 
     assert midi_equals
+
+
+GOLDEN_DUMPS = [
+    line.split("\t")
+    for line in (TESTCASES_PATH / "golden_dump_midi.tsv").read_text(encoding="utf-8").splitlines()
+]
+
+
+@pytest.mark.parametrize(
+    ("midi_path", "size", "crc"), GOLDEN_DUMPS, ids=[row[0] for row in GOLDEN_DUMPS]
+)
+def test_dump_matches_golden(midi_path: str, size: str, crc: str):
+    """Default output is byte-identical to the minimidi based writer it replaced."""
+    data = Score(TESTCASES_PATH / midi_path).dumps_midi()
+    assert len(data) == int(size)
+    assert zlib.crc32(data) == int(crc, 16)
+
+
+@pytest.mark.parametrize("midi_path", MIDI_PATHS_ALL, ids=attrgetter("name"))
+def test_running_status(midi_path: Path):
+    """Running status only drops repeated status bytes, the decoded score is the same."""
+    score = Score(midi_path)
+    packed = score.dumps_midi(running_status=True)
+    plain = score.dumps_midi()
+    assert len(packed) <= len(plain)
+    assert Score.from_midi(packed) == Score.from_midi(plain)
+
+
+@pytest.mark.parametrize("midi_path", MIDI_PATHS_MULTITRACK, ids=attrgetter("name"))
+def test_parallel_dump(midi_path: Path):
+    """Encoding track chunks in parallel yields the same bytes as the sequential writer."""
+    score = Score(midi_path)
+    assert score.dumps_midi(num_threads=4) == score.dumps_midi()
+
+
+@pytest.mark.parametrize("midi_path", MIDI_PATHS_ALL, ids=attrgetter("name"))
+def test_compact_dump(midi_path: Path):
+    """Compact and format 0 output keep every note."""
+    score = Score(midi_path)
+    compact = score.dumps_midi(compact=True)
+    assert len(compact) <= len(score.dumps_midi())
+    assert Score.from_midi(compact).note_num() == score.note_num()
+
+    single = score.dumps_midi(compact=True, format=0)
+    assert single[8:12] == b"\x00\x00\x00\x01"
+    assert Score.from_midi(single).note_num() == score.note_num()
+    with pytest.raises(ValueError, match="format"):
+        score.dumps_midi(format=2)
+
+
+def test_compact_dump_keeps_action_controllers():
+    """Compact output only drops repeated values of controllers that hold a state."""
+    score = Score(96)
+    track = Track("", 0, False)
+    track.notes.append(Note(0, 960, 60, 80))
+    controls = [
+        # RPN 0 (pitch bend range) and RPN 1 (fine tuning), both set to the same value
+        *[(0, 101, 0), (1, 100, 0), (2, 6, 2), (3, 38, 0)],
+        *[(4, 101, 0), (5, 100, 1), (6, 6, 2), (7, 38, 0)],
+        *[(8, 96, 1), (9, 96, 1)],
+        # repeated All Notes Off, and a volume set again after Reset All Controllers
+        *[(10, 7, 100), (11, 123, 0), (12, 123, 0), (13, 121, 0), (14, 7, 100)],
+    ]
+    for time, number, value in controls:
+        track.controls.append(ControlChange(time, number, value))
+    bends = [(0, 512), (14, 512)]
+    for time, value in bends:
+        track.pitch_bends.append(PitchBend(time, value))
+    score.tracks.append(track)
+
+    parsed = Score.from_midi(score.dumps_midi(compact=True))
+    assert [(c.time, c.number, c.value) for c in parsed.tracks[0].controls] == controls
+    assert [(p.time, p.value) for p in parsed.tracks[0].pitch_bends] == bends
+
+    # repeated values of state controllers are still dropped
+    score.tracks[0].controls = [ControlChange(0, 7, 100), ControlChange(1, 7, 100)]
+    parsed = Score.from_midi(score.dumps_midi(compact=True))
+    assert len(parsed.tracks[0].controls) == 1
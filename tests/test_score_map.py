@@ -0,0 +1,75 @@
+"""Tests for memory-mapped score map files (``Score.dump_score_map`` / ``open_score_map``)."""
+
+from __future__ import annotations
+
+from typing import TYPE_CHECKING
+
+import numpy as np
+import pytest
+from symusic import Score, TextMeta, open_score_map
+
+from tests.utils import MIDI_PATHS_ALL
+
+if TYPE_CHECKING:
+    from pathlib import Path
+
+
+@pytest.mark.parametrize("ttype", ["tick", "quarter", "second"])
+@pytest.mark.parametrize("midi_path", MIDI_PATHS_ALL[:8], ids=lambda p: p.name)
+def test_score_map_round_trip(tmp_path: Path, midi_path: Path, ttype: str) -> None:
+    score = Score(midi_path, ttype=ttype)
+    path = tmp_path / "score.symm"
+    score.dump_score_map(path)
+    score_map = open_score_map(path, ttype=ttype)
+    assert score_map.ticks_per_quarter == score.ticks_per_quarter
+    assert len(score_map) == len(score.tracks)
+    assert score_map.to_score() == score
+
+
+def test_score_map_views(tmp_path: Path) -> None:
+    score = Score(MIDI_PATHS_ALL[0])
+    path = tmp_path / "score.symm"
+    score.dump_score_map(path)
+    score_map = open_score_map(path)
+
+    for track, track_map in zip(score.tracks, score_map):
+        assert track_map.name == track.name
+        assert track_map.program == track.program
+        assert track_map.is_drum == track.is_drum
+        notes = track_map.notes()
+        for key, column in track.notes.numpy().items():
+            np.testing.assert_array_equal(notes[key], column)
+            assert not notes[key].flags.writeable
+        assert track_map.to_track() == track
+
+    tempos = score_map.tempos()
+    np.testing.assert_array_equal(tempos["mspq"], score.tempos.numpy()["mspq"])
+    assert score_map[-1].to_track() == score.tracks[-1]
+    with pytest.raises(IndexError):
+        score_map[len(score_map)]
+
+
+def test_score_map_views_outlive_the_map(tmp_path: Path) -> None:
+    score = Score(MIDI_PATHS_ALL[0])
+    path = tmp_path / "score.symm"
+    score.dump_score_map(path)
+    pitches = open_score_map(path)[0].notes()["pitch"]
+    np.testing.assert_array_equal(pitches, score.tracks[0].notes.numpy()["pitch"])
+
+
+def test_score_map_text_events(tmp_path: Path) -> None:
+    score = Score(MIDI_PATHS_ALL[0])
+    score.markers.append(TextMeta(0, "intro"))
+    score.tracks[0].lyrics.append(TextMeta(0, "la"))
+    path = tmp_path / "score.symm"
+    score.dump_score_map(path)
+    score_map = open_score_map(path)
+    assert score_map.markers()[-1] == (0, "intro")
+    assert score_map[0].lyrics()[-1] == (0, "la")
+
+
+def test_score_map_rejects_other_units(tmp_path: Path) -> None:
+    path = tmp_path / "score.symm"
+    Score(MIDI_PATHS_ALL[0], ttype="second").dump_score_map(path)
+    with pytest.raises(RuntimeError, match="stores Second times"):
+        open_score_map(path, ttype="tick")
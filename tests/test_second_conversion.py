@@ -185,3 +185,12 @@ def test_issue90_first_notes_have_expected_relative_durations():
         f"Duration ratio of first two vs next three notes is {ratio:.2f}; "
         f"expected ~2.0 (durations: {dur})"
     )
+
+
+@pytest.mark.parametrize(
+    "midi_path", [*MIDI_PATHS_ALL, ISSUE_90_MIDI], ids=attrgetter("name")
+)
+def test_direct_second_parse_is_identical_to_conversion(midi_path: Path):
+    """The single-pass second parser must reproduce ``to("second")`` exactly."""
+    direct = Score(midi_path, ttype="second")
+    assert direct == Score(midi_path, ttype="tick").to("second")
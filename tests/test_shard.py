@@ -0,0 +1,80 @@
+"""Tests for score shard files (``shard_writer`` / ``shard_reader``)."""
+
+from __future__ import annotations
+
+from typing import TYPE_CHECKING
+
+import pytest
+from symusic import Score, shard_reader, shard_writer
+
+from tests.utils import MIDI_PATHS_ALL
+
+if TYPE_CHECKING:
+    from pathlib import Path
+
+PATHS = MIDI_PATHS_ALL[:16]
+
+
+@pytest.fixture
+def shard_path(tmp_path: Path) -> Path:
+    path = tmp_path / "scores.syms"
+    with shard_writer(path) as writer:
+        for midi_path in PATHS:
+            writer.add(midi_path.name, Score(midi_path))
+        assert len(writer) == len(PATHS)
+    return path
+
+
+def test_shard_random_access(shard_path: Path) -> None:
+    reader = shard_reader(shard_path)
+    assert len(reader) == len(PATHS)
+    for i, midi_path in reversed(list(enumerate(PATHS))):
+        score = Score(midi_path)
+        entry = reader.entry(i)
+        assert entry.key == midi_path.name
+        assert entry.note_count == score.note_num()
+        assert entry.duration == score.end()
+        assert midi_path.name in reader
+        assert reader.index(midi_path.name) == i
+        assert reader[i] == score
+        assert reader[midi_path.name] == score
+    assert reader[-1] == Score(PATHS[-1])
+    assert [entry.key for entry in reader.entries] == [p.name for p in PATHS]
+    with pytest.raises(IndexError):
+        reader[len(PATHS)]
+    with pytest.raises(KeyError):
+        reader["missing"]
+
+
+def test_shard_load_many(shard_path: Path) -> None:
+    reader = shard_reader(shard_path)
+    scores, errors = reader.load_many(num_threads=4)
+    assert errors == [None] * len(PATHS)
+    assert scores == [Score(p) for p in PATHS]
+
+    scores, errors = reader.load_many([1, len(PATHS)])
+    assert scores[0] == Score(PATHS[1])
+    assert scores[1] is None
+    assert errors[1] is not None
+
+
+def test_shard_converts_time_unit(shard_path: Path) -> None:
+    reader = shard_reader(shard_path, ttype="quarter")
+    assert reader[0] == Score(PATHS[0]).to("quarter")
+
+
+def test_shard_rejects_duplicate_keys(tmp_path: Path) -> None:
+    score = Score(PATHS[0])
+    with shard_writer(tmp_path / "dup.syms") as writer:
+        writer.add("a", score)
+        with pytest.raises(ValueError, match="Duplicate shard key"):
+            writer.add("a", score)
+
+
+def test_shard_requires_index(tmp_path: Path) -> None:
+    path = tmp_path / "truncated.syms"
+    with shard_writer(path) as writer:
+        writer.add("a", Score(PATHS[0]))
+    path.write_bytes(path.read_bytes()[:-1])
+    with pytest.raises(RuntimeError, match="Invalid score shard"):
+        shard_reader(path)
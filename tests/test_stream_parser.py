@@ -0,0 +1,51 @@
+"""Tests for the incremental MIDI parser returned by ``symusic.stream_parser``."""
+
+from __future__ import annotations
+
+from operator import attrgetter
+from typing import TYPE_CHECKING
+
+import pytest
+from symusic import Score, stream_parser
+
+from tests.utils import MIDI_PATHS_ALL
+
+if TYPE_CHECKING:
+    from pathlib import Path
+
+
+@pytest.mark.parametrize("midi_path", MIDI_PATHS_ALL, ids=attrgetter("name"))
+@pytest.mark.parametrize("ttype", ["tick", "quarter", "second"])
+def test_stream_parser_matches_full_parse(midi_path: Path, ttype: str):
+    data = midi_path.read_bytes()
+    parser = stream_parser(ttype)
+    emitted = []
+    for begin in range(0, len(data), 100):
+        emitted.extend(parser.feed(data[begin : begin + 100]))
+
+    score = parser.finish()
+    assert score == Score.from_midi(data, ttype)
+    assert list(score.tracks) == emitted
+
+
+def test_stream_parser_rejects_truncated_input():
+    data = MIDI_PATHS_ALL[0].read_bytes()
+    parser = stream_parser(keep=["notes"])
+    parser.feed(data[:-1])
+    with pytest.raises(RuntimeError):
+        parser.finish()
+    with pytest.raises(ValueError, match="keep"):
+        stream_parser(keep=["chords"])
+
+
+@pytest.mark.parametrize("cut", [0, 1, 7], ids=["boundary", "type", "size"])
+@pytest.mark.parametrize("ttype", ["tick", "second"])
+def test_stream_parser_rejects_missing_chunk(cut: int, ttype: str):
+    """Input that ends before the last declared chunk is rejected, wherever it is cut."""
+    header = b"MThd\x00\x00\x00\x06\x00\x01\x00\x02\x00\x60"
+    chunk = b"MTrk\x00\x00\x00\x04\x00\xff\x2f\x00"
+    parser = stream_parser(ttype)
+    parser.feed(header + chunk + chunk[:cut])
+    assert parser.num_decoded == 1
+    with pytest.raises(RuntimeError, match="1 of 2 chunks"):
+        parser.finish()
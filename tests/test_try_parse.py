@@ -0,0 +1,53 @@
+"""Tests for the non-raising ``Score.try_from_file`` / ``Score.try_from_midi`` loaders."""
+
+from __future__ import annotations
+
+from typing import TYPE_CHECKING
+
+import pytest
+from symusic import Score
+
+from tests.utils import MIDI_PATHS_ALL, MIDI_PATHS_CORRUPTED, build_single_track_midi
+
+if TYPE_CHECKING:
+    from pathlib import Path
+
+
+@pytest.mark.parametrize("ttype", ["tick", "quarter", "second"])
+def test_try_from_file_matches_from_file(ttype: str):
+    for path in MIDI_PATHS_ALL[:4]:
+        score, error = Score.try_from_file(path, ttype)
+        assert error is None
+        assert score == Score.from_file(path, ttype)
+
+
+def test_try_from_file_reports_corrupted_files():
+    for path in MIDI_PATHS_CORRUPTED:
+        with pytest.raises(RuntimeError):
+            Score.from_file(path)
+        score, error = Score.try_from_file(path)
+        assert score is None
+        assert error.code != "none"
+        assert error.message
+
+
+def test_try_from_midi_locates_bad_data_byte():
+    track = bytes([0x00, 0x90, 60, 64, 0x10, 0x80, 60, 0])
+    track += bytes([0x00, 0x90, 200, 64, 0x10, 0x80, 62, 0, 0x00, 0xFF, 0x2F, 0x00])
+    data = build_single_track_midi(track)
+
+    score, error = Score.try_from_midi(data)
+    assert score is None
+    assert error.code == "invalid_data_byte"
+    assert error.offset == 22 + 10
+    assert error.track == 0
+
+    partial, _ = Score.try_from_midi(data, partial=True)
+    assert partial.note_num() == 1
+    assert Score.try_from_midi(data, sanitize_data=True)[1] is None
+
+
+def test_try_from_file_reports_missing_file(tmp_path: Path):
+    score, error = Score.try_from_file(tmp_path / "missing.mid")
+    assert score is None
+    assert error.code == "io_error"
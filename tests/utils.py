@@ -23,6 +23,16 @@ print(TESTCASES_PATH)
 print(MIDI_PATHS_ONE_TRACK)
 
 
+def build_single_track_midi(track_bytes: bytes, tpq: int = 480) -> bytes:
+    """Wrap raw MTrk event bytes into a format 0 MIDI file with a single track."""
+    header = b"MThd" + (6).to_bytes(4, "big")
+    header += (0).to_bytes(2, "big")
+    header += (1).to_bytes(2, "big")
+    header += tpq.to_bytes(2, "big")
+    track = b"MTrk" + len(track_bytes).to_bytes(4, "big") + track_bytes
+    return header + track
+
+
 def merge_tracks(
     tracks: list[Track] | TrackTickList | Score,
     effects: bool = True,